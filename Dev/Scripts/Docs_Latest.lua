@@ -2991,6 +2991,13 @@ end
 function TTE_MountArchive(locationID, physPath)
 end
 
+--- This function is only available to mod scripts! Sets the directory on your local machine where the file tables of mounted .ttarch2/ttarch archives are cached. Mounting the same unchanged archive
+--- again then skips reading its header. Pass nil or an empty string to disable the cache. Call this before mounting.
+--- @param directory nil
+--- @return nil
+function TTE_SetArchiveIndexCache(directory)
+end
+
 --- This function is only available to mod scripts! Mounts the resource system (like creating a concrete directory location) to the given physical path under the name locationID. Location ID should
 --- be in the format <XXX>/. Physical path can be absolute or relative to your working directory. The last argument can be set to true to use the old telltale engine
 --- resource system which had no resource set descriptions. This means that it will recurse all directories and add them all. Set this to true to just easily get all resources
@@ -3072,6 +3079,30 @@ end
 function TTE_ContainerToTable(container, table)
 end
 
+--- Finds the zero based index of the given key in a keyed container (eg Map or Set), or nil if it is not present. The key can be a meta
+--- instance of the key type or a lua value which can be coerced to it. Lookups use a hash index of the keys.
+--- @param container nil
+--- @param key nil
+--- @return int
+function TTE_ContainerFind(container, key)
+end
+
+--- Returns true if the given key exists in the keyed container. See TTE_ContainerFind.
+--- @param container nil
+--- @param key nil
+--- @return bool
+function TTE_ContainerContains(container, key)
+end
+
+--- Sets the value of the given key in the keyed container, adding the key if it does not exist yet. Returns the zero based index of the element. Meta instance
+--- arguments are copied, lua values are coerced to the key and value types.
+--- @param container nil
+--- @param key nil
+--- @param value nil
+--- @return int
+function TTE_ContainerInsertOrAssign(container, key, value)
+end
+
 --- Dumps to the logger all memory which has not been freed yet. This will contain a lot of script stuff which won't matter as the script engine requires memory which
 --- s tracked, however can be useful for tracking specific script object allocations.
 --- @return nil
@@ -4024,6 +4055,13 @@ end
 function CommonMeshSetLODBounds(state, boundingBoxInst, --[[optional]] boundingSphereInst)
 end
 
+--- Set the minimum projected screen size, as a fraction of the screen height, the current LOD is drawn at. By default LOD 0 is drawn above 0.25, halving for each further LOD.
+--- @param state nil
+--- @param screenSize nil
+--- @return nil
+function CommonMeshSetLODScreenSize(state, screenSize)
+end
+
 --- Push a mesh batch. Specify if its a shadow batch.
 --- @param state nil
 --- @param isShadowBatch nil
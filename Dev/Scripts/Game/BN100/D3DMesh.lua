@@ -85,6 +85,7 @@ function RegisterBoneD3DMesh(platform, vendor, bb, hTexture, arrayDCInt, MetaCol
 
     local indexBuffer = NewClass("class D3DIndexBuffer", 0)
     indexBuffer.Serialiser = "SerialiseD3DIndexBuffer0"
+    indexBuffer.NativeSerialiser = "SerialiseD3DIndexBuffer0"
     indexBuffer.Members[1] = NewMember("mbLocked", kMetaBool)
     indexBuffer.Members[2] = NewMember("mFormat", kMetaInt) -- 101 for U16, else U32
     indexBuffer.Members[3] = NewMember("mNumIndicies", kMetaInt) -- spelling mate [DONT FIX! needs to be like this for hash]
@@ -26,6 +26,7 @@ function RegisterCompressedVecAndQuats0()
     local quatKeys = NewClass("class CompressedQuaternionKeys", 0)
     quatKeys.Flags = kMetaClassIntrinsic -- not in headers
     quatKeys.Serialiser = "SerialiseCQKeys0"
+    quatKeys.NativeSerialiser = "SerialiseCQKeys0"
     quatKeys.Members[1] = NewMember("_mName", kMetaClassString, kMetaMemberSerialiseDisable + kMetaMemberVersionDisable)
     quatKeys.Members[2] = NewMember("_mBuffer", kMetaClassInternalBinaryBuffer,
         kMetaMemberSerialiseDisable + kMetaMemberVersionDisable) -- nSamples = size / 6
@@ -37,6 +38,7 @@ function RegisterCompressedVecAndQuats0()
     local vecKeys = NewClass("class CompressedVector3Keys", 0)
     vecKeys.Flags = kMetaClassIntrinsic -- not in headers
     vecKeys.Serialiser = "SerialiseCVKeys0"
+    vecKeys.NativeSerialiser = "SerialiseCVKeys0"
     vecKeys.Members[1] = NewMember("_mName", kMetaClassString, kMetaMemberSerialiseDisable + kMetaMemberVersionDisable)
     vecKeys.Members[2] = NewMember("_mBuffer", kMetaClassInternalBinaryBuffer,
         kMetaMemberSerialiseDisable + kMetaMemberVersionDisable) -- nSamples = size / 6
@@ -6,6 +6,7 @@ function RegisterTXD3DMesh(vendor, hTexture)
 
     local indexBuffer = NewClass("class D3DIndexBuffer", 0)
     indexBuffer.Serialiser = "SerialiseD3DIndexBuffer0"
+    indexBuffer.NativeSerialiser = "SerialiseD3DIndexBuffer0"
     indexBuffer.Members[1] = NewMember("mbLocked", kMetaBool)
     indexBuffer.Members[2] = NewMember("mFormat", kMetaInt)      -- 101 for U16, else U32 [??]
     indexBuffer.Members[3] = NewMember("mNumIndicies", kMetaInt)
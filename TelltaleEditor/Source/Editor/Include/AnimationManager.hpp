@@ -216,11 +216,11 @@ private:
     
     void _UpdateNode(SklNode& node, const Transform& value, const Transform& additiveValue, Float vecContrib, Float quatContrib, Bool bAdditive);
     
-    void _ApplySkeletonInstanceRestPose(Scene* pScene, Ptr<Node>& rootNode, I32 nodeIndex);
+    void _BuildBoneOrder();
     
-    void _ComputeSkeletonInstancePoseMatrices(Ptr<Node> node);
+    void _ApplySkeletonInstanceRestPose();
     
-    Transform _ComputeGlobalRestTransform(const Ptr<Node>& node);
+    void _ComputeSkeletonInstancePoseMatrices();
     
     void _UpdateSkeletonCachedRestPoses();
     
@@ -230,6 +230,10 @@ private:
     Ptr<Node> _RootNode;
     std::vector<SklNode> _Nodes; // flat. CANNOT BE UPDATED UNLESS IN BUILD.
     std::vector<RuntimeSklNode> _RuntimeNodes;
+    std::vector<U32> _BoneOrder; // indices into _Nodes sorted such that parents come before their children
+    std::vector<I32> _BoneParents; // parent index into _Nodes for each node, -1 if attached to the root node
+    std::vector<I32> _BoneOrderParents; // parent of each bone in _BoneOrder as a position in _BoneOrder, -1 if attached to the root node
+    std::vector<SkeletonPose::Group> _BoneLocalPose, _BoneModelPose; // scratch, local and skeleton root relative transforms of the current pose, in _BoneOrder
     U64 _LastUpdatedFrame = UINT64_MAX;
     Matrix4* _CurrentPose = nullptr; // current frame pose final transforms for each bone
     
@@ -281,6 +281,28 @@ struct PerformMix<Transform> : PerformMixBase<Transform>
     
 };
 
+// Whole skeleton poses, per bone weights. Delegates to the SoA pose kernels, which match PerformMix<Transform> on each bone.
+template<>
+struct PerformMix<SkeletonPose>
+{
+    
+    static inline void Finalise(SkeletonPose& value, U32 numBones)
+    {
+        SkeletonPose::Normalise(value, numBones);
+    }
+    
+    static inline void Blend(SkeletonPose& start, const SkeletonPose& end, const Float* t, U32 numBones)
+    {
+        SkeletonPose::Blend(start, end, t, numBones);
+    }
+    
+    static inline void BlendAdditive(SkeletonPose& cur, const SkeletonPose& adding, const Float* mix, U32 numBones)
+    {
+        SkeletonPose::BlendAdditive(cur, adding, mix, numBones);
+    }
+    
+};
+
 // UTIL
 
 inline const AnimationValueTypeDesc& GetAnimationTypeDesc(AnimationValueType type)
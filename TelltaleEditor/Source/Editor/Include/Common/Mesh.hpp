@@ -74,6 +74,8 @@ struct Mesh : HandleLockOwner
         
         U32 VertexStateIndex = 0; // index into MeshInstance::VertexState
         
+        Float ScreenSize = 0.0f; // minimum projected screen size (fraction of screen height) this LOD is drawn at. 0 uses the default for its index.
+        
         std::vector<MeshBatch> Batches[RenderViewType::NUM]; // batches for default and shadow
         
     };
@@ -129,11 +131,22 @@ struct Mesh : HandleLockOwner
     // creates bounding box for sphere
     static Sphere CreateSphereForBox(BoundingBox bb);
     
+    // default screen size of LOD 0 when the mesh does not specify one. each further LOD halves it, the last LOD is drawn at any size.
+    static constexpr Float DefaultLODScreenSize = 0.25f;
+    
+    // gets the minimum projected screen size the given LOD is drawn at (see Camera::GetProjectedScreenSize)
+    static Float GetLODScreenSize(const MeshInstance& mesh, U32 lod);
+    
+    // selects the LOD to draw for the projected screen size. previous LOD is the one selected last time or -1, hysteresis is the fraction the
+    // screen size must pass its thresholds by before switching away from it. force LOD (clamped) overrides the selection if not -1.
+    static U32 SelectLOD(const MeshInstance& mesh, Float screenSize, I32 previousLOD, Float hysteresis, I32 forceLOD = -1);
+    
     
     
     // adds a mesh instance, which should have been previously normalised into.
     void AddMesh(Ptr<ResourceRegistry>& registry, Handle<Mesh::MeshInstance> handle);
     
     std::vector<Ptr<MeshInstance>> MeshList; // list of meshes
+    std::vector<I32> SelectedLODs; // LOD of each mesh drawn last frame, for hysteresis. maintained by the renderer
     
 };
@@ -3,6 +3,7 @@
 #include <Core/Config.hpp>
 #include <Core/Context.hpp>
 #include <Core/BitSet.hpp>
+#include <Core/AABBTree.hpp>
 #include <Meta/Meta.hpp>
 
 #include <Resource/ResourceRegistry.hpp>
@@ -11,6 +12,7 @@
 #include <Common/InputMapper.hpp>
 #include <Common/Mesh.hpp>
 #include <Common/Skeleton.hpp>
+#include <Common/TransformHierarchy.hpp>
 
 #include <Symbols.hpp>
 
@@ -151,6 +153,7 @@ enum class NodeFlags
 {
     NODE_GLOBAL_TRANSFORM_VALID = 1, // node transform is valid
     NODE_ENVIRONMENT_TILE = 2, // is a static environment tile which cannot be transformed (moved)
+    NODE_RENDER_BOUNDS_DIRTY = 4, // its render bounds proxy is queued for a refit in the scene
 };
 
 enum class NodeListenerFlags
@@ -202,6 +205,11 @@ struct Node : ObjOwner
     Ptr<NodeListener> Listeners; // listeners
     
     Scene* AttachedScene = nullptr; // scene belongs to
+    
+    I32 RenderBoundsProxy = AABBTree::Null; // proxy in the scene render bounds tree, for agent nodes with renderables
+    
+    Scene* TransformOwner = nullptr; // scene whose flat transform store this node is in, if any
+    I32 TransformIndex = -1; // index in the flat transform store
 
     Node() = default;
     ~Node();
@@ -420,6 +428,39 @@ public:
     // Does not PLAY it! You must call Play on the returned controller.
     Ptr<PlaybackController> PlayAnimation(const Symbol& agent, Ptr<Animation> pAnim);
     
+    // ===== RENDER BOUNDS. World bounds of renderable agents are kept in a BVH, refitted only for nodes whose transforms changed.
+    
+    // Marks the render bounds to be fully rebuilt. Call when renderables or their mesh lists change.
+    inline void InvalidateRenderBounds()
+    {
+        _RenderBoundsRebuild = true;
+    }
+    
+    // Rebuilds or refits the render bounds as needed. Queries call this, call it yourself if you need the tree up to date earlier.
+    void UpdateRenderBounds();
+    
+    // Appends renderable agents whose (conservative) world bounds overlap the box
+    void QueryRenderables(const BoundingBox& box, std::vector<SceneAgent*>& outAgents);
+    
+    // Appends renderable agents whose (conservative) world bounds are not fully outside the camera view frustum
+    void QueryRenderables(Camera& cam, std::vector<SceneAgent*>& outAgents);
+    
+    // Appends renderable agents whose (conservative) world bounds the ray hits, within maxT along the direction
+    void QueryRenderables(const Vector3& origin, const Vector3& direction, Float maxT, std::vector<SceneAgent*>& outAgents);
+    
+    // ===== FLAT TRANSFORMS. Optionally all nodes in the scene are kept parent first in a flat store. Invalidations then mark ranges dirty
+    // instead of recursing through children, and world transforms are recomputed in one linear pass, so GetNodeWorldTransform is a read.
+    
+    // Enables or disables the flat transform store. Off by default.
+    void SetFlatTransforms(Bool bOnOff);
+    
+    // Rebuilds the flat transform store after attachment changes and recomputes dirty world transforms. Call once per frame. If parallel,
+    // large updates are split between job threads. Does nothing if flat transforms are disabled.
+    void UpdateTransforms(Bool bParallel = true);
+    
+    // Gets the view frustum of the camera in world space, planes facing inwards. Depth range is conservative so it works with any depth convention.
+    static Frustum GetCullingFrustum(Camera& cam);
+    
 private:
     
     // ==== RENDER CONTEXT USE ONLY. THESE FUNCTIONS ARE DEFINED IN RENDERSCENE.CPP, SEPARATE TO REST DEFINED IN COMMON/SCENE.CPP
@@ -454,6 +495,23 @@ private:
     
     static void _InvalidateNode(Ptr<Node>, Node* pTile, Bool bAllowStaticUpdate); // mark as invalid so needing new transform calculation
     
+    static void _OnNodeInvalidated(Node* pNode); // clears the valid flag and notifies listeners and render bounds
+    
+    inline Bool _FlatTransformsActive() const // store is enabled and not waiting for a rebuild
+    {
+        return _FlatTransforms && !_TransformsRebuild;
+    }
+    
+    void _InvalidateFlatNode(Node* pNode, Bool bAllowStaticUpdate); // _InvalidateNode for flat transform nodes
+    
+    static void _InvalidateNodeStructure(Node* pNode); // node attachments changed, rebuild its flat transform store
+    
+    void _RebuildTransforms();
+    
+    void _ResetTransforms(); // removes all nodes from the flat transform store
+    
+    BoundingBox _CalculateRenderBounds(const SceneAgent& agent); // world bounds of all meshes of the agent renderable. Invalid (min > max) if none
+    
     // pub Node API. Private in scene class as only allowed in update async, eg script updates
     
     static void AddNodeListener(Ptr<Node> node, Ptr<NodeListener> pListener); // add a listener. only pointer nodes!
@@ -490,8 +548,22 @@ private:
 
     SceneModuleContainer _Modules;
     
+    // ==== RENDER BOUNDS
+    
+    AABBTree _RenderBounds; // user data is the SceneAgent
+    std::vector<I32> _DirtyRenderBounds; // proxies to refit
+    Bool _RenderBoundsRebuild = true;
+    
+    // ==== FLAT TRANSFORMS
+    
+    TransformHierarchy _Transforms;
+    std::vector<Node*> _TransformNodes; // node of each entry. null if destroyed since the last rebuild
+    Bool _FlatTransforms = false;
+    Bool _TransformsRebuild = true;
+    
     friend class SceneRuntime;
     friend struct SceneAgent;
+    friend struct Node;
     friend class NodeListener;
     friend class AnimationManager;
     friend class SkeletonInstance;
@@ -72,175 +72,76 @@ private:
     
 };
 
-struct SkeletonPose
-{
-    Transform* Entries;
-};
+// Number of bones in each group of a skeleton pose. One AVX register, SSE processes a group as two halves.
+#define SKELETON_POSE_LANES 8
 
-// ACTUAL ENGINE IMPL STUFF FOR FUTURE: (using SoA, will split and need extra code). might make a cpp for this eventually
-//  future use if we want to separate like actual engine skeleton pose calculation with SIMD intrinsics to batch groups of 4.
-// would replace ComputedValueSkeletonPose type.
-
-/*
+// Skeleton pose, one transform per bone, stored as structure of arrays. Bones are in groups of SKELETON_POSE_LANES, and each group
+// stores each component of its bones contiguously, so the kernels below process a component of a whole group at once with SSE/AVX.
+// The kernels work on per bone weights and give the same result as PerformMix<Transform> on each bone. Padding lanes of the last group
+// are kept as identity. Memory is owned by whoever allocates the groups (see ComputedValue<SkeletonPose>).
 struct SkeletonPose
 {
     
-    struct Entry
+    struct alignas(32) Group
     {
-        Float v[4]{0.0f, 0.0f, 0.0f, 0.0f};
+        Float TransX[SKELETON_POSE_LANES];
+        Float TransY[SKELETON_POSE_LANES];
+        Float TransZ[SKELETON_POSE_LANES];
+        Float RotX[SKELETON_POSE_LANES];
+        Float RotY[SKELETON_POSE_LANES];
+        Float RotZ[SKELETON_POSE_LANES];
+        Float RotW[SKELETON_POSE_LANES];
     };
     
-    Entry* Entries; // SoA layout, 7 Vector4s per group of 4 bones
+    Group* Groups = nullptr;
     
-    SkeletonPose() : Entries(nullptr) {}
+    static inline U32 GetNumGroups(U32 numBones)
+    {
+        return (numBones + SKELETON_POSE_LANES - 1) / SKELETON_POSE_LANES;
+    }
     
-    // Set the transform of a single bone at index i
-    inline void SetTransform(U32 i, const Transform& src)
+    inline void SetTransform(U32 bone, const Transform& src)
     {
-        U32 lane = i & 3;             // which of the 4 lanes in a SIMD register
-        U32 groupIndex = i / 4;       // which group of 4 bones
-        U32 baseIndex = 7 * groupIndex;
-        
-        Entries[baseIndex + 0].v[lane] = src._Trans.x;
-        Entries[baseIndex + 1].v[lane] = src._Trans.y;
-        Entries[baseIndex + 2].v[lane] = src._Trans.z;
-        Entries[baseIndex + 3].v[lane] = src._Rot.x;
-        Entries[baseIndex + 4].v[lane] = src._Rot.y;
-        Entries[baseIndex + 5].v[lane] = src._Rot.z;
-        Entries[baseIndex + 6].v[lane] = src._Rot.w;
+        Group& group = Groups[bone / SKELETON_POSE_LANES];
+        U32 lane = bone % SKELETON_POSE_LANES;
+        group.TransX[lane] = src._Trans.x;
+        group.TransY[lane] = src._Trans.y;
+        group.TransZ[lane] = src._Trans.z;
+        group.RotX[lane] = src._Rot.x;
+        group.RotY[lane] = src._Rot.y;
+        group.RotZ[lane] = src._Rot.z;
+        group.RotW[lane] = src._Rot.w;
     }
     
-    // Get the transform of a single bone at index i
-    inline Transform GetTransform(U32 i) const
+    inline Transform GetTransform(U32 bone) const
     {
-        Transform out{};
-        U32 lane = i & 3;
-        U32 groupIndex = i / 4;
-        U32 baseIndex = 7 * groupIndex;
-        
-        out._Trans.x = Entries[baseIndex + 0].v[lane];
-        out._Trans.y = Entries[baseIndex + 1].v[lane];
-        out._Trans.z = Entries[baseIndex + 2].v[lane];
-        out._Rot.x   = Entries[baseIndex + 3].v[lane];
-        out._Rot.y   = Entries[baseIndex + 4].v[lane];
-        out._Rot.z   = Entries[baseIndex + 5].v[lane];
-        out._Rot.w   = Entries[baseIndex + 6].v[lane];
-        
-        return out;
+        const Group& group = Groups[bone / SKELETON_POSE_LANES];
+        U32 lane = bone % SKELETON_POSE_LANES;
+        return Transform(Quaternion(group.RotX[lane], group.RotY[lane], group.RotZ[lane], group.RotW[lane]),
+                         Vector3(group.TransX[lane], group.TransY[lane], group.TransZ[lane]));
     }
-};
-
-*/
-
-
-/*
- enum class SkeletonPoseContributionState
- {
- ALL_ZERO,
- ALL_ONE,
- DEFAULT,
- };
- 
- // Specialised template for above
- template<>
- struct ComputedValue<SkeletonPose>
- {
- 
- SkeletonPose Value, AdditiveValue;
- const Float* InputContribution = nullptr;
- Float *Contribution = nullptr, *AdditiveMix = nullptr; // for each bone
- Ptr<Skeleton> Skl;
- U32 NumBones = 0;
- SkeletonPoseContributionState ContribState = SkeletonPoseContributionState::ALL_ZERO;
- SkeletonPoseContributionState AdditiveContribState = SkeletonPoseContributionState::ALL_ZERO;
- 
- void AllocateFromFastBuffer(Memory::FastBufferAllocator& fastBufferAllocator, Bool bWithAdditive);
- 
- // Specialisation for skeleton pose
- template<>
- struct AnimationMixerAccumulater<SkeletonPose>
- {
- 
- static void AccumulateCurrent(const ComputedValue<SkeletonPose>* pCurrentValues, U32 numCurrentValues,
- ComputedValue<SkeletonPose>& finalValue, Ptr<Skeleton>& pSkeleton,
- U32 numBones, const Float* Contribution, Memory::FastBufferAllocator& outer);
- 
- static void AccumulateFinal(const ComputedValue<SkeletonPose>* finalPriorityValues, U32 numFinalValues,
- ComputedValue<SkeletonPose>& outValue, Ptr<Skeleton>& pSkeleton, U32 numBones);
- 
- };
- 
- 
- void ComputedValue<SkeletonPose>::AllocateFromFastBuffer(Memory::FastBufferAllocator &fastBufferAllocator, Bool bWithAdditive)
- {
- U32 size = (7 * sizeof(Float) * NumBones) // SoA: 4 for rotation (xywz) and 3 for translation (xyz) + (NumBones * 4); // skeletonpose entries value + contrib
-if(bWithAdditive)
-size *= 2; // additive float buf and additive value entries
-U8* memory = fastBufferAllocator.Alloc(size, 16); // try allow simd :(
-// .... SIMD
-}
-
-void
-AnimationMixerAccumulater<SkeletonPose>::AccumulateCurrent(const ComputedValue<SkeletonPose> *pCurrentValues, U32 numCurrentValues,
-                                                           ComputedValue<SkeletonPose> &finalValue, Ptr<Skeleton> &pSkeleton, U32 numBones, const Float *Contribution, Memory::FastBufferAllocator& outer)
-{
-    memset(&finalValue, 0, sizeof(ComputedValue<SkeletonPose>));
-    finalValue.AdditiveContribState = SkeletonPoseContributionState::ALL_ONE;
-    finalValue.InputContribution = kDefaultContribution;
-    finalValue.Skl = pSkeleton;
-    finalValue.NumBones = (U32)pSkeleton->GetEntries().size();
-}
-
-void
-AnimationMixerAccumulater<SkeletonPose>::AccumulateFinal(const ComputedValue<SkeletonPose>* finalPriorityValues, U32 numFinalValues,
-                                                         ComputedValue<SkeletonPose>& outValue, Ptr<Skeleton>& pSkeleton, U32 numBones)
-{
     
-}
-
-// MIX COMPUTED SKELETON POSE
-template<> inline void
-AnimationMixer_ComputeValue<SkeletonPose>(AnimationMixerBase* Mixer, ComputedValue<SkeletonPose>* pOutPose, Float Time, const Float *Contribution)
-{
+    // Sets all bones, including padding, to the identity transform
+    void SetIdentity(U32 numBones);
+    
+    // Copies all bones from the source pose
+    void CopyFrom(const SkeletonPose& src, U32 numBones);
+    
+    // For each bone, start = blend(start, end, t[bone]): slerp rotations and lerp translations. Same as PerformMix<Transform>::Blend.
+    static void Blend(SkeletonPose& start, const SkeletonPose& end, const Float* t, U32 numBones);
     
-}
- // use contrib state enum
- if(CompareFloatEpsilon(runningContrib, (Float)output.NumBones, 0.000001f))
- output.ContribState = SkeletonPoseContributionState::ALL_ONE; // approx. help optimise and speed up
- else
- output.ContribState = CompareFloatEpsilon(runningContrib, 0.0f) ? SkeletonPoseContributionState::ALL_ZERO : SkeletonPoseContributionState::DEFAULT;
- 
- };
- 
- template<>
- struct PerformMix<SkeletonPose> : PerformMixBase<SkeletonPose>
- {
- 
- static inline SkeletonPose CatmullRom(const SkeletonPose& p0, const SkeletonPose& p1, const SkeletonPose& p2, const SkeletonPose& p3, Float t)
- {
- return {};
- }
- 
- static inline void PrepareValue(ComputedValue<SkeletonPose>& out, const SkeletonPose& value)
- {
- 
- }
- 
- static inline void OutputValue(ComputedValue<SkeletonPose>& out, Bool bAdditive, const SkeletonPose& value, Float contribution)
- {
- 
- }
- 
- static inline SkeletonPose Blend(const SkeletonPose& start, const SkeletonPose& end, Float t)
- {
- return {};
- }
- 
- static inline SkeletonPose BlendAdditive(const SkeletonPose& cur, const SkeletonPose& adding, Float mix)
- {
- return {};
- }
- 
- };
- 
- */
+    // For each bone, cur = additive blend of adding onto cur by mix[bone]. Same as PerformMix<Transform>::BlendAdditive.
+    static void BlendAdditive(SkeletonPose& cur, const SkeletonPose& adding, const Float* mix, U32 numBones);
+    
+    // Normalises rotations of all bones. Same as PerformMix<Transform>::Finalise (and Quaternion::Normalize).
+    static void Normalise(SkeletonPose& pose, U32 numBones);
+    
+    // Computes model (skeleton root relative) transforms from local transforms, model = model[parent] * local, normalised.
+    // Parents must come before children, ie parents[bone] < bone, or -1 for roots. Groups only depending on earlier groups are vectorised.
+    // Skeleton entries are not always parents first, so SkeletonInstance runs this on poses stored in its bone order.
+    static void LocalToModel(const SkeletonPose& local, SkeletonPose& model, const I32* parents, U32 numBones);
+    
+    // If set, the kernels use the scalar path even if SIMD is available. For comparing against it.
+    static Bool ForceScalar;
+    
+};
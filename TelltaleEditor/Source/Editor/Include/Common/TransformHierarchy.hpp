@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Core/Config.hpp>
+#include <Core/Math.hpp>
+#include <Scheduler/JobScheduler.hpp>
+
+#include <vector>
+
+/**
+ * Flat transform hierarchy. Entries are stored parent before child in depth first order, such that the subtree of an entry is the
+ * contiguous range [index, GetSubtreeEnd(index)). Local and world transforms are kept in contiguous arrays, and world transforms of dirty
+ * entries are recomputed in one linear pass over the dirty ranges, optionally split into jobs over independent subtrees.
+ * Used by scenes as an optional store for node transforms, see Scene::SetFlatTransforms.
+ */
+class TransformHierarchy
+{
+public:
+
+    // Removes all entries
+    void Clear();
+
+    // Adds an entry. Must be added in depth first pre order, so the parent (or -1 for a root) must already be added. Call Finalise after all.
+    U32 Push(I32 parent, const Transform& local);
+
+    // Call after pushing all entries, before any other calls.
+    void Finalise();
+
+    inline U32 GetSize() const
+    {
+        return (U32)_Local.size();
+    }
+
+    inline I32 GetParent(U32 index) const
+    {
+        return _Parent[index];
+    }
+
+    // One past the last entry in the subtree of the entry
+    inline U32 GetSubtreeEnd(U32 index) const
+    {
+        return _SubtreeEnd[index];
+    }
+
+    inline const Transform& GetLocal(U32 index) const
+    {
+        return _Local[index];
+    }
+
+    // Sets the local transform. Does not mark anything dirty.
+    inline void SetLocal(U32 index, const Transform& local)
+    {
+        _Local[index] = local;
+    }
+
+    // World transform of the entry. Only up to date if the entry is not dirty, call Update first.
+    inline const Transform& GetWorld(U32 index) const
+    {
+        return _World[index];
+    }
+
+    // Sets the world transform. Used to seed entries which are not marked dirty.
+    inline void SetWorld(U32 index, const Transform& world)
+    {
+        _World[index] = world;
+    }
+
+    // Adds the subtree of the entry as a range to be updated. Only entries in it marked dirty with MarkDirty are recomputed.
+    inline void AddDirtyRange(U32 root)
+    {
+        _DirtyRanges.push_back(DirtyRange{root, _SubtreeEnd[root]});
+    }
+
+    // Marks a single entry for recomputation. It must be inside a range added with AddDirtyRange.
+    inline void MarkDirty(U32 index)
+    {
+        _Dirty[index] = 1;
+    }
+
+    // Adds the range and marks all entries in the subtree dirty
+    void MarkSubtreeDirty(U32 root);
+
+    inline Bool HasDirty() const
+    {
+        return !_DirtyRanges.empty();
+    }
+
+    // Recomputes world transforms of all dirty entries. If parallel and there are enough, independent subtrees are split between job threads.
+    void Update(Bool bParallel);
+
+    // Number of dirty entries at or above which updates are split into jobs
+    static constexpr U32 ParallelThreshold = 16384;
+
+private:
+
+    struct DirtyRange
+    {
+        U32 Begin, End;
+    };
+
+    struct UpdateJob
+    {
+        TransformHierarchy* Hierarchy;
+        U32 FirstRange, EndRange; // into _JobRanges
+    };
+
+    std::vector<I32> _Parent;
+    std::vector<U32> _SubtreeEnd;
+    std::vector<Transform> _Local;
+    std::vector<Transform> _World;
+    std::vector<U8> _Dirty;
+    std::vector<DirtyRange> _DirtyRanges;
+    std::vector<DirtyRange> _JobRanges; // scratch, ranges split for jobs
+
+    void _UpdateRange(U32 begin, U32 end);
+    void _SplitRange(U32 begin, U32 end, U32 grain);
+
+    static void _RunJob(const UpdateJob& job);
+    static Bool _UpdateJob(const JobThread& thread, void* pJob, void*);
+
+};
@@ -114,6 +114,8 @@ struct ArchiveExtractionTask : EditorTask
     TTArchive* Archive1 = nullptr; // archives, either 1 or 2 is set for .ttarch or .ttarch2
     TTArchive2* Archive2 = nullptr;
     
+    U32 MaxJobs = 0; // extraction jobs in flight at once, 0 for the number of worker threads
+    
 };
 
 // Called when filename has been extracted
@@ -139,8 +141,7 @@ struct ResourcesExtractionTask : EditorTask
     Bool UseMask = false;
     Bool Folders = false; // split into folders
     
-    U32 AsyncWorkers = 0; // per thread
-    std::set<String>* WorkingFiles;
+    U32 MaxJobs = 0; // extraction jobs in flight at once, 0 for the number of worker threads
     ResourceExtractCallback* Callback = nullptr;
     
 };
@@ -391,6 +391,21 @@ public:
         return _CachedFrustum;
     }
     
+    // Gets the height of a world space sphere projected on screen, as a fraction of the screen height (1 fills it). Very large if the camera is inside it.
+    inline Float GetProjectedScreenSize(const Vector3& worldCenter, Float radius)
+    {
+        if(_BIsOrthoCamera)
+        {
+            Float height = fabsf(_OrthoTop - _OrthoBottom);
+            return height > 0.0f ? (2.0f * radius) / height : 0.0f;
+        }
+        Float distance = (worldCenter - _AgentTransform._Trans).Magnitude();
+        if(distance <= radius)
+            return 1e6f;
+        Float halfHeight = distance * tanf((_HFOV * _HFOVScale) * 0.01308997f/*pi/240*/ * 0.5f); // same vertical fov as the projection
+        return halfHeight > 0.0f ? radius / halfHeight : 0.0f;
+    }
+    
     // Calculate and set aspect ratio as ration of screen width and height
     inline void SetAspectRatio()
     {
@@ -18,6 +18,16 @@ struct SceneFrameRenderParams
     void* UserData = nullptr;
 };
 
+// Number of LODs render statistics are kept for. Higher LODs are counted in the last.
+constexpr U32 SCENE_RENDER_MAX_LOD_STATS = 8;
+
+// Statistics of the last rendered scene
+struct SceneRenderStats
+{
+    U32 Draws[SCENE_RENDER_MAX_LOD_STATS]; // draw calls submitted, per LOD
+    U32 Triangles[SCENE_RENDER_MAX_LOD_STATS]; // triangles submitted, per LOD
+};
+
 /**
  * The Scene Renderer is responsible for rendering the scene.
  */
@@ -39,6 +49,24 @@ public:
     // Reset all scene render information
     void ResetScene(Ptr<Scene> pScene);
     
+    // Force all meshes to draw the given LOD (clamped to each mesh LOD count), for inspection. -1 selects by screen size again.
+    inline void SetForceLOD(I32 lod)
+    {
+        _ForceLOD = lod;
+    }
+    
+    // Fraction the screen size of a mesh must pass a LOD threshold by to switch LOD. Stops popping when objects sit near a threshold.
+    inline void SetLODHysteresis(Float hysteresis)
+    {
+        _LODHysteresis = hysteresis;
+    }
+    
+    // Statistics of the last RenderScene call. Only valid on the thread calling RenderScene.
+    inline const SceneRenderStats& GetStats() const
+    {
+        return _Stats;
+    }
+    
     inline Ptr<RenderContext> GetRenderer()
     {
         return _Renderer;
@@ -46,8 +74,8 @@ public:
 
 private:
 
-    void _RenderMeshInstance(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, RenderViewPass* pass, RenderStateBlob blob);
-    void _RenderMeshLOD(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, Mesh::LODInstance& lod, RenderViewPass* pass, RenderStateBlob blob);
+    void _RenderMeshInstance(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, U32 lod, RenderViewPass* pass, RenderStateBlob blob);
+    void _RenderMeshLOD(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, U32 lodIndex, RenderViewPass* pass, RenderStateBlob blob);
     void _RenderMeshBatch(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, Mesh::LODInstance& lod, Mesh::MeshBatch& batch, RenderViewPass* pass, RenderStateBlob blob);
     void _UpdateMeshBuffers(RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance);
 
@@ -89,5 +117,9 @@ private:
     std::vector<SceneState> _PersistentScenes; 
     SceneState _CurrentScene;
     U64 _CallbackTag;
+    std::vector<SceneAgent*> _VisibleAgents; // frustum culled renderables, reused each frame
+    I32 _ForceLOD = -1;
+    Float _LODHysteresis = 0.1f;
+    SceneRenderStats _Stats{};
 
 };
\ No newline at end of file
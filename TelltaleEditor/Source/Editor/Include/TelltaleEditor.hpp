@@ -100,9 +100,10 @@ public:
      Enqueues a task which will asynchronously extract all files into the given output foldes from the given logical resource system locator. Pass empty string for string mask to get all files, else supply a mask.
      Optionally set the last argument to true such that folders will be created for each association: so all dlg or imaps go into Dialogs folder etc.
      The callback will be called each time a file has been extracted. It will be called asyncronously so use synchronisation primitives if needed.s
+     Files are extracted in parallel on the job scheduler, set max jobs to limit how many at once (0 uses all worker threads).
      */
     U32 EnqueueResourceLocationExtractTask(Ptr<ResourceRegistry> registry, const String& logical, String outputFolder,
-                                           StringMask mask, Bool bFolders = false, ResourceExtractCallback* pCallback = nullptr);
+                                           StringMask mask, Bool bFolders = false, ResourceExtractCallback* pCallback = nullptr, U32 maxJobs = 0);
     
     /**
      Specailses (on this thread, no enqueueing) the given instance into the meta class instance for the current game, putting it back into a telltale format which can be serialised to a file using Meta.
@@ -260,22 +260,63 @@ Ptr<Node> SkeletonInstance::_GetAgentNode()
     return _RootNode->Parent.lock();
 }
 
-void SkeletonInstance::_ApplySkeletonInstanceRestPose(Scene* pScene, Ptr<Node>& rootNode, I32 nodeIndex)
+void SkeletonInstance::_BuildBoneOrder()
 {
-    if(nodeIndex < 0)
+    const auto& entries = _Skeleton->GetEntries();
+    U32 numBones = (U32)entries.size();
+    _BoneParents.resize(numBones);
+    _BoneOrder.clear();
+    _BoneOrder.reserve(numBones);
+    
+    // bucket children by parent, then breadth first from the roots. entries are not guaranteed to list parents first
+    // children of bone p are children[childStart[p + 1], childStart[p + 2]), roots (p = -1) first
+    std::vector<U32> childStart(numBones + 2, 0), children(numBones);
+    for(U32 i = 0; i < numBones; i++)
     {
-        nodeIndex = 0;
-        for(auto& node: _Nodes)
-        {
-            if(node.Parent.lock() == rootNode)
-                _ApplySkeletonInstanceRestPose(pScene, rootNode, nodeIndex);
-            nodeIndex++;
-        }
+        I32 parent = entries[i].ParentIndex;
+        _BoneParents[i] = parent < 0 || parent >= (I32)numBones ? -1 : parent;
+        childStart[_BoneParents[i] + 2]++;
     }
-    else
+    for(U32 i = 1; i < numBones + 2; i++)
+        childStart[i] += childStart[i - 1];
+    std::vector<U32> cursor(childStart.begin(), childStart.end() - 1);
+    for(U32 i = 0; i < numBones; i++)
+        children[cursor[_BoneParents[i] + 1]++] = i;
+    for(U32 i = childStart[0]; i < childStart[1]; i++)
+        _BoneOrder.push_back(children[i]);
+    for(U32 i = 0; i < (U32)_BoneOrder.size(); i++)
+    {
+        U32 bone = _BoneOrder[i];
+        for(U32 child = childStart[bone + 1]; child < childStart[bone + 2]; child++)
+            _BoneOrder.push_back(children[child]);
+    }
+    TTE_ASSERT(_BoneOrder.size() == numBones, "Skeleton for %s has cyclic bone parents", _RootNode->AgentName.c_str());
+    
+    // parents remapped into the order, so the pose pass can run on poses stored in it (parent position is always before the child)
+    std::vector<I32> position(numBones, -1);
+    _BoneOrderParents.resize(_BoneOrder.size());
+    for(U32 i = 0; i < (U32)_BoneOrder.size(); i++)
+    {
+        position[_BoneOrder[i]] = (I32)i;
+        I32 parent = _BoneParents[_BoneOrder[i]];
+        _BoneOrderParents[i] = parent < 0 ? -1 : position[parent];
+    }
+    _BoneLocalPose.resize(SkeletonPose::GetNumGroups(numBones));
+    _BoneModelPose.resize(SkeletonPose::GetNumGroups(numBones));
+    SkeletonPose local{}, model{};
+    local.Groups = _BoneLocalPose.data();
+    model.Groups = _BoneModelPose.data();
+    local.SetIdentity(numBones);
+    model.SetIdentity(numBones);
+}
+
+void SkeletonInstance::_ApplySkeletonInstanceRestPose()
+{
+    const auto& entries = _Skeleton->GetEntries();
+    for(U32 nodeIndex: _BoneOrder)
     {
         SkeletonInstance::SklNode& node = _Nodes[nodeIndex];
-        const SkeletonEntry& entry = _Skeleton->GetEntries()[nodeIndex];
+        const SkeletonEntry& entry = entries[nodeIndex];
         
         Transform local{entry.LocalRotation, entry.LocalPosition}; // relative to parent
         node.BoneLength = entry.LocalPosition.Magnitude();
@@ -298,12 +339,6 @@ void SkeletonInstance::_ApplySkeletonInstanceRestPose(Scene* pScene, Ptr<Node>&
         
         node.CurrentTransform._Rot = local._Rot;
         node.CurrentTransform._Trans = (local._Trans / node.BoneScaleAdjust) * node.BoneRotationAdjust.Conjugate();
-        
-        for (I32 i = 0; i < _Skeleton->GetEntries().size(); ++i)
-        {
-            if (_Skeleton->GetEntries()[i].ParentIndex == nodeIndex)
-                _ApplySkeletonInstanceRestPose(pScene, rootNode, i);
-        }
     }
 }
 
@@ -335,7 +370,8 @@ void SkeletonInstance::Build(Handle<Skeleton> hSkeleton, const SceneAgent& agent
         ++node;
     }
     _Skeleton = std::move(skl);
-    _ApplySkeletonInstanceRestPose(agent.OwningScene, _RootNode, -1);
+    _BuildBoneOrder();
+    _ApplySkeletonInstanceRestPose();
     _UpdateSkeletonCachedRestPoses();
     if(!_CurrentPose)
     {
@@ -377,51 +413,32 @@ void SkeletonInstance::_UpdateNode(SklNode &node, const Transform& value, const
 
 void SkeletonInstance::_UpdateSkeletonCachedRestPoses()
 {
-    for(auto& node: _Nodes)
+    for(U32 index: _BoneOrder)
     {
-        node.CachedGlobalRestTransform = _ComputeGlobalRestTransform(TTE_PROXY_PTR(&node, Node));
+        SklNode& node = _Nodes[index];
+        I32 parent = _BoneParents[index];
+        node.CachedGlobalRestTransform = parent < 0 ? node.RestTransform : _Nodes[parent].CachedGlobalRestTransform * node.RestTransform;
     }
 }
 
-Transform SkeletonInstance::_ComputeGlobalRestTransform(const Ptr<Node>& node)
+void SkeletonInstance::_ComputeSkeletonInstancePoseMatrices()
 {
-    Transform result = ((SklNode*)node.get())->RestTransform;
-    
-    Ptr<Node> current = node->Parent.lock();
-    
-    while(current && current != _RootNode)
-    {
-        result = ((SklNode*)current.get())->RestTransform * result;
-        current = current->Parent.lock();
-    }
-    
-    return result;
-}
-
-void SkeletonInstance::_ComputeSkeletonInstancePoseMatrices(Ptr<Node> node)
-{
-    if(node != _RootNode)
+    // bone transforms relative to the skeleton root are just the product of the local transforms down from it. gather the local
+    // transforms in bone order, parents first, so the pose kernel can compose them
+    U32 numBones = (U32)_BoneOrder.size();
+    SkeletonPose local{}, model{};
+    local.Groups = _BoneLocalPose.data();
+    model.Groups = _BoneModelPose.data();
+    for(U32 i = 0; i < numBones; i++)
+        local.SetTransform(i, _Nodes[_BoneOrder[i]].LocalTransform);
+    SkeletonPose::LocalToModel(local, model, _BoneOrderParents.data(), numBones);
+    for(U32 i = 0; i < numBones; i++)
     {
-        SklNode& sklNode = *((SklNode*)node.get());
-        U32 index = 0;
-        for(auto& n: _Nodes)
-        {
-            if(n.Name == node->Name)
-            {
-                break;
-            }
-            index++;
-        }
-        TTE_ASSERT(index < _Nodes.size(), "Could not find skeleton node %s which should exist in instance", node->Name.c_str());
-        Transform current = Scene::GetNodeWorldTransform(TTE_PROXY_PTR(&sklNode, Node)) / Scene::GetNodeWorldTransform(_RootNode);
-        Transform finalBonePose = current / sklNode.CachedGlobalRestTransform;
+        U32 index = _BoneOrder[i];
+        Transform finalBonePose = model.GetTransform(i) / _Nodes[index].CachedGlobalRestTransform;
         finalBonePose.Normalise();
         _CurrentPose[index] = MatrixTransformation(Vector3::Identity, finalBonePose._Rot, finalBonePose._Trans).Transpose(); // can now be sent off to GPU.
     }
-    for(Ptr<Node> child = node->FirstChild.lock(); child; child = child->NextSibling.lock())
-    {
-        _ComputeSkeletonInstancePoseMatrices(child);
-    }
 }
 
 void SkeletonInstance::_UpdateAnimation(U64 frameNumber)
@@ -450,12 +467,12 @@ void SkeletonInstance::_UpdateAnimation(U64 frameNumber)
             Bool bAdditive = _PoseMixer->GetAdditive();
             for(auto& node: _Nodes)
             {
-                _UpdateNode(node, animatedPose.Value.Entries[index], bAdditive ? animatedPose.AdditiveValue.Entries[index] : Transform{}, animatedPose.Contribution[index],
+                _UpdateNode(node, animatedPose.Value.GetTransform(index), bAdditive ? animatedPose.AdditiveValue.GetTransform(index) : Transform{}, animatedPose.Contribution[index],
                             animatedPose.Contribution[index], bAdditive);
                 index++;
             }
         }
-        _ComputeSkeletonInstancePoseMatrices(_RootNode);
+        _ComputeSkeletonInstancePoseMatrices();
     }
     _LastUpdatedFrame = frameNumber;
 }
@@ -1155,35 +1172,25 @@ void SkeletonPoseCompoundValue::_ResolveSkeleton(const Skeleton* pSkeleton, Bool
 void ComputedValue<SkeletonPose>::AllocateFromFastBuffer(Memory::FastBufferAllocator &fastBufferAllocator, Bool bWithAdditive)
 {
     U32 numBones = (U32)Skl->GetEntries().size();
-    U32 size = (U32)(sizeof(Transform) * numBones);
+    U32 poseSize = SkeletonPose::GetNumGroups(numBones) * (U32)sizeof(SkeletonPose::Group);
+    U32 size = poseSize + (4*numBones);
     if(bWithAdditive)
         size *= 2;
-    size += (4*numBones);
-    if(bWithAdditive)
-        size += (4*numBones);
-    U8* memory = fastBufferAllocator.Alloc((U64)size, 8);
-    Value.Entries = (Transform*)memory;
-    Contribution = (Float*)(memory + (numBones * sizeof(Transform)));
+    // the allocator aligns relative to the fast buffer, which itself is only 16 byte aligned. so round the pointer up, groups are used with aligned loads
+    U8* memory = fastBufferAllocator.Alloc((U64)size + alignof(SkeletonPose::Group) - 1, alignof(SkeletonPose::Group));
+    memory = (U8*)(((uintptr_t)memory + alignof(SkeletonPose::Group) - 1) & ~(uintptr_t)(alignof(SkeletonPose::Group) - 1));
+    Value.Groups = (SkeletonPose::Group*)memory;
+    Value.SetIdentity(numBones);
+    memory += poseSize;
     if(bWithAdditive)
     {
-        AdditiveValue.Entries = (Transform*)(memory + (numBones * (sizeof(Transform) + 4)));
-        AdditiveMix = (Float*)(memory + (numBones * (2*sizeof(Transform) + 4)));
+        AdditiveValue.Groups = (SkeletonPose::Group*)memory;
+        AdditiveValue.SetIdentity(numBones);
+        memory += poseSize;
     }
+    Contribution = (Float*)memory;
     if(bWithAdditive)
-    {
-        for(U32 i = 0; i < numBones; i++)
-        {
-            new (Value.Entries + i) Transform();
-            new (AdditiveValue.Entries + i) Transform();
-        }
-    }
-    else
-    {
-        for(U32 i = 0; i < numBones; i++)
-        {
-            new (Value.Entries + i) Transform();
-        }
-    }
+        AdditiveMix = (Float*)(memory + (4*numBones));
 }
 
 void AnimationMixerAccumulater<SkeletonPose>::AccumulateCurrent(const ComputedValue<SkeletonPose>* pCurrentValues, U32 numCurrentValues,
@@ -1191,6 +1198,7 @@ void AnimationMixerAccumulater<SkeletonPose>::AccumulateCurrent(const ComputedVa
 {
     Memory::FastBufferAllocator local{};
     Float* denominator = (Float*)local.Alloc(numBones * 4, 4);
+    Float* weights = (Float*)local.Alloc(numBones * 4, 4);
     for(U32 i = 0; i < numBones; i++)
     {
         denominator[i] = 1.0f / fmaxf(Contributions[i], 0.000001f);
@@ -1199,9 +1207,10 @@ void AnimationMixerAccumulater<SkeletonPose>::AccumulateCurrent(const ComputedVa
     {
         for(U32 b = 0; b < numBones; b++)
         {
-            PerformMix<Transform>::Blend(finalValue.Value.Entries[b], pCurrentValues[i].Value.Entries[b], denominator[b]*pCurrentValues[i].Contribution[b]);
+            weights[b] = denominator[b]*pCurrentValues[i].Contribution[b];
             finalValue.Contribution[b] = fmaxf(finalValue.Contribution[b], pCurrentValues[i].Contribution[b]);
         }
+        PerformMix<SkeletonPose>::Blend(finalValue.Value, pCurrentValues[i].Value, weights, numBones);
     }
     finalValue.AdditiveMix = nullptr;
     finalValue.AdditiveValue = {};
@@ -1213,17 +1222,19 @@ void AnimationMixerAccumulater<SkeletonPose>::AccumulateFinal(const ComputedValu
     Memory::FastBufferAllocator mem{};
     U32 curIndex = numFinalValues - 1;
     Float* curContribution = (Float*)mem.Alloc(numBones*4, 4);
+    Float* weights = (Float*)mem.Alloc(numBones*4, 4);
     memcpy(curContribution, finalPriorityValues[curIndex].Contribution, numBones*4);
-    memcpy(outValue.Value.Entries, finalPriorityValues[curIndex].Value.Entries, numBones*sizeof(Transform));
+    outValue.Value.CopyFrom(finalPriorityValues[curIndex].Value, numBones);
     for(I32 i = (I32)curIndex-1; i >= 0; i--) // blend other lowert priority layers
     {
         for(U32 b = 0; b < numBones; b++)
         {
             curContribution[b] += finalPriorityValues[i].Contribution[b];
-            PerformMix<Transform>::Blend(outValue.Value.Entries[b], finalPriorityValues[i].Value.Entries[b],
-                                         finalPriorityValues[i].Contribution[b]/fmaxf(curContribution[b], 0.000001f));
+            weights[b] = finalPriorityValues[i].Contribution[b]/fmaxf(curContribution[b], 0.000001f);
         }
+        PerformMix<SkeletonPose>::Blend(outValue.Value, finalPriorityValues[i].Value, weights, numBones);
     }
+    PerformMix<SkeletonPose>::Finalise(outValue.Value, numBones);
     memcpy(outValue.Contribution, curContribution, 4*numBones);
 }
 
@@ -1306,9 +1317,8 @@ void AnimationMixer_ComputeValue<SkeletonPose>(AnimationMixerBase* Mixer, Comput
                 {
                     minAdditiveThisPriority[i] = fminf(minAdditiveThisPriority[i], 1.0f + (Contribution[i] *
                                                                                            ((pCurrent->Controller->GetAdditiveMix() * pThisComputed->AdditiveMix[i]) - 1.0f)));
-                    pOutput->AdditiveValue.Entries[i] = PerformMix<Transform>::BlendAdditive(pOutput->AdditiveValue.Entries[i],
-                                                                                             pThisComputed->AdditiveValue.Entries[i], additive[i]);
                 }
+                PerformMix<SkeletonPose>::BlendAdditive(pOutput->AdditiveValue, pThisComputed->AdditiveValue, additive, numBones);
             }
         }
         
@@ -1393,9 +1403,9 @@ SkeletonPoseCompoundValue::ComputeValue(void *Value, Ptr<PlaybackController> Con
             if(bMirrored)
                 PerformMix<Transform>::Mirror(bAdditive ? computedBoneTransform.AdditiveValue : computedBoneTransform.Value);
             output.Contribution[animated.BoneIndex] = maxContrib;
-            output.Value.Entries[animated.BoneIndex] = computedBoneTransform.Value;
+            output.Value.SetTransform(animated.BoneIndex, computedBoneTransform.Value);
             if(bAdditive)
-                output.AdditiveValue.Entries[animated.BoneIndex] = computedBoneTransform.AdditiveValue;
+                output.AdditiveValue.SetTransform(animated.BoneIndex, computedBoneTransform.AdditiveValue);
         }
     }
 }
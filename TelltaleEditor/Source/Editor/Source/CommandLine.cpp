@@ -2,6 +2,8 @@
 
 #include <sstream>
 #include <filesystem>
+#include <deque>
+#include <map>
 
 namespace CommandLine
 {
@@ -144,7 +146,10 @@ namespace CommandLine
             SymbolTable t(true);
             for(auto& f: all)
                 t.Register(f);
-            t.SerialiseOut(out);
+            if(HasArgument(args, "-binary"))
+                t.SerialiseOutBinary(out);
+            else
+                t.SerialiseOut(out);
             TTE_LOG("** Dumped symbol map!");
             FreeEditorContext();
         }
@@ -154,7 +159,10 @@ namespace CommandLine
     static I32 Executor_GenRTSM(const std::vector<TaskArgument> &args)
     {
         DataStreamRef out = DataStreamManager::GetInstance()->CreateFileStream(GetStringArgumentOrDefault(args, "-out", "./default.symmap"));
-        GetRuntimeSymbols().SerialiseOut(out);
+        if(HasArgument(args, "-binary"))
+            GetRuntimeSymbols().SerialiseOutBinary(out);
+        else
+            GetRuntimeSymbols().SerialiseOut(out);
         TTE_LOG("** Dumped symbol map!");
         return 0;
     }
@@ -175,6 +183,7 @@ namespace CommandLine
         std::filesystem::create_directories(out);
         Bool bFlat = HasArgument(args, "-flat");
         String filter = GetStringArgumentOrDefault(args, "-filter", "*");
+        I32 workers = GetIntArgumentOrDefault(args, "-workers", 0);
         GameSnapshot game = GetSnapshot(args);
         if(!game.ID.length())
             return 1;
@@ -191,7 +200,7 @@ namespace CommandLine
                 TTE_LOG("** The mount point '%s' does not exist on your local machine!", mount.c_str());
                 return 1;
             }
-            editor->EnqueueResourceLocationExtractTask(registry, "<Data>/", out, filter, !bFlat, &Executor_Extract_CallbackAsync);
+            editor->EnqueueResourceLocationExtractTask(registry, "<Data>/", out, filter, !bFlat, &Executor_Extract_CallbackAsync, (U32)MAX(0, workers));
             editor->Wait();
             TTE_LOG("\n** Successfully extracted files from resource location");
             FreeEditorContext();
@@ -361,11 +370,80 @@ namespace CommandLine
     
     // ===================== LOAD ALL DBG =====================
     
+    enum ProbeStatus
+    {
+        PROBE_PASSED,
+        PROBE_FAILED_OPEN,
+        PROBE_FAILED_READ,
+    };
+    
+    struct ProbeFile
+    {
+        const String* FileName = nullptr;
+        const String* ClassName = nullptr;
+        U64 Size = 0;
+        Float ParseTime = 0.0f; // seconds
+        ProbeStatus Status = PROBE_PASSED;
+    };
+    
+    struct ProbeClassStats
+    {
+        U32 Count = 0;
+        U32 NumFailed = 0;
+        U64 Bytes = 0;
+        Float ParseTime = 0.0f;
+    };
+    
+    // Runs on a worker thread. Reads the whole file into memory then parses it, the instance is dropped straight away.
+    static Bool _ProbeFileAsync(const JobThread& thread, void* pRawFile, void*)
+    {
+        ProbeFile* file = (ProbeFile*)pRawFile;
+        DataStreamRef stream = DataStreamManager::GetInstance()->CreateFileStream(*file->FileName);
+        if(!stream || stream->GetSize() == 0)
+        {
+            file->Status = PROBE_FAILED_OPEN;
+            return false;
+        }
+        DataStreamRef buffer = DataStreamManager::GetInstance()->CreateBufferStream("", stream->GetSize(), 0, 0);
+        if(!DataStreamManager::GetInstance()->Transfer(stream, buffer, stream->GetSize()))
+        {
+            file->Status = PROBE_FAILED_OPEN;
+            return false;
+        }
+        stream.reset();
+        buffer->SetPosition(0);
+        U64 start = GetTimeStamp();
+        Bool bOk = (Bool)Meta::ReadMetaStream(*file->FileName, buffer);
+        file->ParseTime = GetTimeStampDifference(start, GetTimeStamp());
+        file->Status = bOk ? PROBE_PASSED : PROBE_FAILED_READ;
+        return bOk;
+    }
+    
+    static String _JSONEscape(const String& str)
+    {
+        String out{};
+        out.reserve(str.length());
+        for(char c: str)
+        {
+            if(c == '"' || c == '\\')
+                out += '\\';
+            if((U8)c < 0x20)
+                out += ' ';
+            else
+                out += c;
+        }
+        return out;
+    }
+    
     static I32 Executor_LoadAll(const std::vector<TaskArgument>& args)
     {
         String inf = GetStringArgumentOrDefault(args, "-in", "");
         String outerr = GetStringArgumentOrDefault(args, "-errorfile", "./ProbeLog.txt");
+        String outreport = GetStringArgumentOrDefault(args, "-report", "");
+        Bool bVerbose = HasArgument(args, "-verbose");
+        U64 maxInflight = (U64)MAX(1, GetIntArgumentOrDefault(args, "-max-inflight-size", 256)) * 1024 * 1024;
         std::set<String> nonMeta{}, failedOpen{}, failed{};
+        std::map<String, ProbeClassStats> classStats{};
         U32 numOk = 0;
         std::vector<String> infiles = GetInputFiles(inf);
         if(!infiles.size())
@@ -373,41 +451,85 @@ namespace CommandLine
         GameSnapshot game = GetSnapshot(args);
         TelltaleEditor* editor = CreateEditorContext(game);
         {
-            U32 i = 0;
-            Float scale = 100.0f / (Float)infiles.size();
+            U64 start = GetTimeStamp(), totalBytes = 0;
+            
+            // classify on this thread, the class names are referenced by the jobs so must not move
+            std::vector<ProbeFile> files{};
+            std::set<String> classNames{};
+            files.reserve(infiles.size());
             for(const auto& fileName: infiles)
             {
-                Float percent = (Float)i * scale;
-                if(Meta::FindClassByExtension(FileGetExtension(fileName), 0) == 0)
+                U32 clazz = Meta::FindClassByExtension(FileGetExtension(fileName), 0);
+                if(clazz == 0)
                 {
                     nonMeta.insert(fileName);
-                    TTE_LOG("** %.04f%% Not a meta stream: %s", percent, fileName.c_str());
+                    if(bVerbose)
+                        TTE_LOG("** Not a meta stream: %s", fileName.c_str());
+                    continue;
                 }
-                else
+                std::error_code ec{};
+                ProbeFile& file = files.emplace_back();
+                file.FileName = &fileName;
+                file.ClassName = &*classNames.insert(Meta::GetClass(clazz).Name).first;
+                file.Size = (U64)std::filesystem::file_size(fileName, ec);
+                if(ec)
+                    file.Size = 0;
+            }
+            
+            // fan out over the workers, keeping at most maxInflight bytes of files read (or being read) at once.
+            // the oldest job is waited on first. results are only ever accumulated on this thread.
+            std::deque<std::pair<JobHandle, ProbeFile*>> inflight{};
+            U64 inflightBytes = 0;
+            U32 maxJobs = MAX(1u, JobScheduler::Instance->GetNumWorkerThreads()) * 4, numDone = 0;
+            Float scale = 100.0f / (Float)MAX(1u, (U32)files.size());
+            
+            auto retireOldest = [&]()
+            {
+                JobScheduler::Instance->Wait(inflight.front().first);
+                ProbeFile& file = *inflight.front().second;
+                inflight.pop_front();
+                inflightBytes -= file.Size;
+                Float percent = (Float)(++numDone) * scale;
+                ProbeClassStats& stats = classStats[*file.ClassName];
+                stats.Count++;
+                stats.Bytes += file.Size;
+                stats.ParseTime += file.ParseTime;
+                totalBytes += file.Size;
+                if(file.Status == PROBE_PASSED)
                 {
-                    DataStreamRef stream = DataStreamManager::GetInstance()->CreateFileStream(fileName);
-                    if(!stream || stream->GetSize() == 0)
-                    {
-                        TTE_LOG("** %.04f%% Failed to open: %s", percent, fileName.c_str());
-                        failedOpen.insert(fileName);
-                    }
-                    else
-                    {
-                        Meta::ClassInstance instance = Meta::ReadMetaStream(fileName, stream);
-                        if(instance)
-                        {
-                            numOk++;
-                            TTE_LOG("** %.04f%% Passed: %s", percent, fileName.c_str());
-                        }
-                        else
-                        {
-                            TTE_LOG("** %.04f%% Failed: %s", percent, fileName.c_str());
-                            failed.insert(fileName);
-                        }
-                    }
+                    numOk++;
+                    if(bVerbose)
+                        TTE_LOG("** %.04f%% Passed: %s", percent, file.FileName->c_str());
+                    return;
                 }
-                i++;
+                stats.NumFailed++;
+                if(file.Status == PROBE_FAILED_OPEN)
+                    failedOpen.insert(*file.FileName);
+                else
+                    failed.insert(*file.FileName);
+                TTE_LOG("** %.04f%% Failed%s: %s", percent, file.Status == PROBE_FAILED_OPEN ? " to open" : "", file.FileName->c_str());
+            };
+            
+            for(auto& file: files)
+            {
+                while(inflight.size() && (inflight.size() >= maxJobs || inflightBytes + file.Size > maxInflight))
+                    retireOldest();
+                inflightBytes += file.Size;
+                inflight.emplace_back(JobScheduler::Instance->Post(MakeJob(&_ProbeFileAsync, &file, nullptr)), &file);
             }
+            while(inflight.size())
+                retireOldest();
+            
+            Float totalTime = GetTimeStampDifference(start, GetTimeStamp());
+            
+            // summary
+            TTE_LOG("** Probed %d files in %s: %d passed, %d failed to open, %d failed to read, %d not meta streams",
+                    (U32)infiles.size(), GetFormatedTime(totalTime).c_str(), numOk, (U32)failedOpen.size(), (U32)failed.size(), (U32)nonMeta.size());
+            TTE_LOG("** %-32s %8s %8s %12s %12s", "Class", "Files", "Failed", "MB", "Parse ms");
+            for(const auto& stat: classStats)
+                TTE_LOG("** %-32s %8d %8d %12.2f %12.2f", stat.first.c_str(), stat.second.Count, stat.second.NumFailed,
+                        (Float)stat.second.Bytes / (1024.0f * 1024.0f), stat.second.ParseTime * 1000.0f);
+            
             {
                 std::stringstream log{};
                 log << "** Probed files output generated by the Telltale Editor v" TTE_VERSION "\n\n";
@@ -425,6 +547,43 @@ namespace CommandLine
                 String s = log.str();
                 logf->Write((const U8*)s.c_str(), s.length());
             }
+            
+            if(outreport.length())
+            {
+                // machine readable version of the summary (JSON)
+                std::stringstream report{};
+                report << "{\n\t\"game\": \"" << _JSONEscape(game.ID) << "\",\n\t\"platform\": \"" << _JSONEscape(game.Platform) << "\",\n";
+                report << "\t\"numFiles\": " << infiles.size() << ",\n\t\"numPassed\": " << numOk << ",\n";
+                report << "\t\"numFailedOpen\": " << failedOpen.size() << ",\n\t\"numFailedRead\": " << failed.size() << ",\n";
+                report << "\t\"numNonMeta\": " << nonMeta.size() << ",\n\t\"bytes\": " << totalBytes << ",\n";
+                report << "\t\"seconds\": " << totalTime << ",\n\t\"classes\": {";
+                Bool bComma = false;
+                for(const auto& stat: classStats)
+                {
+                    report << (bComma ? ",\n" : "\n") << "\t\t\"" << _JSONEscape(stat.first) << "\": { \"count\": " << stat.second.Count;
+                    report << ", \"failed\": " << stat.second.NumFailed << ", \"bytes\": " << stat.second.Bytes;
+                    report << ", \"parseSeconds\": " << stat.second.ParseTime << " }";
+                    bComma = true;
+                }
+                report << "\n\t},\n\t\"failedOpen\": [";
+                bComma = false;
+                for(const auto& f: failedOpen)
+                {
+                    report << (bComma ? ", " : "") << "\"" << _JSONEscape(f) << "\"";
+                    bComma = true;
+                }
+                report << "],\n\t\"failedRead\": [";
+                bComma = false;
+                for(const auto& f: failed)
+                {
+                    report << (bComma ? ", " : "") << "\"" << _JSONEscape(f) << "\"";
+                    bComma = true;
+                }
+                report << "]\n}\n";
+                DataStreamRef reportf = DataStreamManager::GetInstance()->CreateFileStream(outreport);
+                String s = report.str();
+                reportf->Write((const U8*)s.c_str(), s.length());
+            }
         }
         FreeEditorContext();
         return 0;
@@ -447,27 +606,30 @@ namespace CommandLine
         }
         
         {
-            auto& task = tasks.emplace_back(TaskInfo{"mksymmap", "Generate string symbol map of all files from game directories", &Executor_GenSM});
+            auto& task = tasks.emplace_back(TaskInfo{"mksymmap", "Generate string symbol map of all files from game directories. -binary writes the binary (memory mapped) format", &Executor_GenSM});
             task.OptionalArguments.push_back({"-out",ArgumentType::STRING, {"-o"}});
             task.RequiredArguments.push_back({"-mount",ArgumentType::STRING});
             task.RequiredArguments.push_back({"-game",ArgumentType::STRING});
             task.OptionalArguments.push_back({"-platform",ArgumentType::STRING});
             task.OptionalArguments.push_back({"-vendor",ArgumentType::STRING});
+            task.OptionalArguments.push_back({"-binary",ArgumentType::NONE});
         }
         
         {
-            auto& task = tasks.emplace_back(TaskInfo{"mkrtsymmap", "Generate string symbol map for all runtime telltale symbols", &Executor_GenRTSM});
+            auto& task = tasks.emplace_back(TaskInfo{"mkrtsymmap", "Generate string symbol map for all runtime telltale symbols. -binary writes the binary (memory mapped) format", &Executor_GenRTSM});
             task.OptionalArguments.push_back({"-out",ArgumentType::STRING, {"-o"}});
+            task.OptionalArguments.push_back({"-binary",ArgumentType::NONE});
         }
         
         {
             auto& task = tasks.emplace_back(TaskInfo{"extract", "Extract files from archives or any compound telltale file or whole game directory."
-                " Specify an optional filename filter, eg '*.scene;!*.dlg'. Flat doesn't export folders.", &Executor_Extract});
+                " Specify an optional filename filter, eg '*.scene;!*.dlg'. Flat doesn't export folders. Workers sets how many files are extracted in parallel (default all).", &Executor_Extract});
             task.OptionalArguments.push_back({"-out",ArgumentType::STRING, {"-o"}});
             task.RequiredArguments.push_back({"-in",ArgumentType::STRING, {"-i", "-f", "-file"}});
             task.RequiredArguments.push_back({"-game",ArgumentType::STRING});
             task.OptionalArguments.push_back({"-filter",ArgumentType::STRING, {"-mask"}});
             task.OptionalArguments.push_back({"-flat",ArgumentType::NONE});
+            task.OptionalArguments.push_back({"-workers",ArgumentType::INT, {"-j"}});
             task.OptionalArguments.push_back({"-platform",ArgumentType::STRING});
             task.OptionalArguments.push_back({"-vendor",ArgumentType::STRING});
         }
@@ -506,12 +668,16 @@ namespace CommandLine
         
         {
             auto& task = tasks.emplace_back(TaskInfo{"probe", "This probe command loads every single file (recursively) in the input"
-                " mount directory or archive pack. Any erroring files go to the output error file.", &Executor_LoadAll});
+                " mount directory or archive pack on the job workers, printing per class statistics. Any erroring files go to the output error file."
+                " -report writes a JSON summary, -verbose logs every file and -max-inflight-size limits the MB of files held in memory at once (default 256).", &Executor_LoadAll});
             task.OptionalArguments.push_back({"-in",ArgumentType::STRING, {"-i"}});
             task.RequiredArguments.push_back({"-game",ArgumentType::STRING});
             task.OptionalArguments.push_back({"-platform",ArgumentType::STRING});
             task.OptionalArguments.push_back({"-vendor",ArgumentType::STRING});
             task.OptionalArguments.push_back({"-errorfile",ArgumentType::STRING, {"-ef","-errf"}});
+            task.OptionalArguments.push_back({"-report",ArgumentType::STRING});
+            task.OptionalArguments.push_back({"-verbose",ArgumentType::NONE, {"-v"}});
+            task.OptionalArguments.push_back({"-max-inflight-size",ArgumentType::INT});
         }
         
         {
@@ -30,11 +30,13 @@ void SceneModule<SceneModuleType::RENDERABLE>::OnSetupAgent(SceneAgent* pAgentGe
         TTE_LOG("WARNING: Agent %s is marked renderable but does not specify any meshes (TODO Check MeshList for future games)", pAgentGettingCreated->Name.c_str()); // + add capability for this
     }
     pAgentGettingCreated->AgentNode->AddObjDataRef("", Renderable);
+    pAgentGettingCreated->OwningScene->InvalidateRenderBounds();
 }
 
 void SceneModule<SceneModuleType::RENDERABLE>::OnModuleRemove(SceneAgent* pAttachedAgent)
 {
     pAttachedAgent->AgentNode->RemoveObjData<decltype(Renderable)>("");
+    pAttachedAgent->OwningScene->InvalidateRenderBounds();
 }
 
 
@@ -231,6 +233,17 @@ public:
         return 0;
     }
     
+    static U32 luaSetLODScreenSize(LuaManager& man)
+    {
+        TTE_ASSERT(man.GetTop() == 2, "Requires 2 arguments");
+        
+        Mesh::MeshInstance* t = Task(man);
+        TTE_ASSERT(t->LODs.size(), "No LOD has been pushed");
+        t->LODs.back().ScreenSize = man.ToFloat(2);
+        
+        return 0;
+    }
+    
     static void _GetBoundings(LuaManager& man, Meta::ClassInstance& bb, Meta::ClassInstance& sph, BoundingBox& box, Sphere& bsph, Bool createSphere)
     {
         Meta::ClassInstance minmax = Meta::GetMember(bb, "mMin", true);
@@ -506,6 +519,8 @@ void Mesh::RegisterScriptAPI(LuaFunctionCollection &Col)
               "Push a level-of-detail to the given vertex state index. All sequential calls will append to this LOD.");
     PUSH_FUNC(Col, "CommonMeshSetLODBounds", &MeshAPI::luaSetLODBounds,
               "nil CommonMeshSetLODBounds(state, boundingBoxInst,  --[[optional]] boundingSphereInst)", "Set current LOD bounding information");
+    PUSH_FUNC(Col, "CommonMeshSetLODScreenSize", &MeshAPI::luaSetLODScreenSize, "nil CommonMeshSetLODScreenSize(state, screenSize)",
+              "Set the minimum projected screen size, as a fraction of the screen height, the current LOD is drawn at. By default LOD 0 is drawn above 0.25, halving for each further LOD.");
     PUSH_FUNC(Col, "CommonMeshPushBatch", &MeshAPI::luaPushBatch, "nil CommonMeshPushBatch(state, isShadowBatch)",
               "Push a mesh batch. Specify if its a shadow batch.");
     PUSH_FUNC(Col, "CommonMeshSetBatchBounds", &MeshAPI::luaBatchSetBounds,
@@ -535,6 +550,40 @@ void Mesh::RegisterScriptAPI(LuaFunctionCollection &Col)
     
 }
 
+Float Mesh::GetLODScreenSize(const MeshInstance& mesh, U32 lod)
+{
+    if(lod + 1 >= (U32)mesh.LODs.size())
+        return 0.0f; // last is always drawn
+    if(mesh.LODs[lod].ScreenSize > 0.0f)
+        return mesh.LODs[lod].ScreenSize;
+    return DefaultLODScreenSize / (Float)(1u << MIN(lod, 30u));
+}
+
+U32 Mesh::SelectLOD(const MeshInstance& mesh, Float screenSize, I32 previousLOD, Float hysteresis, I32 forceLOD)
+{
+    U32 numLODs = (U32)mesh.LODs.size();
+    if(numLODs <= 1)
+        return 0;
+    if(forceLOD >= 0)
+        return MIN((U32)forceLOD, numLODs - 1);
+    
+    // keep the previous LOD while within its range widened by the hysteresis, so objects near a threshold don't flicker between LODs
+    if(previousLOD >= 0 && previousLOD < (I32)numLODs)
+    {
+        Float lower = GetLODScreenSize(mesh, (U32)previousLOD) * (1.0f - hysteresis);
+        Bool bBelowUpper = previousLOD == 0 || screenSize < GetLODScreenSize(mesh, (U32)previousLOD - 1) * (1.0f + hysteresis);
+        if(screenSize >= lower && bBelowUpper)
+            return (U32)previousLOD;
+    }
+    
+    for(U32 lod = 0; lod < numLODs; lod++)
+    {
+        if(screenSize >= GetLODScreenSize(mesh, lod))
+            return lod;
+    }
+    return numLODs - 1;
+}
+
 void Mesh::AddMesh(Ptr<ResourceRegistry>& registry, Handle<Mesh::MeshInstance> handle)
 {
     MeshList.push_back(handle.GetObject(registry, true));
@@ -89,6 +89,7 @@ void Scene::_SetupAgent(std::map<Symbol, Ptr<SceneAgent>, SceneAgentComparator>:
     pNode->Name = pAgent->Name;
     pNode->AttachedScene = this;
     pAgent->OwningScene = this;
+    _TransformsRebuild = true;
     
     // SETUP RUNTIME PROPERTIES
     
@@ -291,6 +292,7 @@ void Scene::RemoveAgent(const Symbol& Name)
             }
         }
         _Agents.erase(it);
+        _TransformsRebuild = true;
     }
 }
 
@@ -426,8 +428,12 @@ String Scene::GetAgentAtScreenPosition(Camera& cam, U32 screenX, U32 screenY, Bo
 
     Float tmin = FLT_MAX;
     String agent{};
-    for (const auto& renderable : _Modules.GetModuleArray<SceneModuleType::RENDERABLE>())
+    std::vector<SceneAgent*> candidates{};
+    QueryRenderables(origin, direction, FLT_MAX, candidates);
+    const auto& renderables = _Modules.GetModuleArray<SceneModuleType::RENDERABLE>();
+    for (SceneAgent* pCandidate : candidates)
     {
+        const auto& renderable = renderables[pCandidate->ModuleIndices[(U32)SceneModuleType::RENDERABLE]];
         Transform agentTransform = GetNodeWorldTransform(renderable.AgentNode);
         Matrix4 agentMat = MatrixTransformation(agentTransform._Rot, agentTransform._Trans);
         for (const auto& mesh : renderable.Renderable.MeshList)
@@ -460,6 +466,128 @@ String Scene::GetAgentAtScreenPosition(Camera& cam, U32 screenX, U32 screenY, Bo
     return agent;
 }
 
+// RENDER BOUNDS
+
+BoundingBox Scene::_CalculateRenderBounds(const SceneAgent& agent)
+{
+    BoundingBox bounds{};
+    bounds.Start();
+    I32 index = agent.ModuleIndices[(U32)SceneModuleType::RENDERABLE];
+    if (index == -1 || !agent.AgentNode)
+        return bounds;
+    const auto& renderable = _Modules.GetModuleArray<SceneModuleType::RENDERABLE>()[index];
+    Transform agentTransform = GetNodeWorldTransform(agent.AgentNode);
+    Matrix4 agentMat = MatrixTransformation(agentTransform._Rot, agentTransform._Trans);
+    for (const auto& mesh : renderable.Renderable.MeshList)
+    {
+        // all box corners and the sphere, as picking tests against both
+        for (U32 corner = 0; corner < 8; corner++)
+        {
+            Vector3 local{ corner & 1 ? mesh->BBox._Max.x : mesh->BBox._Min.x,
+                corner & 2 ? mesh->BBox._Max.y : mesh->BBox._Min.y,
+                corner & 4 ? mesh->BBox._Max.z : mesh->BBox._Min.z };
+            bounds.AddPoint(Vector4(local, 1.0f) * agentMat);
+        }
+        Vector3 center = Vector4(mesh->BSphere._Center, 1.0f) * agentMat;
+        Float radius = mesh->BSphere._Radius;
+        bounds.AddPoint(center - Vector3(radius, radius, radius));
+        bounds.AddPoint(center + Vector3(radius, radius, radius));
+    }
+    return bounds;
+}
+
+void Scene::UpdateRenderBounds()
+{
+    if (_RenderBoundsRebuild)
+    {
+        _RenderBounds.Clear();
+        _DirtyRenderBounds.clear();
+        for (auto& agent : _Agents)
+        {
+            if (!agent.second->AgentNode)
+                continue;
+            agent.second->AgentNode->RenderBoundsProxy = AABBTree::Null;
+            agent.second->AgentNode->Fl.Remove(NodeFlags::NODE_RENDER_BOUNDS_DIRTY);
+        }
+        for (const auto& renderable : _Modules.GetModuleArray<SceneModuleType::RENDERABLE>())
+        {
+            if (!renderable.AgentNode)
+                continue;
+            auto it = _Agents.find(Symbol(renderable.AgentNode->AgentName));
+            if (it == _Agents.end())
+                continue;
+            BoundingBox bounds = _CalculateRenderBounds(*it->second);
+            if (bounds._Min.x <= bounds._Max.x)
+                renderable.AgentNode->RenderBoundsProxy = _RenderBounds.CreateProxy(bounds, it->second.get());
+        }
+        _RenderBoundsRebuild = false;
+        return;
+    }
+    for (I32 proxy : _DirtyRenderBounds)
+    {
+        SceneAgent* pAgent = (SceneAgent*)_RenderBounds.GetUserData(proxy);
+        pAgent->AgentNode->Fl.Remove(NodeFlags::NODE_RENDER_BOUNDS_DIRTY);
+        _RenderBounds.MoveProxy(proxy, _CalculateRenderBounds(*pAgent));
+    }
+    _DirtyRenderBounds.clear();
+}
+
+void Scene::QueryRenderables(const BoundingBox& box, std::vector<SceneAgent*>& outAgents)
+{
+    UpdateRenderBounds();
+    _RenderBounds.QueryAABB(box, [&](I32 proxy)
+    {
+        outAgents.push_back((SceneAgent*)_RenderBounds.GetUserData(proxy));
+        return true;
+    });
+}
+
+void Scene::QueryRenderables(Camera& cam, std::vector<SceneAgent*>& outAgents)
+{
+    UpdateRenderBounds();
+    _RenderBounds.QueryFrustum(GetCullingFrustum(cam), [&](I32 proxy)
+    {
+        outAgents.push_back((SceneAgent*)_RenderBounds.GetUserData(proxy));
+        return true;
+    });
+}
+
+void Scene::QueryRenderables(const Vector3& origin, const Vector3& direction, Float maxT, std::vector<SceneAgent*>& outAgents)
+{
+    UpdateRenderBounds();
+    _RenderBounds.QueryRay(origin, direction, maxT, [&](I32 proxy)
+    {
+        outAgents.push_back((SceneAgent*)_RenderBounds.GetUserData(proxy));
+        return true;
+    });
+}
+
+Frustum Scene::GetCullingFrustum(Camera& cam)
+{
+    // clip = world * viewProj (see picking). clip is linear in world, so find its rows and combine them into the planes w+x, w-x etc.
+    Matrix4 viewProj = cam.GetProjectionMatrix() * cam.GetViewMatrix();
+    Vector4 cx = Vector4(1.0f, 0.0f, 0.0f, 0.0f) * viewProj;
+    Vector4 cy = Vector4(0.0f, 1.0f, 0.0f, 0.0f) * viewProj;
+    Vector4 cz = Vector4(0.0f, 0.0f, 1.0f, 0.0f) * viewProj;
+    Vector4 cw = Vector4(0.0f, 0.0f, 0.0f, 1.0f) * viewProj;
+    auto plane = [&](Float sx, Float sy, Float sz) // plane w + sx*x + sy*y + sz*z >= 0
+    {
+        Plane p{};
+        p._Plane = Vector4(cx.w + sx * cx.x + sy * cx.y + sz * cx.z, cy.w + sx * cy.x + sy * cy.y + sz * cy.z,
+                           cz.w + sx * cz.x + sy * cz.y + sz * cz.z, cw.w + sx * cw.x + sy * cw.y + sz * cw.z);
+        return p;
+    };
+    Frustum f{};
+    // -w <= z <= w holds for both 0 to 1 and -1 to 1 depth, and inverted depth
+    f._Plane[FRUSTUM_PLANE_ZNEAR] = plane(0.0f, 0.0f, 1.0f);
+    f._Plane[FRUSTUM_PLANE_ZFAR] = plane(0.0f, 0.0f, -1.0f);
+    f._Plane[FRUSTUM_PLANE_LEFT] = plane(1.0f, 0.0f, 0.0f);
+    f._Plane[FRUSTUM_PLANE_RIGHT] = plane(-1.0f, 0.0f, 0.0f);
+    f._Plane[FRUSTUM_PLANE_DOWN] = plane(0.0f, 1.0f, 0.0f);
+    f._Plane[FRUSTUM_PLANE_UP] = plane(0.0f, -1.0f, 0.0f);
+    return f;
+}
+
 extern TelltaleEditor* _MyContext;
 
 String Scene::GetAgentScenePropertiesName(const String& sceneName, const String& agentName)
@@ -567,9 +695,15 @@ void Scene::_UpdateListenerAttachments(Ptr<Node> node)
     }
 }
 
-void Scene::_InvalidateNode(Ptr<Node> node, Node* pParent, Bool bAllowStaticUpdate)
+void Scene::_OnNodeInvalidated(Node* node)
 {
     node->Fl.Remove(NodeFlags::NODE_GLOBAL_TRANSFORM_VALID);
+    
+    if (node->RenderBoundsProxy != AABBTree::Null && node->AttachedScene && !node->Fl.Test(NodeFlags::NODE_RENDER_BOUNDS_DIRTY))
+    {
+        node->Fl.Add(NodeFlags::NODE_RENDER_BOUNDS_DIRTY);
+        node->AttachedScene->_DirtyRenderBounds.push_back(node->RenderBoundsProxy);
+    }
 
     Ptr<NodeListener> listener = node->Listeners;
     while (listener)
@@ -577,6 +711,17 @@ void Scene::_InvalidateNode(Ptr<Node> node, Node* pParent, Bool bAllowStaticUpda
         listener->OnTransformChanged(nullptr);
         listener = listener->Next;
     }
+}
+
+void Scene::_InvalidateNode(Ptr<Node> node, Node* pParent, Bool bAllowStaticUpdate)
+{
+    if (node->TransformOwner && node->TransformOwner->_FlatTransformsActive())
+    {
+        node->TransformOwner->_InvalidateFlatNode(node.get(), bAllowStaticUpdate);
+        return;
+    }
+    
+    _OnNodeInvalidated(node.get());
 
     Node* pParentTile = node->Fl.Test(NodeFlags::NODE_ENVIRONMENT_TILE) ? node.get() : nullptr;
 
@@ -589,8 +734,134 @@ void Scene::_InvalidateNode(Ptr<Node> node, Node* pParent, Bool bAllowStaticUpda
     }
 }
 
+void Scene::_InvalidateFlatNode(Node* node, Bool bAllowStaticUpdate)
+{
+    // same as the recursive invalidation, but walking the subtree range in the store
+    U32 root = (U32)node->TransformIndex;
+    U32 end = _Transforms.GetSubtreeEnd(root);
+    _Transforms.SetLocal(root, node->LocalTransform);
+    _Transforms.AddDirtyRange(root);
+    for (U32 i = root; i < end;)
+    {
+        Node* pNode = _TransformNodes[i];
+        if (i != root && !bAllowStaticUpdate && pNode->StaticListeners)
+        {
+            Node* pParentNode = _TransformNodes[_Transforms.GetParent(i)];
+            if (!pParentNode->Fl.Test(NodeFlags::NODE_ENVIRONMENT_TILE))
+            {
+                i = _Transforms.GetSubtreeEnd(i); // static and not under a tile, it and its children stay
+                continue;
+            }
+        }
+        _Transforms.MarkDirty(i);
+        _OnNodeInvalidated(pNode);
+        i++;
+    }
+}
+
+void Scene::_InvalidateNodeStructure(Node* node)
+{
+    if (node && node->TransformOwner)
+        node->TransformOwner->_TransformsRebuild = true;
+}
+
+void Scene::SetFlatTransforms(Bool bOnOff)
+{
+    if (_FlatTransforms != bOnOff)
+    {
+        _FlatTransforms = bOnOff;
+        _TransformsRebuild = true;
+        if (!bOnOff)
+            _ResetTransforms();
+    }
+}
+
+void Scene::_ResetTransforms()
+{
+    for (Node* pNode : _TransformNodes)
+    {
+        if (pNode && pNode->TransformOwner == this)
+        {
+            pNode->TransformOwner = nullptr;
+            pNode->TransformIndex = -1;
+        }
+    }
+    _TransformNodes.clear();
+    _Transforms.Clear();
+}
+
+void Scene::_RebuildTransforms()
+{
+    _ResetTransforms();
+    
+    // depth first from each root, children after their parents
+    struct Entry
+    {
+        Node* pNode;
+        I32 Parent;
+    };
+    std::vector<Entry> stack{};
+    std::vector<Node*> children{};
+    for (auto& agent : _Agents)
+    {
+        Ptr<Node> root = agent.second->AgentNode;
+        if (!root)
+            continue;
+        for (Ptr<Node> parent = root->Parent.lock(); parent; parent = parent->Parent.lock())
+            root = parent;
+        if (root->TransformOwner == this)
+            continue; // already added with another agent
+        stack.push_back(Entry{root.get(), -1});
+        while (!stack.empty())
+        {
+            Entry entry = stack.back();
+            stack.pop_back();
+            Node* pNode = entry.pNode;
+            U32 index = _Transforms.Push(entry.Parent, pNode->LocalTransform);
+            _TransformNodes.push_back(pNode);
+            pNode->TransformOwner = this;
+            pNode->TransformIndex = (I32)index;
+            children.clear();
+            for (Ptr<Node> child = pNode->FirstChild.lock(); child; child = child->NextSibling.lock())
+                children.push_back(child.get());
+            for (auto it = children.rbegin(); it != children.rend(); it++)
+                stack.push_back(Entry{*it, (I32)index});
+        }
+    }
+    _Transforms.Finalise();
+    
+    // nodes with valid world transforms keep them, as with lazy calculation. the rest are computed from their parents
+    for (U32 i = 0; i < (U32)_TransformNodes.size(); i++)
+    {
+        Node* pNode = _TransformNodes[i];
+        if (pNode->Fl.Test(NodeFlags::NODE_GLOBAL_TRANSFORM_VALID))
+            _Transforms.SetWorld(i, pNode->GlobalTransform);
+        else
+            _Transforms.MarkDirty(i);
+        if (_Transforms.GetParent(i) == -1)
+            _Transforms.AddDirtyRange(i);
+    }
+    _TransformsRebuild = false;
+}
+
+void Scene::UpdateTransforms(Bool bParallel)
+{
+    if (!_FlatTransforms)
+        return;
+    if (_TransformsRebuild)
+        _RebuildTransforms();
+    _Transforms.Update(bParallel);
+}
+
 Transform Scene::GetNodeWorldTransform(Ptr<Node> node)
 {
+    Scene* pOwner = node->TransformOwner;
+    if (pOwner && pOwner->_FlatTransformsActive())
+    {
+        if (pOwner->_Transforms.HasDirty())
+            pOwner->_Transforms.Update(false); // read before this frame's update, flush now
+        return pOwner->_Transforms.GetWorld((U32)node->TransformIndex);
+    }
     if (!node->Fl.Test(NodeFlags::NODE_GLOBAL_TRANSFORM_VALID))
         _CalculateGlobalNodeTransform(node);
     return node->GlobalTransform;
@@ -598,6 +869,12 @@ Transform Scene::GetNodeWorldTransform(Ptr<Node> node)
 
 void Scene::_CalculateGlobalNodeTransform(Ptr<Node> node)
 {
+    if (node->TransformOwner && node->TransformOwner->_FlatTransformsActive())
+    {
+        node->GlobalTransform = GetNodeWorldTransform(node);
+        node->Fl.Add(NodeFlags::NODE_GLOBAL_TRANSFORM_VALID);
+        return;
+    }
     auto parent = node->Parent.lock();
     if (parent)
     {
@@ -792,6 +1069,8 @@ void Scene::AttachNode(Ptr<Node> node, Ptr<Node> parent, Bool bPreserveWorldPosi
         auto grandParent = parent->Parent.lock();
         if (!grandParent || _ValidateNodeAttachment(grandParent, node))
         {
+            _InvalidateNodeStructure(node.get());
+            _InvalidateNodeStructure(parent.get());
             node->Parent = parent;
             node->NextSibling = parent->FirstChild;
             if (auto first = parent->FirstChild.lock())
@@ -820,6 +1099,7 @@ void Scene::UnAttachNode(Ptr<Node> node, Bool bPreserveWorldPosition, Bool bForc
         if (bPreserveWorldPosition && !node->Fl.Test(NodeFlags::NODE_GLOBAL_TRANSFORM_VALID))
             _CalculateGlobalNodeTransform(node);
 
+        _InvalidateNodeStructure(node.get());
         auto prev = node->PrevSibling.lock();
         auto next = node->NextSibling.lock();
 
@@ -971,8 +1251,9 @@ static Bool _SceneMovePostTraverse(Ptr<Node> node, void* me)
     return true;
 }
 
-Scene::Scene(Scene&& rhs) noexcept : HandleableRegistered(rhs), Name(std::move(rhs.Name)), _Flags(rhs._Flags)
+Scene::Scene(Scene&& rhs) noexcept : HandleableRegistered(rhs), Name(std::move(rhs.Name)), _Flags(rhs._Flags), _FlatTransforms(rhs._FlatTransforms)
 {
+    rhs._ResetTransforms(); // detach the nodes from rhs store while they are alive, we rebuild our own on the next update
     _Agents = std::move(rhs._Agents);
     SceneModuleUtil::PerformRecursiveModuleOperation(SceneModuleUtil::ModuleRange::ALL,
                                                      SceneModuleUtil::_ModuleVectorMoveRecurser{ rhs, *this });
@@ -987,7 +1268,7 @@ Scene::Scene(Scene&& rhs) noexcept : HandleableRegistered(rhs), Name(std::move(r
     // we dont need to move the other runtime stuff and scene moving only moves static scene data.
 }
 
-Scene::Scene(const Scene& rhs) : HandleableRegistered(rhs), Name(rhs.Name), _Flags(rhs._Flags)
+Scene::Scene(const Scene& rhs) : HandleableRegistered(rhs), Name(rhs.Name), _Flags(rhs._Flags), _FlatTransforms(rhs._FlatTransforms)
 {
     for(const auto& agent: rhs._Agents)
     {
@@ -1008,12 +1289,18 @@ Scene::Scene(const Scene& rhs) : HandleableRegistered(rhs), Name(rhs.Name), _Fla
 
 Scene::~Scene()
 {
+    _ResetTransforms();
     _Agents.clear();
 }
 
 Node::~Node()
 {
-
+    if (TransformOwner && TransformIndex >= 0 && TransformIndex < (I32)TransformOwner->_TransformNodes.size()
+        && TransformOwner->_TransformNodes[TransformIndex] == this)
+    {
+        TransformOwner->_TransformNodes[TransformIndex] = nullptr;
+        TransformOwner->_TransformsRebuild = true;
+    }
 }
 
 // OBJECT CACHE MANAGER
@@ -1,5 +1,14 @@
 #include <Common/Skeleton.hpp>
 
+// Skeleton pose kernels use 8 wide AVX if the build enables it, else SSE (always available on x86-64), else the scalar path.
+#if defined(__AVX__)
+#define TTE_POSE_AVX 1
+#include <immintrin.h>
+#elif defined(__x86_64__) || defined(_M_X64)
+#define TTE_POSE_SSE 1
+#include <immintrin.h>
+#endif
+
 class SkeletonAPI
 {
 public:
@@ -125,3 +134,411 @@ void Skeleton::RegisterScriptAPI(LuaFunctionCollection &Col)
     PUSH_FUNC(Col, "CommonSkeletonPushEntry", &SkeletonAPI::luaPushEntry, "nil CommonSkeletonPushEntry(state, entryInfoTable)",
               "Pushes skeleton entry information to the common skeleton");
 }
+
+// ========================================= SKELETON POSE =========================================
+
+Bool SkeletonPose::ForceScalar = false;
+
+void SkeletonPose::SetIdentity(U32 numBones)
+{
+    U32 numGroups = GetNumGroups(numBones);
+    for(U32 g = 0; g < numGroups; g++)
+    {
+        Group& group = Groups[g];
+        for(U32 lane = 0; lane < SKELETON_POSE_LANES; lane++)
+        {
+            group.TransX[lane] = group.TransY[lane] = group.TransZ[lane] = 0.0f;
+            group.RotX[lane] = group.RotY[lane] = group.RotZ[lane] = 0.0f;
+            group.RotW[lane] = 1.0f;
+        }
+    }
+}
+
+void SkeletonPose::CopyFrom(const SkeletonPose& src, U32 numBones)
+{
+    memcpy(Groups, src.Groups, GetNumGroups(numBones) * sizeof(Group));
+}
+
+// Scalar path. Exactly the per bone PerformMix<Transform> operations.
+
+static void _BlendScalar(SkeletonPose& start, const SkeletonPose& end, const Float* t, U32 numBones)
+{
+    for(U32 i = 0; i < numBones; i++)
+    {
+        Transform value = start.GetTransform(i), target = end.GetTransform(i);
+        value._Rot = Quaternion::Slerp(value._Rot, target._Rot, t[i]);
+        value._Trans = value._Trans + ((target._Trans - value._Trans) * t[i]);
+        start.SetTransform(i, value);
+    }
+}
+
+static void _BlendAdditiveScalar(SkeletonPose& cur, const SkeletonPose& adding, const Float* mix, U32 numBones)
+{
+    for(U32 i = 0; i < numBones; i++)
+    {
+        Transform value = cur.GetTransform(i), add = adding.GetTransform(i);
+        value._Rot = Quaternion::Slerp(Quaternion::kIdentity, add._Rot, mix[i]) * value._Rot;
+        value._Trans = value._Trans + (add._Trans * Vector3(mix[i]));
+        cur.SetTransform(i, value);
+    }
+}
+
+static void _NormaliseScalar(SkeletonPose& pose, U32 first, U32 end)
+{
+    for(U32 i = first; i < end; i++)
+    {
+        Transform value = pose.GetTransform(i);
+        value._Rot.Normalize();
+        pose.SetTransform(i, value);
+    }
+}
+
+static void _LocalToModelScalar(const SkeletonPose& local, SkeletonPose& model, const I32* parents, U32 first, U32 end)
+{
+    for(U32 i = first; i < end; i++)
+    {
+        Transform value = local.GetTransform(i);
+        if(parents[i] >= 0)
+            value = model.GetTransform((U32)parents[i]) * value;
+        value.Normalise();
+        model.SetTransform(i, value);
+    }
+}
+
+#if defined(TTE_POSE_AVX) || defined(TTE_POSE_SSE)
+
+namespace
+{
+    
+    // One register of lanes. Masks are lanes with all bits set where true.
+    struct PoseLanes
+    {
+        
+#ifdef TTE_POSE_AVX
+        static constexpr U32 Width = 8;
+        __m256 v;
+        
+        static inline PoseLanes Load(const Float* p) { return {_mm256_load_ps(p)}; }
+        static inline PoseLanes LoadUnaligned(const Float* p) { return {_mm256_loadu_ps(p)}; }
+        static inline PoseLanes Set(Float f) { return {_mm256_set1_ps(f)}; }
+        inline void Store(Float* p) const { _mm256_store_ps(p, v); }
+        
+        inline PoseLanes operator+(PoseLanes rhs) const { return {_mm256_add_ps(v, rhs.v)}; }
+        inline PoseLanes operator-(PoseLanes rhs) const { return {_mm256_sub_ps(v, rhs.v)}; }
+        inline PoseLanes operator*(PoseLanes rhs) const { return {_mm256_mul_ps(v, rhs.v)}; }
+        inline PoseLanes operator/(PoseLanes rhs) const { return {_mm256_div_ps(v, rhs.v)}; }
+        inline PoseLanes operator&(PoseLanes rhs) const { return {_mm256_and_ps(v, rhs.v)}; }
+        
+        static inline PoseLanes Sqrt(PoseLanes a) { return {_mm256_sqrt_ps(a.v)}; }
+        static inline PoseLanes Min(PoseLanes a, PoseLanes b) { return {_mm256_min_ps(a.v, b.v)}; }
+        static inline PoseLanes Max(PoseLanes a, PoseLanes b) { return {_mm256_max_ps(a.v, b.v)}; }
+        static inline PoseLanes Abs(PoseLanes a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+        static inline PoseLanes Greater(PoseLanes a, PoseLanes b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+        static inline PoseLanes GreaterEqual(PoseLanes a, PoseLanes b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+        static inline PoseLanes Select(PoseLanes mask, PoseLanes a, PoseLanes b) { return {_mm256_blendv_ps(b.v, a.v, mask.v)}; }
+#else
+        static constexpr U32 Width = 4;
+        __m128 v;
+        
+        static inline PoseLanes Load(const Float* p) { return {_mm_load_ps(p)}; }
+        static inline PoseLanes LoadUnaligned(const Float* p) { return {_mm_loadu_ps(p)}; }
+        static inline PoseLanes Set(Float f) { return {_mm_set1_ps(f)}; }
+        inline void Store(Float* p) const { _mm_store_ps(p, v); }
+        
+        inline PoseLanes operator+(PoseLanes rhs) const { return {_mm_add_ps(v, rhs.v)}; }
+        inline PoseLanes operator-(PoseLanes rhs) const { return {_mm_sub_ps(v, rhs.v)}; }
+        inline PoseLanes operator*(PoseLanes rhs) const { return {_mm_mul_ps(v, rhs.v)}; }
+        inline PoseLanes operator/(PoseLanes rhs) const { return {_mm_div_ps(v, rhs.v)}; }
+        inline PoseLanes operator&(PoseLanes rhs) const { return {_mm_and_ps(v, rhs.v)}; }
+        
+        static inline PoseLanes Sqrt(PoseLanes a) { return {_mm_sqrt_ps(a.v)}; }
+        static inline PoseLanes Min(PoseLanes a, PoseLanes b) { return {_mm_min_ps(a.v, b.v)}; }
+        static inline PoseLanes Max(PoseLanes a, PoseLanes b) { return {_mm_max_ps(a.v, b.v)}; }
+        static inline PoseLanes Abs(PoseLanes a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+        static inline PoseLanes Greater(PoseLanes a, PoseLanes b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+        static inline PoseLanes GreaterEqual(PoseLanes a, PoseLanes b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+        static inline PoseLanes Select(PoseLanes mask, PoseLanes a, PoseLanes b) { return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+#endif
+        
+    };
+    
+    struct QuatLanes
+    {
+        PoseLanes x, y, z, w;
+    };
+    
+    struct Vec3Lanes
+    {
+        PoseLanes x, y, z;
+    };
+    
+    constexpr Float kPi = 3.14159265f, kHalfPi = 1.57079633f;
+    
+    inline QuatLanes LoadRot(const SkeletonPose::Group& g, U32 lane)
+    {
+        return {PoseLanes::Load(g.RotX + lane), PoseLanes::Load(g.RotY + lane), PoseLanes::Load(g.RotZ + lane), PoseLanes::Load(g.RotW + lane)};
+    }
+    
+    inline Vec3Lanes LoadTrans(const SkeletonPose::Group& g, U32 lane)
+    {
+        return {PoseLanes::Load(g.TransX + lane), PoseLanes::Load(g.TransY + lane), PoseLanes::Load(g.TransZ + lane)};
+    }
+    
+    inline void StoreRot(SkeletonPose::Group& g, U32 lane, const QuatLanes& q)
+    {
+        q.x.Store(g.RotX + lane);
+        q.y.Store(g.RotY + lane);
+        q.z.Store(g.RotZ + lane);
+        q.w.Store(g.RotW + lane);
+    }
+    
+    inline void StoreTrans(SkeletonPose::Group& g, U32 lane, const Vec3Lanes& v)
+    {
+        v.x.Store(g.TransX + lane);
+        v.y.Store(g.TransY + lane);
+        v.z.Store(g.TransZ + lane);
+    }
+    
+    // acos, |error| < 1e-7. Abramowitz & Stegun 4.4.46, reflected for negative inputs.
+    inline PoseLanes Acos(PoseLanes x)
+    {
+        x = PoseLanes::Max(PoseLanes::Min(x, PoseLanes::Set(1.0f)), PoseLanes::Set(-1.0f));
+        PoseLanes a = PoseLanes::Abs(x);
+        PoseLanes p = PoseLanes::Set(-0.0012624911f);
+        p = p * a + PoseLanes::Set(0.0066700901f);
+        p = p * a + PoseLanes::Set(-0.0170881256f);
+        p = p * a + PoseLanes::Set(0.0308918810f);
+        p = p * a + PoseLanes::Set(-0.0501743046f);
+        p = p * a + PoseLanes::Set(0.0889789874f);
+        p = p * a + PoseLanes::Set(-0.2145988016f);
+        p = p * a + PoseLanes::Set(1.5707963050f);
+        PoseLanes r = PoseLanes::Sqrt(PoseLanes::Set(1.0f) - a) * p;
+        return PoseLanes::Select(PoseLanes::Greater(PoseLanes::Set(0.0f), x), PoseLanes::Set(kPi) - r, r);
+    }
+    
+    // sin over [-pi/2, pi/2], taylor series to x^11
+    inline PoseLanes SinHalfRange(PoseLanes x)
+    {
+        PoseLanes x2 = x * x;
+        PoseLanes p = PoseLanes::Set(-2.5052108e-8f);
+        p = p * x2 + PoseLanes::Set(2.7557319e-6f);
+        p = p * x2 + PoseLanes::Set(-1.9841270e-4f);
+        p = p * x2 + PoseLanes::Set(8.3333333e-3f);
+        p = p * x2 + PoseLanes::Set(-1.6666667e-1f);
+        p = p * x2 + PoseLanes::Set(1.0f);
+        return p * x;
+    }
+    
+    // sin over [-pi, pi]
+    inline PoseLanes Sin(PoseLanes x)
+    {
+        x = PoseLanes::Select(PoseLanes::Greater(x, PoseLanes::Set(kHalfPi)), PoseLanes::Set(kPi) - x, x);
+        x = PoseLanes::Select(PoseLanes::Greater(PoseLanes::Set(-kHalfPi), x), PoseLanes::Set(-kPi) - x, x);
+        return SinHalfRange(x);
+    }
+    
+    // cos over [-pi, pi]
+    inline PoseLanes Cos(PoseLanes x)
+    {
+        return SinHalfRange(PoseLanes::Set(kHalfPi) - PoseLanes::Abs(x));
+    }
+    
+    inline QuatLanes Multiply(const QuatLanes& a, const QuatLanes& b)
+    {
+        return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+    }
+    
+    // v rotated by q, as Vector3 * Quaternion
+    inline Vec3Lanes Rotate(const Vec3Lanes& v, const QuatLanes& q)
+    {
+        PoseLanes two = PoseLanes::Set(2.0f);
+        Vec3Lanes t{two * (q.y * v.z - q.z * v.y), two * (q.z * v.x - q.x * v.z), two * (q.x * v.y - q.y * v.x)};
+        return {v.x + q.w * t.x + (q.y * t.z - q.z * t.y), v.y + q.w * t.y + (q.z * t.x - q.x * t.z), v.z + q.w * t.z + (q.x * t.y - q.y * t.x)};
+    }
+    
+    // As Quaternion::Normalize, which leaves quaternions with w within 0.01 of 1 alone
+    inline QuatLanes Normalise(const QuatLanes& q)
+    {
+        PoseLanes mag = PoseLanes::Sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        PoseLanes mask = PoseLanes::GreaterEqual(PoseLanes::Abs(q.w - PoseLanes::Set(1.0f)), PoseLanes::Set(0.01f))
+                       & PoseLanes::Greater(mag, PoseLanes::Set(9.9999997e-21f));
+        PoseLanes inv = PoseLanes::Set(1.0f) / mag;
+        return {PoseLanes::Select(mask, q.x * inv, q.x), PoseLanes::Select(mask, q.y * inv, q.y),
+                PoseLanes::Select(mask, q.z * inv, q.z), PoseLanes::Select(mask, q.w * inv, q.w)};
+    }
+    
+    // As Quaternion::Slerp: normalised lerp if the quaternions are very close, no shortest path flip.
+    inline QuatLanes Slerp(const QuatLanes& a, const QuatLanes& b, PoseLanes t)
+    {
+        PoseLanes dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+        
+        QuatLanes lerp{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+        PoseLanes len = PoseLanes::Sqrt(lerp.x * lerp.x + lerp.y * lerp.y + lerp.z * lerp.z + lerp.w * lerp.w);
+        PoseLanes lenMask = PoseLanes::Greater(len, PoseLanes::Set(0.00001f));
+        PoseLanes invLen = PoseLanes::Select(lenMask, PoseLanes::Set(1.0f) / len, PoseLanes::Set(1.0f));
+        
+        PoseLanes theta0 = Acos(dot);
+        PoseLanes theta = theta0 * t;
+        PoseLanes s1 = Sin(theta) / Sin(theta0);
+        PoseLanes s0 = Cos(theta) - dot * s1;
+        
+        PoseLanes close = PoseLanes::Greater(dot, PoseLanes::Set(0.9995f));
+        return {PoseLanes::Select(close, lerp.x * invLen, a.x * s0 + b.x * s1), PoseLanes::Select(close, lerp.y * invLen, a.y * s0 + b.y * s1),
+                PoseLanes::Select(close, lerp.z * invLen, a.z * s0 + b.z * s1), PoseLanes::Select(close, lerp.w * invLen, a.w * s0 + b.w * s1)};
+    }
+    
+    // Weights for a group. The last group may be partial, its padding lanes get zero.
+    inline const Float* GroupWeights(const Float* weights, U32 group, U32 numBones, Float* padded)
+    {
+        U32 first = group * SKELETON_POSE_LANES;
+        if(first + SKELETON_POSE_LANES <= numBones)
+            return weights + first;
+        for(U32 lane = 0; lane < SKELETON_POSE_LANES; lane++)
+            padded[lane] = first + lane < numBones ? weights[first + lane] : 0.0f;
+        return padded;
+    }
+    
+}
+
+static void _BlendSIMD(SkeletonPose& start, const SkeletonPose& end, const Float* t, U32 numBones)
+{
+    Float padded[SKELETON_POSE_LANES];
+    U32 numGroups = SkeletonPose::GetNumGroups(numBones);
+    for(U32 g = 0; g < numGroups; g++)
+    {
+        SkeletonPose::Group& s = start.Groups[g];
+        const SkeletonPose::Group& e = end.Groups[g];
+        const Float* weights = GroupWeights(t, g, numBones, padded);
+        for(U32 lane = 0; lane < SKELETON_POSE_LANES; lane += PoseLanes::Width)
+        {
+            PoseLanes w = PoseLanes::LoadUnaligned(weights + lane);
+            StoreRot(s, lane, Slerp(LoadRot(s, lane), LoadRot(e, lane), w));
+            Vec3Lanes a = LoadTrans(s, lane), b = LoadTrans(e, lane);
+            StoreTrans(s, lane, Vec3Lanes{a.x + (b.x - a.x) * w, a.y + (b.y - a.y) * w, a.z + (b.z - a.z) * w});
+        }
+    }
+}
+
+static void _BlendAdditiveSIMD(SkeletonPose& cur, const SkeletonPose& adding, const Float* mix, U32 numBones)
+{
+    Float padded[SKELETON_POSE_LANES];
+    U32 numGroups = SkeletonPose::GetNumGroups(numBones);
+    QuatLanes identity{PoseLanes::Set(0.0f), PoseLanes::Set(0.0f), PoseLanes::Set(0.0f), PoseLanes::Set(1.0f)};
+    for(U32 g = 0; g < numGroups; g++)
+    {
+        SkeletonPose::Group& c = cur.Groups[g];
+        const SkeletonPose::Group& a = adding.Groups[g];
+        const Float* weights = GroupWeights(mix, g, numBones, padded);
+        for(U32 lane = 0; lane < SKELETON_POSE_LANES; lane += PoseLanes::Width)
+        {
+            PoseLanes w = PoseLanes::LoadUnaligned(weights + lane);
+            StoreRot(c, lane, Multiply(Slerp(identity, LoadRot(a, lane), w), LoadRot(c, lane)));
+            Vec3Lanes v = LoadTrans(c, lane), add = LoadTrans(a, lane);
+            StoreTrans(c, lane, Vec3Lanes{v.x + add.x * w, v.y + add.y * w, v.z + add.z * w});
+        }
+    }
+}
+
+static void _NormaliseSIMD(SkeletonPose& pose, U32 numBones)
+{
+    U32 numGroups = SkeletonPose::GetNumGroups(numBones);
+    for(U32 g = 0; g < numGroups; g++)
+    {
+        for(U32 lane = 0; lane < SKELETON_POSE_LANES; lane += PoseLanes::Width)
+            StoreRot(pose.Groups[g], lane, Normalise(LoadRot(pose.Groups[g], lane)));
+    }
+}
+
+static void _LocalToModelSIMD(const SkeletonPose& local, SkeletonPose& model, const I32* parents, U32 numBones)
+{
+    U32 numGroups = SkeletonPose::GetNumGroups(numBones);
+    SkeletonPose parentPose{};
+    SkeletonPose::Group parentGroup{};
+    parentPose.Groups = &parentGroup;
+    for(U32 g = 0; g < numGroups; g++)
+    {
+        U32 first = g * SKELETON_POSE_LANES, end = MIN(first + SKELETON_POSE_LANES, numBones);
+        Bool bIndependent = true;
+        for(U32 i = first; i < end && bIndependent; i++)
+            bIndependent = parents[i] < (I32)first;
+        if(!bIndependent)
+        {
+            // a bone's parent is in this group, so the lanes depend on each other
+            _LocalToModelScalar(local, model, parents, first, end);
+            continue;
+        }
+        // gather the parents (identity for roots and padding), then compose the whole group at once
+        parentPose.SetIdentity(SKELETON_POSE_LANES);
+        for(U32 i = first; i < end; i++)
+        {
+            if(parents[i] >= 0)
+                parentPose.SetTransform(i - first, model.GetTransform((U32)parents[i]));
+        }
+        const SkeletonPose::Group& l = local.Groups[g];
+        SkeletonPose::Group& m = model.Groups[g];
+        for(U32 lane = 0; lane < SKELETON_POSE_LANES; lane += PoseLanes::Width)
+        {
+            QuatLanes parentRot = LoadRot(parentGroup, lane);
+            Vec3Lanes parentTrans = LoadTrans(parentGroup, lane);
+            Vec3Lanes rotated = Rotate(LoadTrans(l, lane), parentRot);
+            StoreRot(m, lane, Normalise(Multiply(parentRot, LoadRot(l, lane))));
+            StoreTrans(m, lane, Vec3Lanes{parentTrans.x + rotated.x, parentTrans.y + rotated.y, parentTrans.z + rotated.z});
+        }
+    }
+}
+
+#define TTE_POSE_SIMD 1
+
+#endif
+
+void SkeletonPose::Blend(SkeletonPose& start, const SkeletonPose& end, const Float* t, U32 numBones)
+{
+#ifdef TTE_POSE_SIMD
+    if(!ForceScalar)
+    {
+        _BlendSIMD(start, end, t, numBones);
+        return;
+    }
+#endif
+    _BlendScalar(start, end, t, numBones);
+}
+
+void SkeletonPose::BlendAdditive(SkeletonPose& cur, const SkeletonPose& adding, const Float* mix, U32 numBones)
+{
+#ifdef TTE_POSE_SIMD
+    if(!ForceScalar)
+    {
+        _BlendAdditiveSIMD(cur, adding, mix, numBones);
+        return;
+    }
+#endif
+    _BlendAdditiveScalar(cur, adding, mix, numBones);
+}
+
+void SkeletonPose::Normalise(SkeletonPose& pose, U32 numBones)
+{
+#ifdef TTE_POSE_SIMD
+    if(!ForceScalar)
+    {
+        _NormaliseSIMD(pose, numBones);
+        return;
+    }
+#endif
+    _NormaliseScalar(pose, 0, numBones);
+}
+
+void SkeletonPose::LocalToModel(const SkeletonPose& local, SkeletonPose& model, const I32* parents, U32 numBones)
+{
+    TTE_ASSERT(local.Groups != model.Groups, "Local and model poses must be different");
+#ifdef TTE_POSE_SIMD
+    if(!ForceScalar)
+    {
+        _LocalToModelSIMD(local, model, parents, numBones);
+        return;
+    }
+#endif
+    _LocalToModelScalar(local, model, parents, 0, numBones);
+}
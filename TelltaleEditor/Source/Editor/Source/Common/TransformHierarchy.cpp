@@ -0,0 +1,159 @@
+#include <Common/TransformHierarchy.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+void TransformHierarchy::Clear()
+{
+    _Parent.clear();
+    _SubtreeEnd.clear();
+    _Local.clear();
+    _World.clear();
+    _Dirty.clear();
+    _DirtyRanges.clear();
+}
+
+U32 TransformHierarchy::Push(I32 parent, const Transform& local)
+{
+    U32 index = (U32)_Local.size();
+    TTE_ASSERT(parent < (I32)index, "Transform hierarchy entries must be pushed parent first");
+    _Parent.push_back(parent);
+    _SubtreeEnd.push_back(index + 1);
+    _Local.push_back(local);
+    _World.push_back(local);
+    _Dirty.push_back(0);
+    return index;
+}
+
+void TransformHierarchy::Finalise()
+{
+    // children come after parents, so going backwards each subtree end is final before it is passed up to its parent
+    for(U32 i = (U32)_Parent.size(); i-- > 0;)
+    {
+        I32 parent = _Parent[i];
+        if(parent >= 0)
+            _SubtreeEnd[parent] = MAX(_SubtreeEnd[parent], _SubtreeEnd[i]);
+    }
+}
+
+void TransformHierarchy::MarkSubtreeDirty(U32 root)
+{
+    AddDirtyRange(root);
+    memset(_Dirty.data() + root, 1, _SubtreeEnd[root] - root);
+}
+
+void TransformHierarchy::_UpdateRange(U32 begin, U32 end)
+{
+    const I32* parents = _Parent.data();
+    const Transform* local = _Local.data();
+    Transform* world = _World.data();
+    U8* dirty = _Dirty.data();
+    for(U32 i = begin; i < end; i++)
+    {
+        if(!dirty[i])
+            continue;
+        I32 parent = parents[i];
+        if(parent >= 0)
+        {
+            world[i] = world[parent] * local[i];
+            world[i].Normalise();
+        }
+        else
+        {
+            world[i] = local[i];
+        }
+        dirty[i] = 0;
+    }
+}
+
+void TransformHierarchy::_SplitRange(U32 begin, U32 end, U32 grain)
+{
+    // subtrees larger than the grain have their root updated here, then each child subtree is independent
+    std::vector<DirtyRange> stack{};
+    stack.push_back(DirtyRange{begin, end});
+    while(!stack.empty())
+    {
+        DirtyRange range = stack.back();
+        stack.pop_back();
+        if(range.End - range.Begin <= grain)
+        {
+            _JobRanges.push_back(range);
+            continue;
+        }
+        _UpdateRange(range.Begin, range.Begin + 1);
+        for(U32 child = range.Begin + 1; child < range.End; child = _SubtreeEnd[child])
+            stack.push_back(DirtyRange{child, _SubtreeEnd[child]});
+    }
+}
+
+void TransformHierarchy::_RunJob(const UpdateJob& job)
+{
+    for(U32 i = job.FirstRange; i < job.EndRange; i++)
+        job.Hierarchy->_UpdateRange(job.Hierarchy->_JobRanges[i].Begin, job.Hierarchy->_JobRanges[i].End);
+}
+
+Bool TransformHierarchy::_UpdateJob(const JobThread& thread, void* pJob, void*)
+{
+    _RunJob(*(UpdateJob*)pJob);
+    return true;
+}
+
+void TransformHierarchy::Update(Bool bParallel)
+{
+    if(_DirtyRanges.empty())
+        return;
+
+    // ranges are subtrees, so any two are either nested or disjoint. only the outermost need to be walked
+    std::sort(_DirtyRanges.begin(), _DirtyRanges.end(), [](const DirtyRange& lhs, const DirtyRange& rhs)
+    {
+        return lhs.Begin < rhs.Begin || (lhs.Begin == rhs.Begin && lhs.End > rhs.End);
+    });
+    U32 numRanges = 0, total = 0, lastEnd = 0;
+    for(const DirtyRange& range : _DirtyRanges)
+    {
+        if(numRanges && range.Begin < lastEnd)
+            continue;
+        _DirtyRanges[numRanges++] = range;
+        lastEnd = range.End;
+        total += range.End - range.Begin;
+    }
+    _DirtyRanges.resize(numRanges);
+
+    U32 numWorkers = JobScheduler::Instance ? JobScheduler::Instance->GetNumWorkerThreads() : 0;
+    if(!bParallel || numWorkers == 0 || total < ParallelThreshold)
+    {
+        for(const DirtyRange& range : _DirtyRanges)
+            _UpdateRange(range.Begin, range.End);
+        _DirtyRanges.clear();
+        return;
+    }
+
+    U32 numJobs = (numWorkers + 1) * 4;
+    U32 grain = MAX(total / numJobs, 2048u);
+    _JobRanges.clear();
+    for(const DirtyRange& range : _DirtyRanges)
+        _SplitRange(range.Begin, range.End, grain);
+
+    // batch consecutive ranges into jobs of about the grain size. the last is run on this thread
+    std::vector<UpdateJob> jobs{};
+    U32 batchStart = 0, batchSize = 0;
+    for(U32 i = 0; i < (U32)_JobRanges.size(); i++)
+    {
+        batchSize += _JobRanges[i].End - _JobRanges[i].Begin;
+        if(batchSize >= grain || i + 1 == (U32)_JobRanges.size())
+        {
+            jobs.push_back(UpdateJob{this, batchStart, i + 1});
+            batchStart = i + 1;
+            batchSize = 0;
+        }
+    }
+    std::vector<JobHandle> handles{};
+    handles.reserve(jobs.size());
+    for(U32 i = 0; i + 1 < (U32)jobs.size(); i++)
+        handles.push_back(JobScheduler::Instance->Post(MakeJob(&_UpdateJob, &jobs[i], nullptr, JOB_PRIORITY_HIGH)));
+    if(!jobs.empty())
+        _RunJob(jobs.back());
+    if(!handles.empty())
+        JobScheduler::Instance->Wait((U32)handles.size(), handles.data());
+    _DirtyRanges.clear();
+}
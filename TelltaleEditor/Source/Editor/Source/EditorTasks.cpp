@@ -1,5 +1,10 @@
 #include <TelltaleEditor.hpp>
 
+#include <deque>
+#include <map>
+#include <atomic>
+#include <algorithm>
+
 namespace sfs = std::filesystem;
 
 Bool AsyncTTETaskDelegate(const JobThread& thread, void* argA, void* argB)
@@ -50,6 +55,7 @@ void MeshNormalisationTask::Finalise(TelltaleEditor& editor)
     // move processed new mesh renderable instance to array, ready to be used
     Ptr<Mesh::MeshInstance> localHandle = TTE_NEW_PTR(Mesh::MeshInstance, MEMORY_TAG_COMMON_INSTANCE, std::move(Renderable));
     Output->GetAgentModule<SceneModuleType::RENDERABLE>(Agent).Renderable.MeshList.push_back(std::move(localHandle));
+    Output->InvalidateRenderBounds();
 }
 
 // TEXTURE NORMALISATION
@@ -99,62 +105,219 @@ void TextureNormalisationTask::Finalise(TelltaleEditor& editor)
     pTexture->_TextureFlags += flags; // concat flags
 }
 
-// RESOURCE SYSTEM EXTRACTION
+// EXTRACTION PIPELINE
+
+// Files at least this big are streamed straight to the output in the reading job instead of being buffered for a write job
+#define EXTRACT_MAX_BUFFERED 0x800000
+// Target uncompressed bytes per extraction job
+#define EXTRACT_JOB_BYTES 0x800000
+
+struct _ExtractEntry
+{
+    String Name; // passed to the callback
+    String OutPath;
+    DataStreamRef Stream;
+    ResourceRegistry* Registry = nullptr; // if set, the stream was dropped after resolving its source and is found again when read
+    const DataStream* Source = nullptr; // stream the file data really comes from (eg the archive container)
+    U64 Offset = 0; // offset in source
+    U64 FirstPage = 0, LastPage = 0; // pages of source spanned
+    U8* Buffer = nullptr; // read data, waiting to be written
+    U64 Size = 0;
+    Bool Decrypt = false;
+    Bool Written = false;
+};
+
+struct _ExtractGroup
+{
+    _ExtractEntry* Begin = nullptr;
+    _ExtractEntry* End = nullptr;
+    ResourceExtractCallback* Callback = nullptr;
+    JobHandle WriteJob{};
+    std::atomic<U32> NumFailed{0};
+};
+
+static void _ExtractFail(_ExtractGroup& group, _ExtractEntry& entry)
+{
+    TTE_LOG("Could not extract %s: file streams were not valid", entry.Name.c_str());
+    group.NumFailed++;
+}
 
-static Bool _DoResourcesExtract(Ptr<ResourceRegistry>& reg, const String& outputFolder, std::set<String>::const_iterator begin, std::set<String>::const_iterator end, Bool bFolders, ResourceExtractCallback* callback)
+// Writes the buffered files of a group, in order
+static Bool _ExtractWriteAsync(const JobThread& thread, void* pRawGroup, void*)
 {
-    for(auto it = begin; it != end; it++)
+    _ExtractGroup& group = *(_ExtractGroup*)pRawGroup;
+    for(_ExtractEntry* entry = group.Begin; entry != group.End; entry++)
     {
-        String outFolder = outputFolder;
-        
-        if(bFolders)
+        if(!entry->Buffer)
+            continue;
+        DataStreamRef out = DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, entry->OutPath));
+        if(out && out->Write(entry->Buffer, entry->Size))
         {
-            TTE_ASSERT(Meta::GetInternalState().GameIndex != -1, "No active game present!");
-            for(auto& mapping: Meta::GetInternalState().GetActiveGame().FolderAssociates)
+            if(group.Callback)
+                group.Callback(entry->OutPath);
+        }
+        else
+            _ExtractFail(group, *entry);
+        TTE_FREE(entry->Buffer);
+        entry->Buffer = nullptr;
+        entry->Stream.reset();
+    }
+    return group.NumFailed == 0;
+}
+
+// Reads (decompresses) a group of files which are next to each other in their source, so each page is only decompressed once.
+// Small files are buffered and handed to a write job, so this worker can move on to decompressing the next group.
+static Bool _ExtractReadAsync(const JobThread& thread, void* pRawGroup, void*)
+{
+    _ExtractGroup& group = *(_ExtractGroup*)pRawGroup;
+    Bool bBuffered = false;
+    for(_ExtractEntry* entry = group.Begin; entry != group.End; entry++)
+    {
+        if(!entry->Stream && entry->Registry)
+            entry->Stream = entry->Registry->FindResource(entry->Name);
+        if(!entry->Stream)
+        {
+            _ExtractFail(group, *entry);
+            continue;
+        }
+        entry->Stream->SetPosition(0);
+        if(entry->Decrypt)
+            entry->Stream = Meta::MapDecryptingStream(entry->Stream); // ensure its not encrypted.
+        entry->Size = entry->Stream ? entry->Stream->GetSize() : 0;
+        if(entry->Size >= EXTRACT_MAX_BUFFERED)
+        {
+            DataStreamRef out = DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, entry->OutPath));
+            if(out && DataStreamManager::GetInstance()->Transfer(entry->Stream, out, entry->Size))
             {
-                StringMask& coerced = *((StringMask*)&mapping.first);
-                if(coerced == *it)
-                {
-                    outFolder += mapping.second;
-                    break;
-                }
+                if(group.Callback)
+                    group.Callback(entry->OutPath);
             }
+            else
+                _ExtractFail(group, *entry);
+            entry->Stream.reset();
+            continue;
         }
-        
-        String fileName = outFolder + *it;
-        DataStreamRef src = reg->FindResource(*it);
-        
-        if(src)
+        entry->Buffer = TTE_ALLOC(MAX((U64)1, entry->Size), MEMORY_TAG_TEMPORARY_ASYNC);
+        if(entry->Stream && entry->Stream->Read(entry->Buffer, entry->Size))
         {
-            // ensure directory exists (may have concat paths)
-            sfs::path p = fileName;
-            p = p.parent_path();
-            if(!sfs::exists(p))
-                sfs::create_directories(p);
-            
-            src->SetPosition(0);
-            src = Meta::MapDecryptingStream(src);
-            DataStreamRef out = DataStreamManager::GetInstance()->CreateFileStream(fileName);
-            DataStreamManager::GetInstance()->Transfer(src, out, src->GetSize());
-            callback(fileName);
-        } // quietly ignore for now
-    }
-    return true;
+            bBuffered = true;
+        }
+        else
+        {
+            TTE_FREE(entry->Buffer);
+            entry->Buffer = nullptr;
+            _ExtractFail(group, *entry);
+        }
+    }
+    if(bBuffered)
+        group.WriteJob = JobScheduler::Instance->Post(MakeJob(&_ExtractWriteAsync, &group, nullptr, JOB_PRIORITY_HIGH));
+    return group.NumFailed == 0;
 }
 
-#define RES_EXTRACT_BLK 512
+// Finds where the data of the stream really comes from, looking through sub streams
+static void _ExtractResolveSource(_ExtractEntry& entry, std::map<const DataStream*, U64>& pageSizes)
+{
+    const DataStream* source = entry.Stream.get();
+    U64 offset = 0;
+    while(const DataStreamSubStream* pSub = dynamic_cast<const DataStreamSubStream*>(source))
+    {
+        offset += pSub->GetSectionOffset();
+        source = pSub->GetParent().get();
+    }
+    auto it = pageSizes.find(source);
+    if(it == pageSizes.end())
+    {
+        U64 pageSize = 0x10000;
+        if(const DataStreamContainer* pContainer = dynamic_cast<const DataStreamContainer*>(source))
+        {
+            ContainerLayout layout = pContainer->GetLayout();
+            if(layout.Compressed && layout.PageSize)
+                pageSize = layout.PageSize;
+        }
+        it = pageSizes.insert({source, pageSize}).first;
+    }
+    entry.Source = source;
+    entry.Offset = offset;
+    entry.Size = entry.Stream->GetSize();
+    entry.FirstPage = offset / it->second;
+    entry.LastPage = (offset + MAX((U64)1, entry.Size) - 1) / it->second;
+}
 
-static Bool _DoResourcesExtractAsync(const JobThread& thread, void* pRawTask, void* pRawIndex)
+// Extracts all the entries using the job scheduler. Entries are sorted by where they are in their source stream and grouped such that
+// files sharing a compressed page are always in the same job. At most maxJobs reading jobs are in flight, 0 means the number of worker threads.
+static Bool _ExtractAll(std::vector<_ExtractEntry>& entries, U32 maxJobs, ResourceExtractCallback* callback)
 {
-    U32 index = (U32)((U64)pRawIndex);
-    ResourcesExtractionTask* task = (ResourcesExtractionTask*)pRawTask;
-    auto it = task->WorkingFiles->cbegin();
-    std::advance(it, index * ((U32)task->WorkingFiles->size() / task->AsyncWorkers));
-    auto itend = it;
-    std::advance(itend, ((U32)task->WorkingFiles->size() / task->AsyncWorkers));
-    return _DoResourcesExtract(task->Registry, task->Folder, it, itend, task->Folders, task->Callback);
+    std::map<const DataStream*, U64> pageSizes{};
+    U64 totalBytes = 0;
+    for(auto& entry: entries)
+    {
+        if(entry.Stream && !entry.Source)
+            _ExtractResolveSource(entry, pageSizes);
+        totalBytes += entry.Size;
+    }
+    std::sort(entries.begin(), entries.end(), [](const _ExtractEntry& lhs, const _ExtractEntry& rhs)
+    {
+        return lhs.Source != rhs.Source ? std::less<const DataStream*>()(lhs.Source, rhs.Source) : lhs.Offset < rhs.Offset;
+    });
+    
+    if(maxJobs == 0)
+        maxJobs = MAX(1u, JobScheduler::Instance->GetNumWorkerThreads());
+    U64 jobBytes = MIN((U64)EXTRACT_JOB_BYTES, MAX((U64)0x10000, totalBytes / (maxJobs * 4)));
+    
+    // split only where the next file does not share a page with the current group
+    std::vector<std::unique_ptr<_ExtractGroup>> groups{};
+    U64 groupBytes = 0;
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        _ExtractEntry& entry = entries[i];
+        Bool bSharesPage = i > 0 && entry.Source && entry.Source == entries[i - 1].Source && entry.FirstPage <= entries[i - 1].LastPage;
+        if(groups.empty() || (!bSharesPage && groupBytes >= jobBytes))
+        {
+            groups.push_back(std::make_unique<_ExtractGroup>());
+            groups.back()->Begin = &entry;
+            groups.back()->Callback = callback;
+            groupBytes = 0;
+        }
+        groups.back()->End = &entry + 1;
+        groupBytes += entry.Size;
+    }
+    
+    // bounded number of groups being read and waiting to be written
+    std::deque<_ExtractGroup*> reading{}, writing{};
+    std::deque<JobHandle> readJobs{};
+    Bool bResult = true;
+    auto retireWrite = [&]()
+    {
+        if(writing.front()->WriteJob)
+            JobScheduler::Instance->Wait(writing.front()->WriteJob);
+        bResult = bResult && writing.front()->NumFailed == 0;
+        writing.pop_front();
+    };
+    auto retireRead = [&]()
+    {
+        JobScheduler::Instance->Wait(readJobs.front());
+        readJobs.pop_front();
+        writing.push_back(reading.front());
+        reading.pop_front();
+        while(writing.size() > maxJobs)
+            retireWrite();
+    };
+    for(auto& group: groups)
+    {
+        while(reading.size() >= maxJobs)
+            retireRead();
+        reading.push_back(group.get());
+        readJobs.push_back(JobScheduler::Instance->Post(MakeJob(&_ExtractReadAsync, group.get(), nullptr)));
+    }
+    while(reading.size())
+        retireRead();
+    while(writing.size())
+        retireWrite();
+    return bResult;
 }
 
+// RESOURCE SYSTEM EXTRACTION
+
 Bool ResourcesExtractionTask::PerformAsync(const JobThread &thread, ToolContext *pLockedContext)
 {
     if(!StringEndsWith(Folder, "/") && !StringEndsWith(Folder, "\\"))
@@ -168,27 +331,58 @@ Bool ResourcesExtractionTask::PerformAsync(const JobThread &thread, ToolContext
         loc->GetResourceNames(files, UseMask ? &Mask : nullptr);
     }
     
-    WorkingFiles = &files;
-    AsyncWorkers = files.size() <= RES_EXTRACT_BLK ? 1 : (U32)files.size() / RES_EXTRACT_BLK;
-    JobHandle H[7]{};
-    if(AsyncWorkers > 8)
-        AsyncWorkers = 8;
-    
-    for(U32 worker = 0; worker < AsyncWorkers - 1; worker++)
+    std::vector<_ExtractEntry> entries{};
+    std::set<sfs::path> directories{};
+    std::map<const DataStream*, U64> pageSizes{};
+    entries.reserve(files.size());
+    for(const auto& file: files)
     {
-        JobDescriptor J{};
-        J.Priority = JobPriority::JOB_PRIORITY_NORMAL;
-        J.UserArgA = this;
-        J.UserArgB = reinterpret_cast<void*>(static_cast<uintptr_t>(worker));;
-        J.AsyncFunction = &_DoResourcesExtractAsync;
-        H[worker] = JobScheduler::Instance->Post(J);
+        String outFolder = Folder;
+        
+        if(Folders)
+        {
+            TTE_ASSERT(Meta::GetInternalState().GameIndex != -1, "No active game present!");
+            for(auto& mapping: Meta::GetInternalState().GetActiveGame().FolderAssociates)
+            {
+                StringMask& coerced = *((StringMask*)&mapping.first);
+                if(coerced == file)
+                {
+                    outFolder += mapping.second;
+                    break;
+                }
+            }
+        }
+        
+        DataStreamRef src{};
+        {
+            std::lock_guard<std::recursive_mutex> G{Registry->_Guard};
+            Registry->_LocateResourceInternal(file, nullptr, &src);
+        }
+        if(!src)
+            continue; // quietly ignore for now
+        
+        _ExtractEntry& entry = entries.emplace_back();
+        entry.Name = file;
+        entry.OutPath = outFolder + file;
+        entry.Stream = std::move(src);
+        entry.Decrypt = true;
+        _ExtractResolveSource(entry, pageSizes);
+        if(!dynamic_cast<DataStreamSubStream*>(entry.Stream.get()))
+        {
+            // not part of a larger source (eg a loose file), so it holds its own file handle. there can be thousands, so find it again when read
+            entry.Stream.reset();
+            entry.Source = nullptr;
+            entry.Registry = Registry.get();
+        }
+        directories.insert(sfs::path(entry.OutPath).parent_path()); // may have concat paths
     }
     
-    auto it = files.cbegin();
-    std::advance(it, (AsyncWorkers - 1) * ((U32)files.size() / AsyncWorkers));
-    Bool bResult = _DoResourcesExtract(Registry, Folder, it, files.cend(), Folders, Callback);
+    // ensure directories exist up front, not racing in the jobs
+    for(const auto& dir: directories)
+        if(!dir.empty() && !sfs::exists(dir))
+            sfs::create_directories(dir);
     
-    return bResult && JobScheduler::Instance->Wait(AsyncWorkers - 1, H);
+    return _ExtractAll(entries, MaxJobs, Callback);
 }
 
 void ResourcesExtractionTask::Finalise(TelltaleEditor& editorContext)
@@ -203,50 +397,29 @@ Bool ArchiveExtractionTask::PerformAsync(const JobThread &thread, ToolContext *p
 {
     if(!StringEndsWith(Folder, "/") && !StringEndsWith(Folder, "\\"))
         Folder += "/";
-    if(Archive1 != nullptr)
+    TTE_ASSERT(Archive1 || Archive2, "No archive set in extraction task!");
+    if(Files.size() == 0)
     {
-        // EXTRACT .TTARCH
-        if(Files.size() == 0)
-            Archive1->GetFiles(Files);
-        
-        for(auto& fileName: Files)
-        {
-            DataStreamRef file = Archive1->Find(fileName, nullptr);
-            file = Meta::MapDecryptingStream(file); // ensure its not encrypted.
-            DataStreamRef out = DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, Folder + fileName));
-            if(out && file)
-            {
-                DataStreamManager::GetInstance()->Transfer(file, out, file->GetSize());
-            }
-            else
-            {
-                TTE_LOG("Could not extract %s: file streams were not valid", fileName.c_str());
-            }
-        }
+        if(Archive1)
+            Archive1->GetFiles(Files); // EXTRACT .TTARCH
+        else
+            Archive2->GetFiles(Files); // EXTRACT .TTARCH2
     }
-    else
+    
+    std::vector<_ExtractEntry> entries{};
+    entries.reserve(Files.size());
+    for(auto& fileName: Files)
     {
-        TTE_ASSERT(Archive2, "No archive set in extraction task!");
-        // EXTRACT .TTARCH2
-        if(Files.size() == 0)
-            Archive2->GetFiles(Files);
-        
-        for(auto& fileName: Files)
-        {
-            DataStreamRef file = Archive2->Find(fileName, nullptr);
-            DataStreamRef out = DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, Folder + fileName));
-            if(out && file)
-            {
-                DataStreamManager::GetInstance()->Transfer(file, out, file->GetSize());
-            }
-            else
-            {
-                TTE_LOG("Could not extract %s: file streams were not valid", fileName.c_str());
-            }
-        }
+        _ExtractEntry& entry = entries.emplace_back();
+        entry.Name = fileName;
+        entry.OutPath = Folder + fileName;
+        entry.Stream = Archive1 ? Archive1->Find(fileName, nullptr) : Archive2->Find(fileName, nullptr);
+        entry.Decrypt = Archive1 != nullptr;
     }
+    
+    Bool bResult = _ExtractAll(entries, MaxJobs, nullptr);
     Files.clear(); // not needed
-    return true;
+    return bResult;
 }
 
 void ArchiveExtractionTask::Finalise(TelltaleEditor & editorContext)
@@ -162,16 +162,20 @@ void SceneRenderer::_RenderMeshBatch(Ptr<Scene> pScene, RenderFrame& frame, cons
     pass->PushRenderInst(context, std::move(inst), objGroup);
 }
 
-void SceneRenderer::_RenderMeshLOD(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, Mesh::LODInstance& lod, RenderViewPass* pass, RenderStateBlob blob)
+void SceneRenderer::_RenderMeshLOD(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, U32 lodIndex, RenderViewPass* pass, RenderStateBlob blob)
 {
+    Mesh::LODInstance& lod = pMeshInstance->LODs[lodIndex];
+    U32 stat = MIN(lodIndex, SCENE_RENDER_MAX_LOD_STATS - 1);
     // Skip shadow for now
     for(Mesh::MeshBatch& batch: lod.Batches[0])
     {
         _RenderMeshBatch(pScene, frame, pMeshInstance, model, lod, batch, pass, blob);
+        _Stats.Draws[stat]++;
+        _Stats.Triangles[stat] += batch.NumPrimitives;
     }
 }
 
-void SceneRenderer::_RenderMeshInstance(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, RenderViewPass* pass, RenderStateBlob blob)
+void SceneRenderer::_RenderMeshInstance(Ptr<Scene> pScene, RenderFrame& frame, const Ptr<Mesh::MeshInstance> pMeshInstance, Transform model, U32 lod, RenderViewPass* pass, RenderStateBlob blob)
 {
     if(_Renderer->TouchResource(pMeshInstance))
     {
@@ -189,13 +193,9 @@ void SceneRenderer::_RenderMeshInstance(Ptr<Scene> pScene, RenderFrame& frame, c
 
         // TODO fix deformable
         //if(!pMeshInstance->MeshFlags.Test(Mesh::FLAG_DEFORMABLE))
+        if(lod < (U32)pMeshInstance->LODs.size())
         {
-
-            for (Mesh::LODInstance& LOD : pMeshInstance->LODs)
-            {
-                _RenderMeshLOD(pScene, frame, pMeshInstance, model, LOD, pass, blob);
-            }
-
+            _RenderMeshLOD(pScene, frame, pMeshInstance, model, lod, pass, blob);
         }
 
     }
@@ -282,12 +282,26 @@ void SceneRenderer::RenderScene(const SceneFrameRenderParams& frameRender) // Sc
     globalRenderState.SetValue(RenderStateType::Z_WRITE_ENABLE, true);
     globalRenderState.SetValue(RenderStateType::Z_COMPARE_FUNC, SDL_GPU_COMPAREOP_LESS_OR_EQUAL);
 
-    for(SceneModule<SceneModuleType::RENDERABLE>& renderable: frameRender.RenderScene->_Modules.GetModuleArray<SceneModuleType::RENDERABLE>())
+    _Stats = {};
+    frameRender.RenderScene->UpdateTransforms();
+    _VisibleAgents.clear();
+    frameRender.RenderScene->QueryRenderables(drawCam, _VisibleAgents);
+    auto& renderables = frameRender.RenderScene->_Modules.GetModuleArray<SceneModuleType::RENDERABLE>();
+    for(SceneAgent* pAgent: _VisibleAgents)
     {
+        SceneModule<SceneModuleType::RENDERABLE>& renderable = renderables[pAgent->ModuleIndices[(U32)SceneModuleType::RENDERABLE]];
         Transform agentWorld = Scene::GetNodeWorldTransform(renderable.AgentNode);
-        for(Ptr<Mesh::MeshInstance>& meshInstance: renderable.Renderable.MeshList)
+        Matrix4 agentMat = MatrixTransformation(agentWorld._Rot, agentWorld._Trans);
+        Mesh& meshes = renderable.Renderable;
+        meshes.SelectedLODs.resize(meshes.MeshList.size(), -1);
+        for(size_t i = 0; i < meshes.MeshList.size(); i++)
         {
-            _RenderMeshInstance(frameRender.RenderScene, frame, meshInstance, agentWorld, pDiffusePass, globalRenderState);
+            Ptr<Mesh::MeshInstance>& meshInstance = meshes.MeshList[i];
+            Vector3 worldCenter = Vector4(meshInstance->BSphere._Center, 1.0f) * agentMat;
+            Float screenSize = drawCam.GetProjectedScreenSize(worldCenter, meshInstance->BSphere._Radius);
+            U32 lod = Mesh::SelectLOD(*meshInstance, screenSize, meshes.SelectedLODs[i], _LODHysteresis, _ForceLOD);
+            meshes.SelectedLODs[i] = (I32)lod;
+            _RenderMeshInstance(frameRender.RenderScene, frame, meshInstance, agentWorld, lod, pDiffusePass, globalRenderState);
         }
     }
 
@@ -256,7 +256,7 @@ void Scene::OnAsyncRenderDetach(SceneRuntime& context)
 // The role of this function is populate the renderer with draw commands for the scene, ie go through renderables and draw them
 void Scene::PerformAsyncRender(SceneRuntime& rtContext, RenderFrame& frame, Float deltaTime)
 {
-
+    UpdateTransforms();
 }
 
 Ptr<PlaybackController> Scene::PlayAnimation(const Symbol &agentName, Ptr<Animation> pAnim)
@@ -3,6 +3,7 @@
 #include <Core/Symbol.hpp>
 
 #include <sstream>
+#include <filesystem>
 
 void luaCompleteGameEngine(LuaFunctionCollection& Col); // Full game engine (Telltale). See LuaGameEngine.cpp
 
@@ -82,12 +83,30 @@ TelltaleEditor::~TelltaleEditor()
 
     Wait(); // wait for all tasks to finish
 
-    DataStreamRef symbols = LoadLibraryResource("SymbolMaps/RuntimeSymbols.symmap"); // Save out runtime symbols
-    GetRuntimeSymbols().SerialiseOut(symbols);
-
     RenderContext::Shutdown();
     _ModuleVisualProperties.clear();
 
+    // Save out runtime symbols, in the format they were loaded in. Written to a new file which then replaces the map. Nothing else is running
+    // now, so the loaded map images are released first: a binary map is still mapped and open, which would stop the replace on Windows.
+    String symbolsPath = _ModdingContext->GetLibraryResourcePath("SymbolMaps/RuntimeSymbols.symmap");
+    String symbolsTempPath = symbolsPath + ".tmp";
+    std::error_code ec{};
+    std::filesystem::remove(symbolsTempPath, ec);
+    {
+        DataStreamRef symbols = DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, symbolsTempPath));
+        if(GetRuntimeSymbols().IsBinary())
+            GetRuntimeSymbols().SerialiseOutBinary(symbols);
+        else
+            GetRuntimeSymbols().SerialiseOut(symbols);
+    }
+    GetRuntimeSymbols().Release();
+    std::filesystem::rename(symbolsTempPath, symbolsPath, ec);
+    if(ec)
+    {
+        TTE_LOG("WARNING: Could not save runtime symbols: %s", ec.message().c_str());
+        std::filesystem::remove(symbolsTempPath, ec);
+    }
+
     DestroyToolContext();
     _ModdingContext = nullptr;
     PlatformInputMapper::Shutdown();
@@ -175,7 +194,7 @@ static void _DefaultResourceCallback(const String&)
 
 U32 TelltaleEditor::EnqueueResourceLocationExtractTask(Ptr<ResourceRegistry> registry,
                                                         const String& logical, String outputFolder,
-                                                        StringMask mask, Bool f, ResourceExtractCallback* pCb)
+                                                        StringMask mask, Bool f, ResourceExtractCallback* pCb, U32 maxJobs)
 {
     TTE_ASSERT(IsCallingFromMain(), "Only can be called from the main thread");
     ResourcesExtractionTask* task = TTE_NEW(ResourcesExtractionTask, MEMORY_TAG_TEMPORARY_ASYNC, _TaskFence);
@@ -183,6 +202,7 @@ U32 TelltaleEditor::EnqueueResourceLocationExtractTask(Ptr<ResourceRegistry> reg
     task->Logical = logical;
     task->Folders = f;
     task->Callback = pCb ? pCb : &_DefaultResourceCallback;
+    task->MaxJobs = maxJobs;
     task->Mask = mask;
     if (mask.length())
         task->UseMask = true;
@@ -307,12 +307,16 @@ void UIPropertySet::_AddElementCallback(Meta::ClassInstance newValue, Meta::Clas
         U8 Accel[128]{};
         Bool bNeedCheck = bKeyed || ((Meta::GetClass(collection.GetValueClass()).Flags & Meta::CLASS_COLLECTION_SORTED) != 0);
         Bool bNeedWarn = false;
-        if(bNeedCheck)
+        if(bKeyed)
+        {
+            bNeedWarn = collection.Contains(newValue);
+        }
+        else if(bNeedCheck)
         {
             U32 nelem = collection.GetSize();
             for(U32 i = 0; i < nelem; i++)
             {
-                Meta::ClassInstance comparand = bKeyed ? collection.GetKey(i) : collection.GetValue(i);
+                Meta::ClassInstance comparand = collection.GetValue(i);
                 if(Meta::PerformEquality(newValue, comparand))
                 {
                     bNeedWarn = true;
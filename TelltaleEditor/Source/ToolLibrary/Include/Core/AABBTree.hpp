@@ -0,0 +1,256 @@
+#pragma once
+
+#include <Core/Config.hpp>
+#include <Core/Math.hpp>
+
+#include <vector>
+
+/**
+ * Dynamic bounding volume hierarchy of axis aligned bounding boxes, for spatial queries over many moving objects (eg picking and culling in scenes).
+ * Each object is a proxy (a leaf) with a user data pointer. Leaf boxes are fattened by a margin such that small movements don't change the tree.
+ * Internal nodes always have two children and are kept balanced with tree rotations on insertion and removal.
+ * Not thread safe. Queries can run concurrently with each other, but not with any modification.
+ */
+class AABBTree
+{
+public:
+
+    static constexpr I32 Null = -1;
+
+    // Sets the margin (in world units) which leaf boxes are enlarged by. Only affects proxies created or moved after this.
+    inline void SetMargin(Float margin)
+    {
+        _Margin = margin;
+    }
+
+    // Creates a proxy for the given world box. Returns the proxy ID, which is stable until it is destroyed.
+    I32 CreateProxy(const BoundingBox& box, void* userData);
+
+    // Destroys the given proxy.
+    void DestroyProxy(I32 proxy);
+
+    // Updates the box of the given proxy. Returns true if the tree was changed, false if the box still fits in the fattened leaf.
+    Bool MoveProxy(I32 proxy, const BoundingBox& box);
+
+    // Removes all proxies.
+    void Clear();
+
+    // Returns true if the given ID is a live proxy
+    inline Bool IsProxy(I32 proxy) const
+    {
+        return proxy >= 0 && proxy < (I32)_Nodes.size() && _Nodes[proxy].Height == 0;
+    }
+
+    inline void* GetUserData(I32 proxy) const
+    {
+        return _Nodes[proxy].UserData;
+    }
+
+    // Gets the fattened box of the proxy
+    inline const BoundingBox& GetFatBounds(I32 proxy) const
+    {
+        return _Nodes[proxy].Bounds;
+    }
+
+    inline U32 GetNumProxies() const
+    {
+        return _NumProxies;
+    }
+
+    // Height of the tree, 0 if empty or one proxy.
+    inline I32 GetHeight() const
+    {
+        return _Root == Null ? 0 : _Nodes[_Root].Height;
+    }
+
+    // Calls fn(I32 proxy) for each proxy whose fattened box overlaps the box. Return false from fn to stop the query.
+    template<typename Fn>
+    inline void QueryAABB(const BoundingBox& box, Fn&& fn) const
+    {
+        I32 stack[_MaxStack];
+        I32 top = 0;
+        if(_Root != Null)
+            stack[top++] = _Root;
+        while(top)
+        {
+            const TreeNode& node = _Nodes[stack[--top]];
+            if(!_Overlaps(node.Bounds, box))
+                continue;
+            if(node.Height == 0)
+            {
+                if(!fn((I32)(&node - _Nodes.data())))
+                    return;
+            }
+            else
+            {
+                TTE_ASSERT(top + 2 <= _MaxStack, "AABB tree too deep");
+                stack[top++] = node.Child1;
+                stack[top++] = node.Child2;
+            }
+        }
+    }
+
+    // Calls fn(I32 proxy) for each proxy whose fattened box is not fully outside the frustum. Planes face inwards (dot(n, p) + w > 0 is inside).
+    // Subtrees fully inside every plane are reported without testing further. Return false from fn to stop the query.
+    template<typename Fn>
+    inline void QueryFrustum(const Frustum& frustum, Fn&& fn) const
+    {
+        // each entry carries the mask of planes its parent was not fully inside of
+        struct Entry
+        {
+            I32 Node;
+            U32 Planes;
+        };
+        Entry stack[_MaxStack];
+        I32 top = 0;
+        if(_Root != Null)
+            stack[top++] = Entry{_Root, (1u << FRUSTUM_PLANE_COUNT) - 1};
+        while(top)
+        {
+            Entry entry = stack[--top];
+            const TreeNode& node = _Nodes[entry.Node];
+            U32 planes = entry.Planes;
+            Bool bOutside = false;
+            for(U32 i = 0; i < FRUSTUM_PLANE_COUNT && !bOutside; i++)
+            {
+                if((planes & (1u << i)) == 0)
+                    continue;
+                U32 test = _TestPlane(frustum._Plane[i]._Plane, node.Bounds);
+                if(test == 0)
+                    bOutside = true;
+                else if(test == 2)
+                    planes &= ~(1u << i); // fully inside this one, children are too
+            }
+            if(bOutside)
+                continue;
+            if(node.Height == 0)
+            {
+                if(!fn(entry.Node))
+                    return;
+            }
+            else if(planes == 0)
+            {
+                if(!_ReportAll(entry.Node, fn))
+                    return;
+            }
+            else
+            {
+                TTE_ASSERT(top + 2 <= _MaxStack, "AABB tree too deep");
+                stack[top++] = Entry{node.Child1, planes};
+                stack[top++] = Entry{node.Child2, planes};
+            }
+        }
+    }
+
+    // Calls fn(I32 proxy) for each proxy whose fattened box the ray hits between origin and origin + direction * maxT. Direction need not be normalised.
+    // Return false from fn to stop the query.
+    template<typename Fn>
+    inline void QueryRay(const Vector3& origin, const Vector3& direction, Float maxT, Fn&& fn) const
+    {
+        Vector3 invDir{direction.x != 0.0f ? 1.0f / direction.x : 3.4028235e38f,
+            direction.y != 0.0f ? 1.0f / direction.y : 3.4028235e38f,
+            direction.z != 0.0f ? 1.0f / direction.z : 3.4028235e38f};
+        I32 stack[_MaxStack];
+        I32 top = 0;
+        if(_Root != Null)
+            stack[top++] = _Root;
+        while(top)
+        {
+            I32 index = stack[--top];
+            const TreeNode& node = _Nodes[index];
+            if(!_RayHits(node.Bounds, origin, invDir, maxT))
+                continue;
+            if(node.Height == 0)
+            {
+                if(!fn(index))
+                    return;
+            }
+            else
+            {
+                TTE_ASSERT(top + 2 <= _MaxStack, "AABB tree too deep");
+                stack[top++] = node.Child1;
+                stack[top++] = node.Child2;
+            }
+        }
+    }
+
+private:
+
+    static constexpr I32 _MaxStack = 256;
+
+    struct TreeNode
+    {
+        BoundingBox Bounds;
+        void* UserData = nullptr;
+        I32 Parent = Null; // next free node when in the free list
+        I32 Child1 = Null, Child2 = Null;
+        I32 Height = -1; // 0 for leaves, -1 if free
+    };
+
+    std::vector<TreeNode> _Nodes;
+    I32 _Root = Null;
+    I32 _FreeList = Null;
+    U32 _NumProxies = 0;
+    Float _Margin = 0.1f;
+
+    I32 _AllocateNode();
+    void _FreeNode(I32 node);
+    void _InsertLeaf(I32 leaf);
+    void _RemoveLeaf(I32 leaf);
+    I32 _Balance(I32 node);
+
+    inline static Bool _Overlaps(const BoundingBox& a, const BoundingBox& b)
+    {
+        return a._Min.x <= b._Max.x && a._Max.x >= b._Min.x && a._Min.y <= b._Max.y && a._Max.y >= b._Min.y && a._Min.z <= b._Max.z && a._Max.z >= b._Min.z;
+    }
+
+    // 0 if the box is fully outside the plane, 1 if it straddles it and 2 if fully inside
+    inline static U32 _TestPlane(const Vector4& plane, const BoundingBox& box)
+    {
+        Float dFar = plane.x * (plane.x >= 0.0f ? box._Max.x : box._Min.x) + plane.y * (plane.y >= 0.0f ? box._Max.y : box._Min.y)
+            + plane.z * (plane.z >= 0.0f ? box._Max.z : box._Min.z) + plane.w;
+        if(dFar < 0.0f)
+            return 0;
+        Float dNear = plane.x * (plane.x >= 0.0f ? box._Min.x : box._Max.x) + plane.y * (plane.y >= 0.0f ? box._Min.y : box._Max.y)
+            + plane.z * (plane.z >= 0.0f ? box._Min.z : box._Max.z) + plane.w;
+        return dNear > 0.0f ? 2 : 1;
+    }
+
+    // slab test
+    inline static Bool _RayHits(const BoundingBox& box, const Vector3& origin, const Vector3& invDir, Float maxT)
+    {
+        Float t1 = (box._Min.x - origin.x) * invDir.x, t2 = (box._Max.x - origin.x) * invDir.x;
+        Float tmin = MIN(t1, t2), tmax = MAX(t1, t2);
+        t1 = (box._Min.y - origin.y) * invDir.y; t2 = (box._Max.y - origin.y) * invDir.y;
+        tmin = MAX(tmin, MIN(t1, t2)); tmax = MIN(tmax, MAX(t1, t2));
+        t1 = (box._Min.z - origin.z) * invDir.z; t2 = (box._Max.z - origin.z) * invDir.z;
+        tmin = MAX(tmin, MIN(t1, t2)); tmax = MIN(tmax, MAX(t1, t2));
+        return tmax >= MAX(tmin, 0.0f) && tmin <= maxT;
+    }
+
+    template<typename Fn>
+    inline Bool _ReportAll(I32 subtree, Fn& fn) const
+    {
+        I32 stack[_MaxStack];
+        I32 top = 0;
+        stack[top++] = subtree;
+        while(top)
+        {
+            I32 index = stack[--top];
+            const TreeNode& node = _Nodes[index];
+            if(node.Height == 0)
+            {
+                if(!fn(index))
+                    return false;
+            }
+            else
+            {
+                TTE_ASSERT(top + 2 <= _MaxStack, "AABB tree too deep");
+                stack[top++] = node.Child1;
+                stack[top++] = node.Child2;
+            }
+        }
+        return true;
+    }
+
+};
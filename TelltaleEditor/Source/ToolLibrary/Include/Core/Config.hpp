@@ -276,6 +276,17 @@ U64 FilePos(U64 Handle); // Return file position
 
 void FileSeek(U64 Handle, U64 Offset); // SEEK_SET
 
+// Positional read (pread). Does not use or move the file position, so can be called from multiple threads on one handle.
+Bool FileReadAt(U64 Handle, U64 Offset, U8* Buffer, U64 Nbytes);
+
+// Positional write (pwrite). Does not use or move the file position.
+Bool FileWriteAt(U64 Handle, U64 Offset, const U8* Buffer, U64 Nbytes);
+
+// Maps the first Size bytes of the file into memory read-only. Returns nullptr if mapping failed or is not supported.
+U8* FileMapReadOnly(U64 Handle, U64 Size);
+
+void FileUnmap(U8* Mapping, U64 Size); // unmap memory returned from FileMapReadOnly. pass in the size you mapped.
+
 void OodleOpen(void*& CompressorOut, void*& DecompressorOut); // opens oodle lib
 
 void OodleClose(); // close oodle lib
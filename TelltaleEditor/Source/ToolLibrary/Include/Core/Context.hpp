@@ -57,9 +57,15 @@ public:
     // for now it only needs to load from dev directory. This can be called even if switched has not be called yet.
     // THIS CAN BE CALLED ASYNC
     inline DataStreamRef LoadLibraryResource(String name)
+    {
+        return DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, GetLibraryResourcePath(name)));
+    }
+    
+    // Gets the file path of the library resource, see LoadLibraryResource.
+    inline String GetLibraryResourcePath(String name)
     {
         // Fow now just load from the Dev/ directory, relative to cmake build dir.
-        return DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, "../../Dev/" + name));
+        return "../../Dev/" + name;
     }
     
     // Reads the library resource, see LoadlibraryResource, as a raw text file and returns the text. Returns empty string if errors.
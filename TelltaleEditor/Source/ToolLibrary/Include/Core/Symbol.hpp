@@ -4,6 +4,9 @@
 #include <vector>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <atomic>
 
 // Perform ECMA-182 Poly CRC64
 U64 CRC64(const U8 *Buffer, U32 BufferLength, U64 InitialCRC64 = 0);
@@ -73,8 +76,10 @@ inline bool CompareCaseInsensitive(const String &lhs, const String &rhs) { retur
 extern const U64 CRC64_Table[256];
 extern const U32 CRC32_Table[256];
 
-// .SYMTAB FILES. SymbolTable keeps a memory of the strings that symbols represent. Serialised format is just text file of strings one each line.
-// If the line starts with 'CRC32:' then the CRC32 is registered instead (used for some other stuff)
+// .SYMTAB FILES. SymbolTable keeps a memory of the strings that symbols represent. Two serialised formats:
+// Text: strings one each line. If the line starts with 'CRC32:' then the CRC32 is registered instead (used for some other stuff). Import/export format.
+// Binary: header, then an array of (hash, offset, length) entries sorted by hash, then the string blob. Files are memory mapped and searched in place.
+// Each loaded file is an immutable image which is searched without locking. Strings registered at runtime go into a separate sharded overlay.
 class SymbolTable {
     
     static SymbolTable* _ActiveTables;
@@ -108,24 +113,74 @@ public:
     
     // DO NOT CREATE NON PRIVATE INSTANCES OF THESE UNLESS THEY ARE GLOBALS AND ONLY GET DESTROYED AT PROGRAM END!
     SymbolTable(Bool bPrivate = false);
-    ~SymbolTable() = default;
+    ~SymbolTable();
     
     void Register(const String&); // Registers a symbol to the table
     
     void Clear(); // Clears the symbol table. Strongly advised not to do this, as old game files may not write back correctly.
     
-    void SerialiseOut(DataStreamRef&); // Writes all the symbols to the given data stream, such that reading them back in produces the same table.
+    // Clears the symbol table and frees all images, including cleared ones, closing any mapped symbol map files.
+    // Only call when no other threads can be looking up symbols, eg at shutdown before writing over a loaded map.
+    void Release();
     
-    void SerialiseIn(DataStreamRef&); // Reads in the serialised version. Adds to whats currently in here, does not clear.
+    void SerialiseOut(DataStreamRef&); // Writes all the symbols to the given data stream in the text format, such that reading them back in produces the same table.
+    
+    void SerialiseOutBinary(DataStreamRef&); // Writes all the symbols to the given data stream in the binary format.
+    
+    // Reads in the serialised version, text or binary. Adds to whats currently in here, does not clear. The same file read again is ignored.
+    // Binary file streams are mapped and kept open. Do not write to a symbol map file which is loaded!
+    void SerialiseIn(DataStreamRef&);
+    
+    // Returns true if the last symbol map read in was the binary format, such that it can be written back in the same format.
+    inline Bool IsBinary() const { return _Binary; }
     
     String FindLocal(Symbol); // Finds a symbol
 
 private:
     
+    struct ImageEntry
+    {
+        U64 Hash;
+        U32 Offset; // into the blob
+        U32 Length;
+    };
+    
+    // Immutable sorted symbol array. Never freed once published, until the table is destroyed. Only the link changes, if cleared and then republished.
+    struct Image
+    {
+        const ImageEntry* Entries = nullptr;
+        U32 NumEntries = 0;
+        const char* Blob = nullptr;
+        U64 BlobSize = 0;
+        U64 ContentHash = 0; // to ignore the same file loaded twice
+        std::vector<U8> OwnedMemory; // text imports and unmappable binary files
+        std::vector<ImageEntry> OwnedEntries; // text imports
+        DataStreamRef MappedStream; // keeps the mapping alive
+        std::atomic<Image*> Next{nullptr}; // older image. atomic as readers may still be walking a cleared image when its republished
+    };
+    
+    struct OverlayShard
+    {
+        std::shared_mutex Lock;
+        std::unordered_map<U64, String> Strings;
+    };
+    
+    static constexpr U32 NumOverlayShards = 16;
+    
+    const ImageEntry* _FindInImages(Symbol sym, const Image*& pImage) const; // lock free
+    
+    void _Publish(Image* pImage); // call with _Lock
+    
+    Bool _ReviveImage(U64 contentHash); // true if an image with this content is loaded, republishing a cleared one if needed. call with _Lock
+    
+    void _Gather(std::vector<std::pair<U64, String>>& symbols); // all symbols to write out, sorted by hash
+    
     SymbolTable* _Next = nullptr;
-    std::mutex _Lock{};
-    std::vector<String> _Table{};
-    std::map<U64, U32> _SortedHashed{}; // hash => index into _Table
+    std::mutex _Lock{}; // image loading and clearing
+    std::atomic<Image*> _Images{nullptr}; // newest first
+    std::vector<Image*> _RetiredImages{}; // cleared images. lock free readers may still be in them
+    OverlayShard _Overlay[NumOverlayShards];
+    Bool _Binary = false; // last map read in was binary
     
 };
 
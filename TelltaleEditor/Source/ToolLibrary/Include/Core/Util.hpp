@@ -243,6 +243,140 @@ public:
     auto get_cmp() { return this->comp; }
 };
 
+// Open addressing hash index, mapping a 64-bit hash (eg a symbol CRC64) to a U32 index into some array owned by the user.
+// Linear probing with a power of two capacity, kept at most half full. Keys should already be hashes, they are only mixed.
+class HashIndex
+{
+public:
+    
+    static constexpr U32 Invalid = (U32)-1;
+    
+    // Returns the index for the key, or Invalid
+    inline U32 Find(U64 key) const
+    {
+        if(_Count == 0)
+            return Invalid;
+        U64 mask = _Slots.size() - 1;
+        for(U64 slot = _Slot(key); ; slot = (slot + 1) & mask)
+        {
+            const Entry& entry = _Slots[slot];
+            if(entry.Index == Invalid)
+                return Invalid;
+            if(entry.Key == key)
+                return entry.Index;
+        }
+    }
+    
+    // Inserts the key, or replaces the index if it exists already
+    inline void Insert(U64 key, U32 index)
+    {
+        if((_Count + 1) * 2 > (U32)_Slots.size())
+            _Grow(std::max(16u, (U32)_Slots.size() * 2));
+        U64 mask = _Slots.size() - 1;
+        for(U64 slot = _Slot(key); ; slot = (slot + 1) & mask)
+        {
+            Entry& entry = _Slots[slot];
+            if(entry.Index == Invalid)
+            {
+                entry.Key = key;
+                entry.Index = index;
+                _Count++;
+                return;
+            }
+            if(entry.Key == key)
+            {
+                entry.Index = index;
+                return;
+            }
+        }
+    }
+    
+    // Removes the key, returning if it existed
+    inline Bool Remove(U64 key)
+    {
+        if(_Count == 0)
+            return false;
+        U64 mask = _Slots.size() - 1;
+        U64 slot = _Slot(key);
+        while(_Slots[slot].Key != key || _Slots[slot].Index == Invalid)
+        {
+            if(_Slots[slot].Index == Invalid)
+                return false;
+            slot = (slot + 1) & mask;
+        }
+        // backward shift the following entries in the run, so lookups don't need tombstones
+        for(U64 next = (slot + 1) & mask; _Slots[next].Index != Invalid; next = (next + 1) & mask)
+        {
+            U64 home = _Slot(_Slots[next].Key);
+            if(((next - home) & mask) >= ((next - slot) & mask))
+            {
+                _Slots[slot] = _Slots[next];
+                slot = next;
+            }
+        }
+        _Slots[slot].Index = Invalid;
+        _Count--;
+        return true;
+    }
+    
+    // Ensures N keys can be inserted without rehashing
+    inline void Reserve(U32 N)
+    {
+        U32 capacity = 16;
+        while(capacity < N * 2)
+            capacity <<= 1;
+        if(capacity > (U32)_Slots.size())
+            _Grow(capacity);
+    }
+    
+    inline void Clear()
+    {
+        _Slots.clear();
+        _Count = 0;
+    }
+    
+    inline U32 GetSize() const
+    {
+        return _Count;
+    }
+    
+private:
+    
+    struct Entry
+    {
+        U64 Key = 0;
+        U32 Index = Invalid; // Invalid if slot is empty
+    };
+    
+    inline U64 _Slot(U64 key) const
+    {
+        return ((key ^ (key >> 29)) * 0x9E3779B97F4A7C15ull) >> _Shift;
+    }
+    
+    inline void _Grow(U32 capacity)
+    {
+        std::vector<Entry> old = std::move(_Slots);
+        _Slots.assign(capacity, Entry{});
+        _Shift = 64;
+        while(capacity > 1)
+        {
+            capacity >>= 1;
+            _Shift--;
+        }
+        _Count = 0;
+        for(const Entry& entry: old)
+        {
+            if(entry.Index != Invalid)
+                Insert(entry.Key, entry.Index);
+        }
+    }
+    
+    std::vector<Entry> _Slots;
+    U32 _Count = 0;
+    U32 _Shift = 64;
+    
+};
+
 // ================================================ STRING UTIL ================================================
 
 inline String StringTrim(const String& str) {
@@ -14,6 +14,7 @@
 #include <sstream>
 #include <functional>
 #include <map>
+#include <unordered_map>
 
 // ======================================== PRE DECLARATIONS ========================================
 
@@ -121,10 +122,10 @@ namespace Meta
         Section Sect[STREAM_SECTION_COUNT];
         std::vector<U32> VersionInf; // vector of class IDs
         
-        // optional debug of reads. when reading if set outputs JSON-like
+        // optional debug of reads. when reading if set outputs JSON-like. set with SetDebugOutput, check IsDebugging before formatting anything.
         // IF THESE ARE PRESENT, NO ASYNC STUFF!
         DataStreamRef DebugOutputFile;
-        std::stringstream DebugOutput;
+        std::unique_ptr<std::stringstream> DebugOutput; // only allocated when debugging, normal reads do no string formatting
         U32 TabDepth = 0; // debug tab depth
         U32 MaxInlinableBuffer = UINT32_MAX;
         
@@ -140,10 +141,25 @@ namespace Meta
             return Sect[CurrentSection].Data->Read(Buffer, BufferLength);
         }
         
+        inline Bool IsDebugging() const
+        {
+            return DebugOutputFile.get() != nullptr;
+        }
+        
+        // Enables debug output into the given stream. Pass null to disable.
+        inline void SetDebugOutput(DataStreamRef file)
+        {
+            DebugOutputFile = std::move(file);
+            if(DebugOutputFile && !DebugOutput)
+                DebugOutput = std::make_unique<std::stringstream>();
+            else if(!DebugOutputFile)
+                DebugOutput.reset();
+        }
+        
         inline void WriteTabs()
         {
             for(U32 i = 0; i < TabDepth; i++)
-                DebugOutput << "    ";
+                *DebugOutput << "    ";
         }
         
     };
@@ -198,10 +214,15 @@ namespace Meta
     
     class ClassInstance;
     struct RegGame;
+    struct MemberHandle;
+    struct Class;
     
     // Weak reference to the parent. Deep into member trees, these point to the top level class, eg: array of materials , top level is D3DMesh
     using ParentWeakReference = WeakPtr<U8>;
     
+    // Native replacement for a script serialiser function. Instance is the instance being serialised (its memory is pInstance).
+    using NativeSerialiser = Bool (*)(Stream& stream, ClassInstance& instance, Class* clazz, void* pInstance, Bool IsWrite);
+    
     // A type class. This as well as Member are used internally. Refer to classes using the index (U32 - internal version CRC).
     // Refer to members by name string
     struct Class
@@ -246,6 +267,7 @@ namespace Meta
         // serialiser (needed for intrinsics/containers) function. iswrite if write, else reading.
         Bool (*Serialise)(Stream& stream, ClassInstance& host, Class* clazz, void* pInstance, Bool IsWrite) = nullptr;
         String SerialiseScriptFn = ""; // custom serialise overrider, function name in scripts
+        NativeSerialiser NativeSerialise = nullptr; // if the class opted into a native serialiser, this takes precedence over the script function
         
         String NormaliserStringFn = ""; // normalisation function
         String SpecialiserStringFn = ""; // specialiser function
@@ -253,6 +275,9 @@ namespace Meta
         // MEMBERS ARRAY
         std::vector<Member> Members;
         
+        // lower case member name CRC64 => index into Members. built at the end of game initialisation, empty while registering
+        std::unordered_map<U64, U32> MemberLookup;
+        
     };
     
     // compilsed serialisation script
@@ -310,6 +335,15 @@ namespace Meta
         
         String _PerformToString(U8* pMemory, Class* pClass);
         
+        // finds the member index from its lower case name CRC64 (symbol), or -1. uses the lookup tables once the game is initialised.
+        I32 _FindMember(Class* pClass, U64 nameHash);
+        
+        // adds library script source which is run in the library VM to the source hash, which class databases are checked against
+        void _AccumulateScriptSource(const String& source);
+        
+        // type erased hash which agrees with PerformEquality. combines into hash. returns false if the class cannot be hashed.
+        Bool _DoHash(Class* pClass, const U8* pMemory, U64& hash);
+        
         // for c++ controlled: host is empty. if script object: host MUST be a reference to a higher level parent.
         // if host argument is attachable, name can be specified and it will be appended to the child list for host
         // allocates but does not construct anything in the memory
@@ -332,6 +366,8 @@ namespace Meta
         
         Bool SerialiseSymbol(Stream& stream, ClassInstance& host, Class* clazz, void* pMemory, Bool IsWrite);
         
+        void _RegisterNativeSerialisers(); // built in native serialisers, in NativeSerialisers.cpp
+        
         // internal type defaults
         
         void CtorCol(void* pMemory, U32 Array, ParentWeakReference host);
@@ -475,6 +511,7 @@ namespace Meta
         friend class ClassInstanceScriptRef;
         
         friend ClassInstance GetMember(ClassInstance& inst, const String& name, Bool bInsist);
+        friend ClassInstance GetMember(ClassInstance& inst, const MemberHandle& member, Bool bInsist);
         
         friend ClassInstance _Impl::_MakeInstance(U32, ClassInstance&, Symbol, U8*, U32);
         
@@ -735,6 +772,7 @@ namespace Meta
         _COL_IS_SARRAY = 256, // is a SArray type
     };
     
+    // Returns true if lhs orders before rhs. Must be a strict weak ordering, see ClassInstanceCollection::Sort.
     using CollectionComparatorLess = Bool(void* user, Meta::ClassInstance lhs, Meta::ClassInstance rhs);
     
     // Both dynamic and static arrays, maps and other containers all use this type internally. (DCArray/SArray/Map/Set/Queue/...)
@@ -774,7 +812,25 @@ namespace Meta
         
         // Sorts the container. User data is passed to each comparator call.
         // THIS WILL COMPARE KEYS IF IT IS A KEYED COLLECTION. ELSE WILL COMPARE VALUES!
-        void Sort(void* user, CollectionComparatorLess* pComparator);
+        // O(n log n). Pass bStable as true to keep the relative order of elements which compare equal.
+        // The comparator must be a strict weak ordering (like operator<): never true for equal elements or both ways round, and transitive.
+        // Comparators such as <= or ones returning inconsistent results are undefined behaviour and can read outside the collection.
+        void Sort(void* user, CollectionComparatorLess* pComparator, Bool bStable = false);
+        
+        // ===== KEYED LOOKUP (Map/Set). Uses a lazily built hash index over the keys, which is rebuilt after the collection changes.
+        
+        // Finds the index of the given key, which must be of the key class. Returns -1 if not found or if this is not a keyed collection.
+        I32 Find(ClassInstance key);
+        
+        // Returns true if the given key exists in this keyed collection.
+        inline Bool Contains(ClassInstance key)
+        {
+            return Find(std::move(key)) != -1;
+        }
+        
+        // Replaces the value for the given key if it exists, else pushes the key value pair. Returns the index of the element.
+        // See Push for the copy arguments.
+        U32 InsertOrAssign(ClassInstance key, ClassInstance value, Bool bCopyKey, Bool bCopyVal);
         
         // Index must be less than size. Replaces. If copy is false, then that key or value is moved from the argument instead.
         void SetIndex(U32 index, ClassInstance key, ClassInstance value, Bool bCopyKey, Bool bCopyVal);
@@ -836,6 +892,9 @@ namespace Meta
         // state is updated
         void AdvanceTransienceFenceInternal();
         
+        // ensures the key index is up to date with the transience fence. returns false if the keys cannot be hashed or it is not needed
+        Bool UpdateKeyIndexInternal();
+        
         U32 _Size; // dynamic size of array
         U32 _Cap; // dynamic capacity of array (if SArray, not dynamic, this value is UINT32_MAX)
         
@@ -851,6 +910,11 @@ namespace Meta
         
         Ptr<std::atomic<U32>> _TransienceFence;
         
+        using KeyIndexMap = std::unordered_multimap<U64, U32>;
+        Ptr<KeyIndexMap> _KeyIndex; // key hash => element index, allocated on the first lookup of a keyed collection. only valid while the fence equals _KeyIndexFence
+        U32 _KeyIndexFence = 0; // transience fence value the key index was built at
+        Bool _KeyIndexValid = false;
+        
     };
     
     // INTERNAL USE FOR TOOL CONTEXT ONLY
@@ -944,6 +1008,11 @@ namespace Meta
     // Gets all meta class IDs
     std::vector<U32> GetClassIDs();
     
+    // Registers a native C++ serialiser under the given name. Classes opt into it in scripts by setting NativeSerialiser to the name
+    // when registering the class (normally the same name as its script Serialiser, which remains as the fallback).
+    // Must be called from the main thread while no game is active.
+    void RegisterNativeSerialiser(const String& name, NativeSerialiser fn);
+    
     // Returns if the given instance can have instances attached to it, using it passed into Create/Copy/Move Instance.
     Bool IsAttachable(ClassInstance& instance);
     
@@ -961,10 +1030,25 @@ namespace Meta
         return inst ? _Impl::_GetClass(inst.GetClassID())->TypeHash == Symbol(typeName) : false;
     }
     
+    // Precomputed member name, for hot paths which access the same member many times. Keep one around (eg static const) and pass
+    // it to GetMember instead of the string, which then skips hashing the name each call.
+    struct MemberHandle
+    {
+        
+        String Name;
+        U64 NameHash; // lower case CRC64 of the name, same as its symbol
+        
+        inline explicit MemberHandle(const String& name) : Name(name), NameHash(Symbol(name).GetCRC64()) {}
+        
+    };
+    
     // Gets a member of a complex type, ie a meta type (type is not intrinsic, can be, but for that prefer GetMember<T>).
     // Thread safe between game switches. If last argument is true, will error if not found
     ClassInstance GetMember(ClassInstance& inst, const String& name, Bool bInsist);
     
+    // See above. Uses the precomputed member name.
+    ClassInstance GetMember(ClassInstance& inst, const MemberHandle& member, Bool bInsist);
+    
     // Performs the less than operator '<' with the left and right hand side arguments (must be same type).
     Bool PerformLessThan(ClassInstance& lhs, ClassInstance& rhs);
     
@@ -981,25 +1065,30 @@ namespace Meta
     // or U32 (or equivalent) for Flags type, or the BinaryBuffer class defined above
     // Thread safe between game switches.
     template<typename T>
-    T& GetMember(ClassInstance& inst, const String& name)
+    T& GetMember(ClassInstance& inst, const MemberHandle& handle)
     {
         TTE_ASSERT(inst, "Instance is null");
         Class* pClass = _Impl::_GetClass(inst.GetClassID());
         
-        for(auto& member: pClass->Members)
+        I32 index = _Impl::_FindMember(pClass, handle.NameHash);
+        if(index != -1 && pClass->Members[index].Name == handle.Name) // Find matching member
         {
-            if(member.Name == name) // Find matching member
-            {
-                TTE_ASSERT(_Impl::_GetClass(member.ClassID)->Flags & CLASS_INTRINSIC || Is(inst, "class Symbol") || Is(inst, "class Flags")
-                           || Is(inst, "Symbol") || Is(inst, "Flags") || Is(inst, "__INTERNAL_BINARY_BUFFER__") || Is(inst, "__INTERNAL_DATASTREAM_CACHE__"),
-                           "GetMember<T> can only be used on intrinsic types!");
-                return *((T*)(inst._GetInternal() + member.RTOffset)); // Offset in memory, skip header.
-            }
+            Member& member = pClass->Members[index];
+            TTE_ASSERT(_Impl::_GetClass(member.ClassID)->Flags & CLASS_INTRINSIC || Is(inst, "class Symbol") || Is(inst, "class Flags")
+                       || Is(inst, "Symbol") || Is(inst, "Flags") || Is(inst, "__INTERNAL_BINARY_BUFFER__") || Is(inst, "__INTERNAL_DATASTREAM_CACHE__"),
+                       "GetMember<T> can only be used on intrinsic types!");
+            return *((T*)(inst._GetInternal() + member.RTOffset)); // Offset in memory, skip header.
         }
-        TTE_ASSERT(false, "Member %s::%s does not exist! Abort!!", pClass->Name.c_str(), name.c_str());
+        TTE_ASSERT(false, "Member %s::%s does not exist! Abort!!", pClass->Name.c_str(), handle.Name.c_str());
         return *((T*)FileNull()); // !! abort.
     }
     
+    template<typename T>
+    T& GetMember(ClassInstance& inst, const String& name)
+    {
+        return GetMember<T>(inst, MemberHandle{name});
+    }
+    
     inline Bool IsSymbolClass(const Class& clazz)
     {
         return CompareCaseInsensitive(clazz.Name, "class Symbol") || CompareCaseInsensitive(clazz.Name, "Symbol");
@@ -1017,14 +1106,8 @@ namespace Meta
         TTE_ASSERT(inst, "Instance is null");
         Class* pClass = _Impl::_GetClass(inst.GetClassID());
         
-        for(auto& member: pClass->Members)
-        {
-            if(member.Name == name) // Find matching member
-            {
-                return true;
-            }
-        }
-        return false;
+        I32 index = _Impl::_FindMember(pClass, Symbol(name).GetCRC64());
+        return index != -1 && pClass->Members[index].Name == name; // names are matched exactly here
     }
     
     const Class& GetClass(U32 id);
@@ -1040,17 +1123,63 @@ namespace Meta
     
     // ====================================================================================
     
+    // Hash of a (type hash, number) key, used by the class lookup tables
+    struct ClassLookupKeyHash
+    {
+        
+        inline size_t operator()(const std::pair<U64, U32>& key) const
+        {
+            return (size_t)(key.first ^ (0x9E3779B97F4A7C15ull * ((U64)key.second + 1)));
+        }
+        
+    };
+    
+    using ClassLookupTable = std::unordered_map<std::pair<U64, U32>, U32, ClassLookupKeyHash>;
+    
+    // Immutable lookup tables built at the end of InitGame. Empty while classes are being registered, lookups then fall back to scanning.
+    struct ClassLookupTables
+    {
+        
+        Bool Built = false;
+        ClassLookupTable ByToolTypeVersion{}; // (tool type hash, version number) => class id
+        ClassLookupTable ByTypeVersionCRC{}; // (type hash or tool type hash, version crc) => class id
+        ClassLookupTable ByExtension{}; // (lower case extension crc, version number) => class id
+        
+    };
+    
+    // Everything the registration scripts of a game snapshot produce. Stashed at a game switch and moved back into the state when
+    // switching to the same snapshot again, so the registration scripts only run once per snapshot. Not modified while stashed.
+    struct ClassDatabase
+    {
+        
+        U64 SourceHash = 0; // hash of the library scripts the classes were registered from. if they change, the database is dropped.
+        std::map<U32, Class> Classes{};
+        ClassLookupTables Lookup{};
+        std::map<Symbol, CompiledScript> Serialisers{};
+        std::map<Symbol, CompiledScript> Normalisers{};
+        std::map<Symbol, CompiledScript> Specialisers{};
+        CompiledScript Collector{};
+        String VersionCalcFun{};
+        
+    };
+    
     struct InternalState
     {
         std::vector<RegGame> Games{};
         std::map<U32, Class> Classes{};
+        ClassLookupTables Lookup{};
         std::map<Symbol, CompiledScript> Serialisers{}; // map of serialiser name => compiled script binary
         std::map<Symbol, CompiledScript> Normalisers{};
         std::map<Symbol, CompiledScript> Specialisers{};
+        std::map<Symbol, NativeSerialiser> NativeSerialisers{}; // registered from C++, not per game. classes opt in by name
         CompiledScript Collector{};
         I32 GameIndex = -1;
+        U32 Generation = 0; // bumped each game initialisation. lua serialiser references cached per VM by class ID are only valid within one
         String VersionCalcFun{}; // lua function which calculates version crc for a type.
         
+        std::map<String, ClassDatabase> Databases{}; // stashed class databases of previous snapshots, by snapshot key
+        U64 ScriptSourceHash = 0; // running hash of all library scripts run in the library VM
+        
         struct DeferredRegister
         {
             String KeyType, ValueType;
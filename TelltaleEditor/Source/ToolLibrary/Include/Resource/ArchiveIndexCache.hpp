@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Core/Config.hpp>
+#include <Resource/DataStream.hpp>
+#include <Resource/TTArchive.hpp>
+#include <Resource/TTArchive2.hpp>
+
+// Persistent on disk cache of archive file tables. Mounting a large archive parses its whole header, which for compressed and
+// encrypted ttarch2 files means inflating the file table and for old ttarch files walking every folder. The parsed tables are
+// written to a small index file in the cache directory and reused the next time the same unchanged archive is mounted.
+// Index files are keyed by the archive path and validated against the archive size, modification time, a checksum of the start
+// of the archive and the archive version of the current game. Anything that does not match is ignored and the archive is parsed again.
+namespace ArchiveIndexCache
+{
+    
+    // Tries to load the file table of the archive at the given disk path from the cache directory. Returns false if there is no valid
+    // index for it, in which case the archive must be read normally. The archive stream must be the stream of the archive at that path.
+    Bool Load(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, TTArchive& archive, U32 archiveVersion);
+    Bool Load(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, TTArchive2& archive, U32 archiveVersion);
+    
+    // Writes the index of the archive, which must have just been read from the archive stream, into the cache directory. Failure is not an error.
+    Bool Store(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, const TTArchive& archive, U32 archiveVersion);
+    Bool Store(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, const TTArchive2& archive, U32 archiveVersion);
+    
+}
@@ -3,6 +3,7 @@
 #include <Core/Config.hpp>
 
 // Singleton blowfish to manage encryption and decryption key (for each game). managed by main thread.
+// Each instance is an immutable context: the key schedule is computed once on construction, so it can be shared read only between threads.
 class Blowfish
 {
 public:
@@ -12,15 +13,21 @@ public:
     static void Shutdown();
     
     inline static Blowfish* GetInstance()
+    {
+        return Instance.get();
+    }
+    
+    // Shared reference to the game instance. Hold this in streams or jobs which may outlive a game switch.
+    inline static Ptr<const Blowfish> GetSharedInstance()
     {
         return Instance;
     }
     
-    // Encrypt the given buffer. THREAD SAFE between game Switches (job scheduler is reset)
-    void Encrypt(U8* Buffer, U32 BufferLength);
+    // Encrypt the given buffer. THREAD SAFE, the context is immutable.
+    void Encrypt(U8* Buffer, U32 BufferLength) const;
     
-    // Decrypt the given buffer. THREAD SAFE between game Switches (job scheduler is reset)
-    void Decrypt(U8* Buffer, U32 BufferLength);
+    // Decrypt the given buffer. THREAD SAFE, the context is immutable.
+    void Decrypt(U8* Buffer, U32 BufferLength) const;
     
     // Instance
     struct Cipher
@@ -29,13 +36,19 @@ public:
         U32 S[4][256];
         U32 P[18];
         
-        void Init(U8* Key, U32 KeyLength, Bool Modified); // init
+        // Round keys for Crypt, with the modified P index remapping already applied. 16 rounds followed by the 2 whitening keys.
+        U32 EncKeys[18];
+        U32 DecKeys[18];
+        
+        void Init(const U8* Key, U32 KeyLength, Bool Modified); // init, runs the key schedule
+        
+        void Crypt(Bool IsEncrypt, U8* Buffer, U32 BufferLength) const; // performs the (en/de)crypt
         
-        void Crypt(Bool IsEncrypt, Bool modified, U8* Buffer, U32 BufferLength); // performs the (en/de)crypt
+        void _Do(Bool enc, Bool modified, U32& lhs, U32& rhs) const; // enc=true encrypt, else decrypt. crypts a block. used in the key schedule.
         
-        void _Do(Bool enc, Bool modified, U32& lhs, U32& rhs); // enc=true encrypt, else decrypt. crypts a block.
+        void _DoScheduled(const U32* Keys, U32& lhs, U32& rhs) const; // crypts a block with precomputed round keys
         
-        U32 _DoRounds(U32);
+        U32 _DoRounds(U32) const;
         
     };
     
@@ -45,8 +58,8 @@ private:
     
     Bool _Modified; // use modified version of the encryption. endian swap on index 118 and some other changes. (newer games)
     U32 _KeyLength; // length in bytes of encryption key
-    U8 _Key[56];
+    Cipher _Cipher; // key schedule, computed in the constructor
     
-    static Blowfish* Instance;
+    static Ptr<Blowfish> Instance;
     
 };
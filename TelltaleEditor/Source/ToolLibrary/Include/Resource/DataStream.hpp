@@ -3,8 +3,10 @@
 #include <Core/Config.hpp>
 #include <Core/Symbol.hpp>
 #include <Resource/Compression.hpp>
+#include <Resource/Blowfish.hpp>
 #include <Scheduler/JobScheduler.hpp>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <vector>
@@ -118,6 +120,11 @@ public:
     
     virtual U64 GetPosition() = 0;
     
+    // Reads bytes at the given absolute offset into the output buffer, without using or moving the position of this stream.
+    // Streams which can do this without a shared cursor override it and are then safe to read concurrently (eg files, sub streams, containers).
+    // The default implementation seeks, reads and restores the position, so is no more thread safe than Read.
+    virtual Bool ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes);
+    
     // Gets the resource URL of this data stream.
     inline virtual const ResourceURL &GetURL() { return _ResourceLocation; }
     
@@ -141,20 +148,37 @@ public:
     
     virtual Bool Write(const U8 *InputBuffer, U64 Nbytes) override;
     
+    virtual Bool ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes) override;
+    
     virtual void SetPosition(U64 newPosition) override;
     
     virtual U64 GetPosition() override;
     
     virtual U64 GetSize() override;
     
+    // Maps the whole file into memory read-only, so reads become copies out of the mapping. Used for archives which are only read from.
+    // Any write to this stream drops the mapping again. Returns false if the platform or file could not be mapped (reads still work).
+    Bool MapReadOnly();
+    
+    // The read only mapping of the whole file once MapReadOnly succeeded, else null. Valid until the stream is written to or destroyed.
+    inline const U8* GetMapping() const
+    {
+        return _Mapping;
+    }
+    
     virtual ~DataStreamFile();
     
     DataStreamFile(const ResourceURL &url);
     
 protected:
     
+    void _Unmap();
+    
     U64 _Handle;
     U64 _MaxOffset; // if writing, the maximum offset written to. Ensures when flushing any bytes after this are cleared
+    U64 _Position; // our own cursor. all file IO is positional so the OS file position is never used
+    U8* _Mapping = nullptr; // read only mapping of the file, if mapped
+    U64 _MappingSize = 0;
     
     friend class DataStreamManager;
 };
@@ -167,6 +191,9 @@ public:
     
     virtual Bool Read(U8 *OutputBuffer, U64 Nbytes) override;
     
+    // Reads the pages directly. Thread safe if the sub class _SerialisePage is for reads.
+    virtual Bool ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes) override;
+    
     virtual Bool Write(const U8 *InputBuffer, U64 Nbytes) override;
     
     virtual void SetPosition(U64 newPosition) override;
@@ -215,6 +242,8 @@ class DataStreamBuffer : public DataStream
 public:
     virtual Bool Read(U8 *OutputBuffer, U64 Nbytes) override;
     
+    virtual Bool ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes) override;
+    
     virtual Bool Write(const U8 *InputBuffer, U64 Nbytes) override;
     
     // Provide more functionality to move around the seek position. NOTE: a value larger than the current size will expand the memory.
@@ -238,12 +267,15 @@ protected:
     friend class DataStreamManager;
 };
 
-// Sub Stream. Reads and writes to a subsection of the parent stream.
+// Sub Stream. Reads and writes to a subsection of the parent stream. Reads use the parent ReadAt, so sub streams of the same
+// parent each have their own position and can be read from different threads if the parent supports positional reads.
 class DataStreamSubStream : public DataStream
 {
 public:
     virtual Bool Read(U8 *OutputBuffer, U64 Nbytes) override;
     
+    virtual Bool ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes) override;
+    
     virtual Bool Write(const U8 *InputBuffer, U64 Nbytes) override;
     
     // Provide more functionality to move around the seek position. NOTE: a value larger than the current size will expand the memory.
@@ -253,6 +285,11 @@ public:
     
     inline virtual U64 GetSize() override { return _Size; }
     
+    // Offset of this section in the parent stream
+    inline U64 GetSectionOffset() const { return _BaseOff; }
+    
+    inline const DataStreamRef& GetParent() const { return _Prnt; }
+    
     virtual ~DataStreamSubStream();
     
 protected:
@@ -280,7 +317,7 @@ public:
     
 protected:
     
-    void _GetBlock(U32); // puts block into read back buffer, for given block index.
+    void _GetBlock(U32, U8* Rb); // puts block into read back buffer (at least block size bytes), for given block index.
     
     virtual Bool _SerialisePage(U64 index, U8 *Buffer, U64 Nbytes, U64 pageOffset, Bool IsWrite) override;
     
@@ -294,7 +331,7 @@ protected:
     
     U8 _RawFreq; // every how many blocks of data do we have an unencrypted block
     U8 _EncFreq; // every how many blocks of data do we have a blowfished block
-    U8 _Rb[0x100]; // read back buffer (temp) (max block size is 256)
+    Ptr<const Blowfish> _Blowfish; // game key schedule at creation, kept alive for this stream
     
     friend class DataStreamManager;
 };
@@ -316,6 +353,29 @@ protected:
 /// LZNA (rare, in some Batman archives). Note that all zlib compressed blocks have a negative block size (namely -15), meaning we raw compress it. The first byte of all compressed zlib streams
 /// in telltale games is the byte 0xEB.
 /// To write containers, use the flush container in the manager class below. Use this one to read from the stream with paged reads and a cached internally buffer.
+// Decompressed page cache counters for container streams. See DataStreamContainer::GetCacheStats.
+struct ContainerCacheStats
+{
+    U64 Hits = 0; // page reads served from a cached page
+    U64 Misses = 0; // page reads which had to read and decompress the page
+    U64 BytesInflated = 0; // total decompressed bytes, including read ahead
+    U64 ReadAheadPages = 0; // pages decompressed by read ahead jobs
+};
+
+struct _ContainerPageCache; // internal, see DataStream.cpp
+
+// Parsed container header. Lets a container stream be recreated over the same parent without reading its header again (eg from an archive index cache).
+struct ContainerLayout
+{
+    U64 Size = 0; // uncompressed size
+    U64 DataOffsetStart = 0;
+    U64 PageSize = 0;
+    U32 Compression = Compression::ZLIB;
+    Bool Compressed = false;
+    Bool Encrypted = false;
+    std::vector<U64> PageOffsets; // for compressed. last element is end of file offset
+};
+
 class DataStreamContainer : public DataStreamDeferred
 {
 public:
@@ -325,15 +385,7 @@ public:
     // return 0 if any error
     inline virtual U64 GetSize() override { return _Valid ? _Size : 0; }
     
-    inline virtual ~DataStreamContainer()
-    {
-        if(_CachedPage)
-            TTE_FREE(_CachedPage);
-        _CachedPage = nullptr;
-        if(_IntPage)
-            TTE_FREE(_IntPage);
-        _IntPage = nullptr;
-    }
+    inline virtual ~DataStreamContainer() = default; // page cache is shared with any pending read ahead jobs, freed when they finish
     
     // returns if valid
     inline Bool IsValid()
@@ -341,6 +393,21 @@ public:
         return _Valid;
     }
     
+    // Sets the maximum number of decompressed pages kept in the cache (at least 1), and the number of pages after a missed page
+    // which are decompressed ahead of time on the job scheduler (0 disables read ahead). Read ahead is capped below the page count.
+    void SetCacheParameters(U32 maxPages, U32 readAheadPages);
+    
+    // Gets the page cache statistics for this container. Zero if not compressed.
+    ContainerCacheStats GetCacheStats();
+    
+    // Gets the parsed header of this container. Only meaningful if valid.
+    ContainerLayout GetLayout() const;
+    
+    inline const DataStreamRef& GetParent() const
+    {
+        return _Prnt;
+    }
+    
 protected:
     
     virtual Bool _SerialisePage(U64 index, U8 *Buffer, U64 Nbytes, U64 pageOffset, Bool IsWrite) override;
@@ -348,16 +415,19 @@ protected:
     // Parent stream must be seekable.
     DataStreamContainer(const DataStreamRef &parent);
     
+    // Does not read anything from the parent, the layout must have come from GetLayout on a container over the same data.
+    DataStreamContainer(const DataStreamRef &parent, const ContainerLayout& layout);
+    
+    void _CreateCache(); // creates the page cache, once compressed info is known
+    
     DataStreamRef _Prnt; // parent stream we are reading from
     
     Compression::Type _Compression; // compression type
     Bool _Encrypted; // is encrypted
     Bool _Compressed; // is compressed
     Bool _Valid; // is valid
-    U64 _CachedPageIndex; // cached page buffer below
     U64 _DataOffsetStart; // compressed pages start or uncompressed data start
-    U8* _CachedPage = nullptr; // cached current page
-    U8* _IntPage = nullptr; // intermediate buffer for compression
+    Ptr<_ContainerPageCache> _Cache; // decompressed page LRU cache, only for compressed
     
     std::vector<U64> _PageOffsets; // for compressed. last element is end of file offset
     
@@ -400,6 +470,7 @@ protected:
     U32 _EncryptionMode = 0;
     U32 _EncryptionKeyLength = 0;
     Encryption _EncryptionType;
+    Ptr<const Blowfish> _Blowfish; // key schedule, for blowfish encryption types
     U32 _MaxReadLen = 0;
     U32 _CTRInitialBlock = 0;
     
@@ -554,6 +625,10 @@ public:
     // Creates a sub stream which reads from the specific part of the parent stream. The parent stream must be seekable (ie not network etc).
     DataStreamRef CreateSubStream(const DataStreamRef &parent, U64 offset, U64 size);
     
+    // If the stream is a sub stream, returns a new sub stream of the same section of the same parent with its own position. Else returns stream.
+    // Use when handing out archive file streams, so separate readers (eg on other threads) don't share a position.
+    DataStreamRef CreateSubStreamView(const DataStreamRef& stream);
+    
     // Creates a legacy encrypted reading stream for old meta streams. Only should be used by meta stream. Starts reading from base offset.
     // Base offset should be such that its after the magic (eg MBES) and you should pass in the correct block size and frequencies.
     DataStreamRef CreateLegacyEncryptedStream(const DataStreamRef& src, U64 baseOffset, U16 blockSize, U8 rawf, U8 blowf);
@@ -561,6 +636,18 @@ public:
     // Creates a wrapper container data stream. This is used for archives (.ttarch2), shaders and meta stream sections sometimes.
     DataStreamRef CreateContainerStream(const DataStreamRef& src);
     
+    // Creates a wrapper container data stream with an already known layout (see DataStreamContainer::GetLayout), skipping reading the header.
+    DataStreamRef CreateContainerStream(const DataStreamRef& src, const ContainerLayout& layout);
+    
+    // Sets the default page cache parameters for container streams created after this call. See DataStreamContainer::SetCacheParameters.
+    void SetContainerCacheDefaults(U32 maxPages, U32 readAheadPages);
+    
+    // Gets the page cache statistics accumulated over all container streams since initialisation or the last reset.
+    ContainerCacheStats GetContainerCacheStats();
+    
+    // Resets the accumulated container page cache statistics to zero.
+    void ResetContainerCacheStats();
+    
     // Creates a cached stream, such that all of src lies within memory, speeding up reads for smaller files. If src is already
     // a cached stream (DataStreamBuffer/Memory) then it return src
     DataStreamRef CreateCachedStream(const DataStreamRef& src);
@@ -639,5 +726,12 @@ private:
     std::map<String, Ptr<DataStreamMemory>> _Cache;
     std::mutex _CacheLock;
     
+    std::atomic<U32> _ContainerCachePages{4}; // default page cache size for new containers
+    std::atomic<U32> _ContainerReadAhead{0}; // default read ahead for new containers
+    std::atomic<U64> _ContainerHits{0}, _ContainerMisses{0}, _ContainerBytesInflated{0}, _ContainerReadAheadPages{0};
+    
+    friend struct _ContainerPageCache;
+    friend class DataStreamContainer;
+    
     static DataStreamManager *Instance;
 };
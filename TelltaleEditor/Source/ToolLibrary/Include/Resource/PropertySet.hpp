@@ -6,7 +6,9 @@
 #include <Resource/ResourceRegistry.hpp>
 
 #include <set>
+#include <mutex>
 #include <vector>
+#include <unordered_map>
 
 // Key callback override to pass in the key.
 struct LuaPropertyKeyCallback : LuaFunctionImpl<2>
@@ -76,12 +78,50 @@ public:
         
     };
     
+    struct SymbolHash
+    {
+        
+        inline size_t operator()(const Symbol& sym) const
+        {
+            return (size_t)sym.GetCRC64(); // already a hash
+        }
+        
+    };
+    
+    struct InternalData;
+    
+    // A property set visited while resolving inherited keys, and its state at the time.
+    struct ResolvedSet
+    {
+        Meta::ParentWeakReference Memory; // to detect the set being unloaded
+        InternalData* Data = nullptr; // null if the parent could not be resolved. it is retried on each lookup
+        const Meta::ClassChildMap* Keys = nullptr;
+        Symbol Name; // parent file name (empty for the set itself)
+        U32 Revision = 0;
+        U32 NumKeys = 0; // catches keys added or removed through the raw meta API
+    };
+    
+    struct ResolvedKey
+    {
+        Meta::ClassInstance Value; // value slot in the owning set
+        U32 Owner = 0; // index into ResolvedSets
+    };
+    
     struct InternalData
     {
         
         std::set<KeyCallbackTracked, KeyCallbackComparator> KeyCallbacks;
         std::vector<HandlePropertySet> Children;
         
+        // Flattened cache of the parent search for keys which are not local. Built on first access and rebuilt
+        // once this set or any set in ResolvedSets has changed revision (see MarkModified) or been unloaded, or
+        // a cached value is no longer the live value of its key (replaced through the raw meta API).
+        std::mutex ResolveLock; // guards the cache below, so lookups are thread safe between modifications
+        U32 Revision = 0;
+        Bool bResolved = false;
+        std::vector<ResolvedSet> ResolvedSets; // every set visited in search order, this set first
+        std::unordered_map<Symbol, ResolvedKey, SymbolHash> ResolvedKeys;
+        
         void Move(InternalData& dest);
         void Clone(InternalData& dest) const; // clones a copy into the dest.
         
@@ -154,7 +194,8 @@ public:
     static void AddParent(Meta::ClassInstance prop, Symbol parent, Ptr<ResourceRegistry> pRegistry);
     
     /**
-     Marks the given local property as modified.
+     Marks the given local property as modified. Any change to a property set not made through this API must call this, such that
+     this and all child property sets stop using their cached key resolution.
      */
     static void MarkModified(Meta::ClassInstance prop, Symbol Key, Ptr<ResourceRegistry> pRegistry);
     
@@ -275,4 +316,13 @@ private:
     
     static void AddChild(Meta::ClassInstance prop, HandlePropertySet hChild); // adds child
     
+    static void ResolveParentKeys(InternalData& data, Meta::ClassInstance prop, Ptr<ResourceRegistry>& pRegistry);
+    
+    static InternalData& ResolveKeys(Meta::ClassInstance prop, Ptr<ResourceRegistry>& pRegistry); // validates or rebuilds the resolved key cache. call with ResolveLock
+    
+    // looks up an inherited key in the resolved key cache, with the lock held. returns false if no parent has it
+    static Bool FindResolvedKey(Meta::ClassInstance prop, Symbol key, Ptr<ResourceRegistry>& pRegistry, Meta::ClassInstance* pOutValue, Symbol* pOutOwner);
+    
+    static void InvalidateResolvedKeys(Meta::ClassInstance prop); // bumps the revision
+    
 };
@@ -923,6 +923,12 @@ public:
      */
     void MountPlaystationPackage(const String& id, const String& fsPath, const String& packageKey);
     
+    /**
+     Sets the directory on disk where the parsed file tables of mounted .ttarch and .ttarch2 archives are cached. Mounting an archive which is already
+     cached and unchanged skips reading its header. The index files are validated against the archive so a stale one is never used. Pass an empty string to disable (default).
+     */
+    void SetArchiveIndexCache(const String& directory);
+    
     /**
      Creates a logical location in the resource system. In URLs, if they start with this name (it must start and end with <>'s), it will look into this location for the rest of the URL.
      You can later map other locations into this one. This is done in resource set scripts automagically.
@@ -1167,6 +1173,8 @@ private:
     
     std::set<String> _ErrorFiles; // reduce multi-log
     
+    String _ArchiveIndexCacheDirectory; // archive index cache directory, empty if disabled
+    
     // ========== INTERNAL FUNCTIONALITY
     
     Ptr<ResourceLocation> _Locate(const String& logicalName); // locate internal no lock
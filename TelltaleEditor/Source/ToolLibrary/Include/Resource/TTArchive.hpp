@@ -24,39 +24,90 @@ public:
     
     Bool SerialiseOut(DataStreamRef& in); // not intrinsically async. however, a job wrapping this can be used as it stays in this function
     
+    // Writes the file table of an archive read with SerialiseIn from the given archive stream, for the archive index cache. Returns false if the files don't all come from it.
+    Bool SerialiseIndexOut(DataStreamRef& out, const DataStreamRef& archiveStream) const;
+    
+    // Reads a file table written by SerialiseIndexOut, opening the files from the archive stream without parsing its header. The archive must be unchanged.
+    Bool SerialiseIndexIn(DataStreamRef& index, DataStreamRef& archiveStream);
+    
     // Returns the binary stream of the given file name symbol in this data archive.
     inline DataStreamRef Find(const Symbol& fn, String* outName) const
     {
-        FileInfo proxy{"", fn, DataStreamRef{}};
-        auto it = std::lower_bound(_Files.begin(), _Files.end(), proxy);
-        if(it != _Files.end() && it->NameSymbol == fn)
+        U32 index = _Index.Find(fn.GetCRC64());
+        if(index != HashIndex::Invalid)
         {
+            const FileInfo& file = _Files[index];
             if(outName)
-                *outName = it->Name;
-            it->Stream->SetPosition(0);
-            return it->Stream;
+                *outName = file.Name;
+            // own position per caller, so the same file can be opened and read from multiple threads
+            DataStreamRef stream = DataStreamManager::GetInstance()->CreateSubStreamView(file.Stream);
+            stream->SetPosition(0);
+            return stream;
         }
         return {};
     }
     
-    // Adds a file to this archive, replacing the old one.
+    // Adds a file to this archive, replacing the old one. Files are sorted when needed, ie on write.
     inline void AddFile(const String& name, DataStreamRef stream)
     {
         TTE_ASSERT(stream, "Stream not valid");
-        
-        // Check to replace any
-        for(auto& file : _Files)
+        Symbol sym{name};
+        U32 index = _Index.Find(sym.GetCRC64());
+        if(index != HashIndex::Invalid)
         {
-            if(Symbol(name) == Symbol(file.Name))
-            {
-                file.Stream = stream; // update to the new stream
-                return;
-            }
+            _Files[index].Stream = std::move(stream); // update to the new stream
+            return;
         }
         
         // Doesn't exist, add new entry
-        FileInfo inf{name, Symbol(name), std::move(stream)};
-        VectorInsertSorted(_Files, std::move(inf));
+        if(!_Files.empty() && sym < _Files.back().NameSymbol)
+            _Sorted = false;
+        _Index.Insert(sym.GetCRC64(), (U32)_Files.size());
+        _Files.push_back(FileInfo{name, sym, std::move(stream)});
+    }
+    
+    // Adds many files, replacing any existing ones. Prefer this when building large archives.
+    inline void AddFiles(std::vector<std::pair<String, DataStreamRef>>&& files)
+    {
+        _Files.reserve(_Files.size() + files.size());
+        _Index.Reserve((U32)(_Files.size() + files.size()));
+        for(auto& file: files)
+            AddFile(file.first, std::move(file.second));
+        files.clear();
+    }
+    
+    // Removes the file from this archive. Returns false if it does not exist.
+    inline Bool RemoveFile(const Symbol& fn)
+    {
+        U32 index = _Index.Find(fn.GetCRC64());
+        if(index == HashIndex::Invalid)
+            return false;
+        _Index.Remove(fn.GetCRC64());
+        U32 last = (U32)_Files.size() - 1;
+        if(index != last)
+        {
+            // move last into the gap
+            _Files[index] = std::move(_Files[last]);
+            _Index.Insert(_Files[index].NameSymbol.GetCRC64(), index);
+            _Sorted = false;
+        }
+        _Files.pop_back();
+        return true;
+    }
+    
+    // Renames the file in this archive. Returns false if it does not exist or the new name is taken.
+    inline Bool RenameFile(const Symbol& fn, const String& newName)
+    {
+        Symbol sym{newName};
+        U32 index = _Index.Find(fn.GetCRC64());
+        if(index == HashIndex::Invalid || _Index.Find(sym.GetCRC64()) != HashIndex::Invalid)
+            return false;
+        _Index.Remove(fn.GetCRC64());
+        _Index.Insert(sym.GetCRC64(), index);
+        _Files[index].Name = newName;
+        _Files[index].NameSymbol = sym;
+        _Sorted = false;
+        return true;
     }
     
     // Puts all file names inside this archive into the output result array
@@ -70,6 +121,8 @@ public:
     inline void Reset()
     {
         _Files.clear();
+        _Index.Clear();
+        _Sorted = true;
         _Folders.clear();
     }
     
@@ -107,7 +160,12 @@ private:
     };
     
     U32 _Version = 0; // version. game sets this version in the lua scripts. each version differs in format by a lot!
-    std::vector<FileInfo> _Files;
+    std::vector<FileInfo> _Files; // sorted by symbol only when _Sorted
+    HashIndex _Index; // file name symbol => index in _Files
+    Bool _Sorted = true;
+    
+    // Sorts files by name symbol (archives are written sorted for binary searches in the game) and rebuilds the index.
+    void _SortFiles();
     std::vector<String> _Folders; // folder names
     
 };
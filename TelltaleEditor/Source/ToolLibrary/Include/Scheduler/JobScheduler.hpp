@@ -6,16 +6,17 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <queue>
 #include <thread>
 #include <vector>
 
-// Number of worker threads
-#define NUM_SCHEDULER_THREADS 8
-// Interval for Wait functions in MS
-#define WAIT_INTERNVAL_MS 30
+// Maximum number of worker threads. The actual number is chosen at JobScheduler::Initialise
+#define MAX_SCHEDULER_THREADS 64
+// Interval in MS at which worker threads in Wait look for the awaited jobs in the queues to run them themselves. Completion always wakes waiters immediately.
+#define WAIT_HELP_INTERVAL_MS 1
 
 /// <summary>
 ///
@@ -203,6 +204,7 @@ struct JobCounter
     JobResult Result = JOB_RESULT_NONE; // Result of the job
     U32 *PostIncrement = NULL;          // Used in Wait(multiple jobs). Internally used to count how many jobs left to finish.
     JobResult *PostResult = NULL;       // If non-null, when job finishes if it failed then this is assigned to FAIL such that Wait knows the result.
+    std::condition_variable *PostNotify = NULL; // If non-null, notified when the job finishes (or is cancelled). The waiting thread sleeps on it.
     Bool SchedulerReleased =
     false; // When the Refs is decremented internally, this gets set to true - meaning the job is only tracked by external JobHandles
 };
@@ -271,6 +273,22 @@ struct JobList
     }
 };
 
+/// <summary>
+/// Used internally. Each worker thread owns one of these. Jobs posted from a worker thread go into its own queue and jobs posted from
+/// other threads are spread over all the queues. Workers which run out of jobs steal from the other queues.
+/// Each priority has its own FIFO, so higher priority jobs are always taken first. Pinned jobs (with an affinity override) are never stolen.
+/// </summary>
+struct JobWorkerQueue
+{
+    
+    std::mutex Lock; // Protects the job deques
+    std::deque<Job> Jobs[JOB_PRIORITY_COUNT]; // Jobs any worker can run
+    std::deque<Job> Pinned[JOB_PRIORITY_COUNT]; // Jobs which must run on this worker
+    std::atomic<U32> NumJobs[JOB_PRIORITY_COUNT]{}; // Size of each Jobs deque, read without the lock by stealing workers
+    std::atomic<U32> NumPinned{0}; // Total pinned jobs
+    
+};
+
 /// <summary>
 /// JobScheduler. This is very similar to Telltale Games' JobScheduler.
 /// Written by Lucas (did I put that there?)
@@ -281,9 +299,9 @@ public:
     
     /// <summary>
     /// Constructor to initialise the system and spawn threads.
-    /// This version takes in a set of registration functions for each worker thread lua state.
+    /// This version takes in a set of registration functions for each worker thread lua state, and the number of worker threads (0 for default, see Initialise).
     /// </summary>
-    JobScheduler(LuaFunctionCollection&& jobThreadFunctions);
+    JobScheduler(LuaFunctionCollection&& jobThreadFunctions, U32 numThreads = 0);
     
     /// <summary>
     /// Constructor to initialise the system and spawn threads.
@@ -311,7 +329,8 @@ public:
     
     /// <summary>
     /// Attempts to make this thread wait for the given job to finish. Returns the result of the job.
-    /// Returns RESULT_NONE if the job has already finished (ie invalid).
+    /// Returns RESULT_NONE if the job has already finished (ie invalid), or CANCELLED if it was cancelled while waiting.
+    /// The waiting thread is woken as soon as the job finishes. If called from a worker thread and the job has not started yet, it is run here.
     /// Do not call this multiple times on different threads. Only call once or multiple times on same thread.
     /// </summary>
     JobResult Wait(const JobHandle &job);
@@ -350,7 +369,7 @@ public:
     
     inline U32 GetNumWorkerThreads() const
     {
-        return NUM_SCHEDULER_THREADS;
+        return _numThreads;
     }
     
     /// <summary>
@@ -367,9 +386,10 @@ public:
     // Singleton Init/Shutdown.
     
     /**
-     Initialises the job scheduler with the given function collection to register to each thread local lua manage (state)
+     Initialises the job scheduler with the given function collection to register to each thread local lua manage (state).
+     Pass the number of worker threads to spawn, or 0 to use the hardware concurrency (at least 2, so jobs can wait on other jobs).
      */
-    static void Initialise(LuaFunctionCollection Col = {});
+    static void Initialise(LuaFunctionCollection Col = {}, U32 numThreads = 0);
     
     /**
      Shutsdown the job scheduler
@@ -397,9 +417,25 @@ private:
     void _Shutdown(Bool bKillAwaiting);
     
     /// <summary>
-    /// Internal: Signal a JobThread that a job has been posted and it should wake up
+    /// Internal: Signal sleeping job threads that jobs have been posted and they should wake up. If any pinned jobs were posted, all are woken
+    /// as the pinned worker must be one of them.
+    /// </summary>
+    void _SignalJobThread(U32 numSignals = 1, Bool bPinned = false);
+    
+    /// <summary>
+    /// Internal: Pushes a job into the given worker queue, or the queue of its affinity override. Does not signal. Returns true if it was pinned.
     /// </summary>
-    void _SignalJobThread(U32 numSignals = 1);
+    Bool _PushJob(Job&& job, U32 queueIndex);
+    
+    /// <summary>
+    /// Internal: Gets the queue to push new jobs into. Workers use their own queue, other threads spread jobs over all of them.
+    /// </summary>
+    U32 _SelectQueue();
+    
+    /// <summary>
+    /// Internal: Pops the highest priority job for the given worker, from its own queue or stolen from another. Returns false if none.
+    /// </summary>
+    Bool _FetchJob(U32 threadIndex, Job& outJob);
     
     /// <summary>
     /// Internal: Wait a job thread until a signal is posted if argument is true. Returns the wait result, ie if we are still running or should exit.
@@ -462,22 +498,32 @@ private:
     void _MakeJob(U32 jobID, Job &job, JobDescriptor &descriptor, I32 affinityOverride = -1);
     
     /// <summary>
-    /// Interally used by Wait. Checks the return value of the job (result). First argument is used for assertions.
+    /// Interally used by Wait. Sleeps until numFinished reaches numWaitingOn, which jobs increment under the alive jobs lock as they finish.
+    /// Worker threads run any of the given jobs which have not started yet themselves instead of only sleeping.
     /// </summary>
-    void _PerformWaitCheck(Bool bFirstIt, U32 jobID, JobResult &outResult);
+    void _WaitForCounters(U32 N, const JobHandle *pJobHandles, U32 &numFinished, U32 numWaitingOn, std::condition_variable &cond);
+    
+    /// <summary>
+    /// Internal: If any of the given sorted job IDs are waiting in a queue this worker thread can run from, takes one and runs it (and its
+    /// enqueued jobs) on this thread. Returns if one was run.
+    /// </summary>
+    Bool _RunAwaitedJob(const std::vector<U32> &sortedJobIDs);
     
     /// <summary>
     /// Used internally by Cancel to reduce duplicated code
     /// </summary>
     void _CancelRemoveJob(const JobHandle &hJob, Bool cancelQueued);
     
-    hacked_priority_queue<Job> _pendingJobs;
-    std::mutex _jobsLock; // Jobs array protector.
+    U32 _numThreads; // Number of worker threads
+    
+    std::vector<Ptr<JobWorkerQueue>> _queues; // One per worker thread. Each queue lock is inferior to the alive jobs lock.
+    std::atomic<U32> _numStealable; // Total jobs over all queues which any worker can run (not pinned, not enqueued)
+    std::atomic<U32> _nextQueue; // Round robin queue selection for posts from non worker threads
     
-    // These 3 variables create a semaphore used to signal job threads.
+    // These 3 variables are used to sleep and wake idle job threads.
     std::mutex _jobThreadNotifierLock;              // Mutex. Takes priority over all other mutexes in this class
     std::condition_variable _jobThreadNotifierCond; // Allows thread notification and waiting
-    U32 _jobThreadNotifierCount;                    // Semaphore counter. Number of PENDING jobs - matched to pending jobs (not enqueued!!)
+    std::atomic<U32> _numSleeping;                  // Number of job threads sleeping or about to sleep. Posting only notifies if any are.
     
     std::atomic<Bool> _running; // true if we are currently running, false otherwise. cancelJobs is protected by this atomic by acq/rel, order matters
     // (this one first)
@@ -491,7 +537,7 @@ private:
     
     std::mutex _aliveJobsLock; // Protects counters and enqueued jobs.
     
-    std::thread _workers[NUM_SCHEDULER_THREADS];
+    std::vector<std::thread> _workers;
     
     LuaFunctionCollection _workerScriptCollection; // Worker threads use this at initialisation
     
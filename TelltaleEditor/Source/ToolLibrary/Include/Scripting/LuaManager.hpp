@@ -3,6 +3,7 @@
 #include <Core/Config.hpp>
 
 #include <atomic>
+#include <unordered_map>
 
 class DataStream;
 
@@ -92,6 +93,10 @@ public:
     // Set lock context to true such that the context cannot be modified during this call from scripts, ensuring eg TTE_Switch fails.
     void CallFunction(U32 Nargs, U32 Nresults, Bool LockContext);
     
+    // Calls the function referenced in the registry (see RefReg) with the Nargs arguments on the stack, such that the function itself is not
+    // pushed first. Otherwise the same as CallFunction.
+    void CallReference(I32 ref, U32 Nargs, U32 Nresults, Bool LockContext);
+    
     // Loads a lua chunk, isCompiled being if its complied else source, into the Lua VM.
     Bool LoadChunk(const String& nm, const U8* chunk, U32 chunkSizeBytes, LoadChunkMode);
     
@@ -111,6 +116,13 @@ public:
     // Creates and returns a reference, in the registry table, for the object at the top of the stack (and pops the object).
     I32 RefReg();
     
+    // Gets a registry reference cached in this VM by SetCachedReference for the key (eg a class ID), or -1 if there is none.
+    // If generation differs from the generation the cached references were made in, they are all released first.
+    I32 GetCachedReference(U32 key, U32 generation);
+    
+    // Caches the registry reference for the key, for the generation last passed to GetCachedReference. The cache now owns the reference.
+    void SetCachedReference(U32 key, I32 ref);
+    
     // Runs the garbage collector
     void GC();
     
@@ -266,6 +278,9 @@ private:
     
     I32 _ConstantMetaTables[(I32)LuaConstantMetaTable::NUM]{};
     
+    std::unordered_map<U32, I32> _CachedRefs; // see GetCachedReference
+    U32 _CachedRefsGeneration = 0;
+    
     friend class LuaManagerRef;
     
     LuaManagerPointerSlot* _WeakRefSlot = nullptr;
@@ -362,6 +377,8 @@ public:
     
     virtual void CallFunction(U32 Nargs, U32 Nresults) = 0;
     
+    virtual void CallReference(I32 ref, U32 Nargs, U32 Nresults) = 0;
+    
     virtual Bool CheckStack(U32 extra) = 0;
     
     //type being 999 means env, 888 means integer
@@ -454,6 +471,8 @@ public:
     
     virtual void CallFunction(U32 Nargs, U32 Nresults) override;
     
+    virtual void CallReference(I32 ref, U32 Nargs, U32 Nresults) override;
+    
     virtual Bool CheckStack(U32 extra) override;
     
     virtual void Push(LuaType type, void* pValue) override;
@@ -539,6 +558,8 @@ public:
     
     virtual void CallFunction(U32 Nargs, U32 Nresults) override;
     
+    virtual void CallReference(I32 ref, U32 Nargs, U32 Nresults) override;
+    
     virtual Bool CheckStack(U32 extra) override;
     
     virtual void Push(LuaType type, void* pValue) override;
@@ -624,6 +645,8 @@ public:
     
     virtual void CallFunction(U32 Nargs, U32 Nresults) override;
     
+    virtual void CallReference(I32 ref, U32 Nargs, U32 Nresults) override;
+    
     virtual Bool CheckStack(U32 extra) override;
     
     virtual void Push(LuaType type, void* pValue) override;
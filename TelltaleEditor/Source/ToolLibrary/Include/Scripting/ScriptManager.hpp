@@ -89,6 +89,7 @@ namespace ScriptManager
         man.PushLString(name);
         man.Insert(-2);
         man.SetTable(-3, bRaw);//table,key,val
+        man.Pop(1); // env
     }
     
     // Registers (overrides if existing) a function collection (ie system of functions) to the lua environment.
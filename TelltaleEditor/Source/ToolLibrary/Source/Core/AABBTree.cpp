@@ -0,0 +1,283 @@
+#include <Core/AABBTree.hpp>
+
+// ===================================================================         HELPERS
+// ===================================================================
+
+static inline BoundingBox _Union(const BoundingBox& a, const BoundingBox& b)
+{
+    BoundingBox r{};
+    r._Min = Vector3(MIN(a._Min.x, b._Min.x), MIN(a._Min.y, b._Min.y), MIN(a._Min.z, b._Min.z));
+    r._Max = Vector3(MAX(a._Max.x, b._Max.x), MAX(a._Max.y, b._Max.y), MAX(a._Max.z, b._Max.z));
+    return r;
+}
+
+// half surface area, the cost of a node
+static inline Float _Cost(const BoundingBox& b)
+{
+    Float dx = b._Max.x - b._Min.x, dy = b._Max.y - b._Min.y, dz = b._Max.z - b._Min.z;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+static inline Bool _Contains(const BoundingBox& outer, const BoundingBox& inner)
+{
+    return outer._Min.x <= inner._Min.x && outer._Min.y <= inner._Min.y && outer._Min.z <= inner._Min.z
+        && outer._Max.x >= inner._Max.x && outer._Max.y >= inner._Max.y && outer._Max.z >= inner._Max.z;
+}
+
+// ===================================================================         PROXIES
+// ===================================================================
+
+I32 AABBTree::CreateProxy(const BoundingBox& box, void* userData)
+{
+    I32 proxy = _AllocateNode();
+    TreeNode& node = _Nodes[proxy];
+    node.Bounds._Min = box._Min - Vector3(_Margin, _Margin, _Margin);
+    node.Bounds._Max = box._Max + Vector3(_Margin, _Margin, _Margin);
+    node.UserData = userData;
+    node.Height = 0;
+    _InsertLeaf(proxy);
+    _NumProxies++;
+    return proxy;
+}
+
+void AABBTree::DestroyProxy(I32 proxy)
+{
+    TTE_ASSERT(IsProxy(proxy), "Invalid AABB tree proxy");
+    _RemoveLeaf(proxy);
+    _FreeNode(proxy);
+    _NumProxies--;
+}
+
+Bool AABBTree::MoveProxy(I32 proxy, const BoundingBox& box)
+{
+    TTE_ASSERT(IsProxy(proxy), "Invalid AABB tree proxy");
+    BoundingBox fat{};
+    fat._Min = box._Min - Vector3(_Margin, _Margin, _Margin);
+    fat._Max = box._Max + Vector3(_Margin, _Margin, _Margin);
+
+    const BoundingBox& current = _Nodes[proxy].Bounds;
+    if(_Contains(current, box))
+    {
+        // still fits. only reinsert if the leaf has become much too loose (eg object shrank or moved back), else queries get sloppy
+        BoundingBox loose{};
+        loose._Min = box._Min - Vector3(4.0f * _Margin, 4.0f * _Margin, 4.0f * _Margin);
+        loose._Max = box._Max + Vector3(4.0f * _Margin, 4.0f * _Margin, 4.0f * _Margin);
+        if(_Contains(loose, current))
+            return false;
+    }
+
+    _RemoveLeaf(proxy);
+    _Nodes[proxy].Bounds = fat;
+    _InsertLeaf(proxy);
+    return true;
+}
+
+void AABBTree::Clear()
+{
+    _Nodes.clear();
+    _Root = _FreeList = Null;
+    _NumProxies = 0;
+}
+
+// ===================================================================         TREE
+// ===================================================================
+
+I32 AABBTree::_AllocateNode()
+{
+    I32 index;
+    if(_FreeList != Null)
+    {
+        index = _FreeList;
+        _FreeList = _Nodes[index].Parent;
+    }
+    else
+    {
+        index = (I32)_Nodes.size();
+        _Nodes.emplace_back();
+    }
+    TreeNode& node = _Nodes[index];
+    node = TreeNode{};
+    node.Height = 0;
+    return index;
+}
+
+void AABBTree::_FreeNode(I32 node)
+{
+    _Nodes[node].Parent = _FreeList;
+    _Nodes[node].Height = -1;
+    _Nodes[node].UserData = nullptr;
+    _FreeList = node;
+}
+
+void AABBTree::_InsertLeaf(I32 leaf)
+{
+    if(_Root == Null)
+    {
+        _Root = leaf;
+        _Nodes[leaf].Parent = Null;
+        return;
+    }
+
+    // find the best sibling, by descending into the child with the cheapest increase in surface area (branch and bound would be tighter, but this is good enough)
+    BoundingBox leafBox = _Nodes[leaf].Bounds;
+    I32 index = _Root;
+    while(_Nodes[index].Height > 0)
+    {
+        const TreeNode& node = _Nodes[index];
+        Float area = _Cost(node.Bounds);
+        Float combinedArea = _Cost(_Union(node.Bounds, leafBox));
+
+        Float cost = 2.0f * combinedArea; // cost of making a new parent here
+        Float inheritance = 2.0f * (combinedArea - area); // minimum cost of pushing the leaf further down
+
+        Float childCost[2]{};
+        I32 children[2] = {node.Child1, node.Child2};
+        for(U32 i = 0; i < 2; i++)
+        {
+            const TreeNode& child = _Nodes[children[i]];
+            BoundingBox merged = _Union(leafBox, child.Bounds);
+            if(child.Height == 0)
+                childCost[i] = _Cost(merged) + inheritance;
+            else
+                childCost[i] = _Cost(merged) - _Cost(child.Bounds) + inheritance;
+        }
+
+        if(cost < childCost[0] && cost < childCost[1])
+            break;
+        index = childCost[0] < childCost[1] ? children[0] : children[1];
+    }
+
+    // new parent for the sibling and the leaf
+    I32 sibling = index;
+    I32 oldParent = _Nodes[sibling].Parent;
+    I32 newParent = _AllocateNode();
+    {
+        TreeNode& parent = _Nodes[newParent];
+        parent.Parent = oldParent;
+        parent.Bounds = _Union(leafBox, _Nodes[sibling].Bounds);
+        parent.Height = _Nodes[sibling].Height + 1;
+        parent.Child1 = sibling;
+        parent.Child2 = leaf;
+    }
+
+    if(oldParent != Null)
+    {
+        if(_Nodes[oldParent].Child1 == sibling)
+            _Nodes[oldParent].Child1 = newParent;
+        else
+            _Nodes[oldParent].Child2 = newParent;
+    }
+    else
+    {
+        _Root = newParent;
+    }
+    _Nodes[sibling].Parent = newParent;
+    _Nodes[leaf].Parent = newParent;
+
+    // walk back up, refitting and balancing
+    index = _Nodes[leaf].Parent;
+    while(index != Null)
+    {
+        index = _Balance(index);
+        TreeNode& node = _Nodes[index];
+        node.Height = 1 + MAX(_Nodes[node.Child1].Height, _Nodes[node.Child2].Height);
+        node.Bounds = _Union(_Nodes[node.Child1].Bounds, _Nodes[node.Child2].Bounds);
+        index = node.Parent;
+    }
+}
+
+void AABBTree::_RemoveLeaf(I32 leaf)
+{
+    if(leaf == _Root)
+    {
+        _Root = Null;
+        return;
+    }
+
+    I32 parent = _Nodes[leaf].Parent;
+    I32 grandParent = _Nodes[parent].Parent;
+    I32 sibling = _Nodes[parent].Child1 == leaf ? _Nodes[parent].Child2 : _Nodes[parent].Child1;
+
+    if(grandParent != Null)
+    {
+        // replace the parent with the sibling
+        if(_Nodes[grandParent].Child1 == parent)
+            _Nodes[grandParent].Child1 = sibling;
+        else
+            _Nodes[grandParent].Child2 = sibling;
+        _Nodes[sibling].Parent = grandParent;
+        _FreeNode(parent);
+
+        I32 index = grandParent;
+        while(index != Null)
+        {
+            index = _Balance(index);
+            TreeNode& node = _Nodes[index];
+            node.Bounds = _Union(_Nodes[node.Child1].Bounds, _Nodes[node.Child2].Bounds);
+            node.Height = 1 + MAX(_Nodes[node.Child1].Height, _Nodes[node.Child2].Height);
+            index = node.Parent;
+        }
+    }
+    else
+    {
+        _Root = sibling;
+        _Nodes[sibling].Parent = Null;
+        _FreeNode(parent);
+    }
+    _Nodes[leaf].Parent = Null;
+}
+
+// Rotates node A if its children heights differ by more than one. Returns the new root of the subtree.
+I32 AABBTree::_Balance(I32 iA)
+{
+    TreeNode& A = _Nodes[iA];
+    if(A.Height < 2)
+        return iA;
+
+    I32 iB = A.Child1, iC = A.Child2;
+    I32 balance = _Nodes[iC].Height - _Nodes[iB].Height;
+
+    // rotate the taller child up. both cases are symmetric, so express it once with the taller (up) and shorter (other) children
+    if(balance > 1 || balance < -1)
+    {
+        I32 iUp = balance > 1 ? iC : iB;
+        I32 iOther = balance > 1 ? iB : iC;
+        TreeNode& Up = _Nodes[iUp];
+        I32 iF = Up.Child1, iG = Up.Child2;
+
+        // swap A and Up
+        Up.Child1 = iA;
+        Up.Parent = A.Parent;
+        A.Parent = iUp;
+
+        if(Up.Parent != Null)
+        {
+            if(_Nodes[Up.Parent].Child1 == iA)
+                _Nodes[Up.Parent].Child1 = iUp;
+            else
+                _Nodes[Up.Parent].Child2 = iUp;
+        }
+        else
+        {
+            _Root = iUp;
+        }
+
+        // the taller grandchild stays under Up, the other moves to A in the place of Up
+        I32 iKeep = _Nodes[iF].Height > _Nodes[iG].Height ? iF : iG;
+        I32 iMove = iKeep == iF ? iG : iF;
+        Up.Child2 = iKeep;
+        if(balance > 1)
+            A.Child2 = iMove;
+        else
+            A.Child1 = iMove;
+        _Nodes[iMove].Parent = iA;
+
+        A.Bounds = _Union(_Nodes[iOther].Bounds, _Nodes[iMove].Bounds);
+        A.Height = 1 + MAX(_Nodes[iOther].Height, _Nodes[iMove].Height);
+        Up.Bounds = _Union(A.Bounds, _Nodes[iKeep].Bounds);
+        Up.Height = 1 + MAX(A.Height, _Nodes[iKeep].Height);
+        return iUp;
+    }
+
+    return iA;
+}
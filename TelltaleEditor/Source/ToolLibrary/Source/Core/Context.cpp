@@ -92,12 +92,12 @@ Ptr<ResourceRegistry> ToolContext::CreateResourceRegistry(Bool bAttachAll)
     
     if(bAttachAll)
     {
-        JobHandle Handles[NUM_SCHEDULER_THREADS];
+        std::vector<JobHandle> Handles(JobScheduler::Instance->GetNumWorkerThreads());
         JobDescriptor desc{};
         desc.AsyncFunction = &_AsyncAttachRegistry;
         desc.UserArgA = registry.get();
         desc.Priority = JOB_PRIORITY_HIGHEST;
-        for(I32 i = 0; i < NUM_SCHEDULER_THREADS; i++)
+        for(I32 i = 0; i < (I32)Handles.size(); i++)
         {
             Handles[i] = JobScheduler::Instance->Post(desc, i);
         }
@@ -5,6 +5,8 @@
 #include <dlfcn.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
 
 void ThreadSleep(U64 milliseconds)
 {
@@ -76,19 +78,81 @@ Bool FileRead(U64 Handle, U8 *Buffer, U64 Nbytes)
     return bytes_read == (ssize_t)Nbytes;
 }
 
-U64 FileSize(U64 Handle)
+Bool FileReadAt(U64 Handle, U64 Offset, U8 *Buffer, U64 Nbytes)
 {
-    int f = (int)Handle;
+    int fd = (int)Handle;
+
+    while (Nbytes)
+    {
+        ssize_t bytes_read = pread(fd, Buffer, (size_t)Nbytes, (off_t)Offset);
+        if (bytes_read == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            TTE_ASSERT(false, "Could not read from file");
+            return false;
+        }
+        if (bytes_read == 0)
+            return false; // end of file
+        Buffer += bytes_read;
+        Offset += (U64)bytes_read;
+        Nbytes -= (U64)bytes_read;
+    }
+
+    return true;
+}
 
-    off_t cur = lseek(f, 0, SEEK_CUR);
-    TTE_ASSERT(cur != (off_t)-1, "Could not seek in file to cache offset");
+Bool FileWriteAt(U64 Handle, U64 Offset, const U8 *Buffer, U64 Nbytes)
+{
+    int fd = (int)Handle;
 
-    off_t size = lseek(f, 0, SEEK_END);
-    TTE_ASSERT(size != (off_t)-1, "Could not seek in file to end offset");
+    while (Nbytes)
+    {
+        ssize_t bytes_written = pwrite(fd, Buffer, (size_t)Nbytes, (off_t)Offset);
+        if (bytes_written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            TTE_ASSERT(false, "Could not write to file");
+            return false;
+        }
+        Buffer += bytes_written;
+        Offset += (U64)bytes_written;
+        Nbytes -= (U64)bytes_written;
+    }
 
-    TTE_ASSERT(lseek(f, cur, SEEK_SET) != (off_t)-1, "Could not re-seek to cache offset");
+    return true;
+}
 
-    return (U64)size;
+U8* FileMapReadOnly(U64 Handle, U64 Size)
+{
+    if (Size == 0)
+        return nullptr;
+    void* region = mmap(nullptr, (size_t)Size, PROT_READ, MAP_SHARED, (int)Handle, 0);
+    if (region == MAP_FAILED)
+    {
+        TTE_LOG("Could not map file => posix err %d", errno);
+        return nullptr;
+    }
+    (void)madvise(region, (size_t)Size, MADV_RANDOM); // archive reads jump around, don't read ahead too aggressively
+    return (U8*)region;
+}
+
+void FileUnmap(U8* Mapping, U64 Size)
+{
+    if (Mapping)
+        munmap(Mapping, (size_t)Size);
+}
+
+U64 FileSize(U64 Handle)
+{
+    struct stat st{};
+    if (fstat((int)Handle, &st) == -1)
+    {
+        TTE_ASSERT(false, "Could not stat file to get its size");
+        return 0;
+    }
+    return (U64)st.st_size;
 }
 
 U64 FileNull() { return 0x0000'0000'FFFF'FFFFull; }
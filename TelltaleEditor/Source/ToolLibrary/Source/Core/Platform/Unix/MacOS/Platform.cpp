@@ -7,6 +7,7 @@
 #include <errno.h>
 #include <dlfcn.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 
 // THREAD
 
@@ -75,19 +76,80 @@ Bool FileRead(U64 Handle, U8* Buffer, U64 Nbytes)
     return bytes_read == (ssize_t)Nbytes;
 }
 
-U64 FileSize(U64 Handle)
+Bool FileReadAt(U64 Handle, U64 Offset, U8* Buffer, U64 Nbytes)
 {
-    int f = (int)Handle;
+    int fd = (int)Handle;
     
-    off_t cur = lseek(f, 0, SEEK_CUR);
-    TTE_ASSERT(cur != (off_t)-1, "Could not seek in file to cache offset");
+    while (Nbytes)
+    {
+        ssize_t bytes_read = pread(fd, Buffer, (size_t)Nbytes, (off_t)Offset);
+        if (bytes_read == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            TTE_ASSERT(false, "Could not read from file");
+            return false;
+        }
+        if (bytes_read == 0)
+            return false; // end of file
+        Buffer += bytes_read;
+        Offset += (U64)bytes_read;
+        Nbytes -= (U64)bytes_read;
+    }
     
-    off_t size = lseek(f,0,SEEK_END);
-    TTE_ASSERT(size != (off_t)-1, "Could not seek in file to end offset");
+    return true;
+}
+
+Bool FileWriteAt(U64 Handle, U64 Offset, const U8* Buffer, U64 Nbytes)
+{
+    int fd = (int)Handle;
     
-    TTE_ASSERT(lseek(f, cur, SEEK_SET) != (off_t)-1, "Could not re-seek to cache offset");
+    while (Nbytes)
+    {
+        ssize_t bytes_written = pwrite(fd, Buffer, (size_t)Nbytes, (off_t)Offset);
+        if (bytes_written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            TTE_ASSERT(false, "Could not write to file");
+            return false;
+        }
+        Buffer += bytes_written;
+        Offset += (U64)bytes_written;
+        Nbytes -= (U64)bytes_written;
+    }
     
-    return (U64)size;
+    return true;
+}
+
+U8* FileMapReadOnly(U64 Handle, U64 Size)
+{
+    if (Size == 0)
+        return nullptr;
+    void* region = mmap(nullptr, (size_t)Size, PROT_READ, MAP_SHARED, (int)Handle, 0);
+    if (region == MAP_FAILED)
+    {
+        TTE_LOG("Could not map file => posix err %d", errno);
+        return nullptr;
+    }
+    return (U8*)region;
+}
+
+void FileUnmap(U8* Mapping, U64 Size)
+{
+    if (Mapping)
+        munmap(Mapping, (size_t)Size);
+}
+
+U64 FileSize(U64 Handle)
+{
+    struct stat st{};
+    if (fstat((int)Handle, &st) == -1)
+    {
+        TTE_ASSERT(false, "Could not stat file to get its size");
+        return 0;
+    }
+    return (U64)st.st_size;
 }
 
 U64 FileNull()
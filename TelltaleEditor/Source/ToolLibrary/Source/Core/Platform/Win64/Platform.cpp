@@ -117,17 +117,86 @@ Bool FileRead(U64 Handle, U8 *Buffer, U64 Nbytes)
     return bytes_read == Nbytes;
 }
 
-U64 FileSize(U64 Handle)
+Bool FileReadAt(U64 Handle, U64 Offset, U8 *Buffer, U64 Nbytes)
 {
-    HANDLE hFile = (HANDLE)Handle;
-    LARGE_INTEGER cur{0};
-    LARGE_INTEGER size{0};
+    HANDLE file = (HANDLE)Handle;
+
+    // Synchronous handle with an explicit offset: reads from Offset regardless of (and without relying on) the file pointer
+    OVERLAPPED ov{};
+    ov.Offset = (DWORD)(Offset & 0xFFFFFFFFull);
+    ov.OffsetHigh = (DWORD)(Offset >> 32);
+
+    DWORD bytes_read{0};
+    BOOL success = ReadFile(file, Buffer, (DWORD)Nbytes, &bytes_read, &ov);
+
+    if (!success)
+    {
+        TTE_ASSERT(false, "Could not read from file. Windows error: %d", GetLastError());
+        return false;
+    }
+
+    return bytes_read == Nbytes;
+}
+
+Bool FileWriteAt(U64 Handle, U64 Offset, const U8 *Buffer, U64 Nbytes)
+{
+    HANDLE file = (HANDLE)Handle;
+
+    OVERLAPPED ov{};
+    ov.Offset = (DWORD)(Offset & 0xFFFFFFFFull);
+    ov.OffsetHigh = (DWORD)(Offset >> 32);
+
+    DWORD bytes_written = 0;
+    BOOL success = WriteFile(file, Buffer, (DWORD)Nbytes, &bytes_written, &ov);
+
+    if (!success)
+    {
+        TTE_ASSERT(false, "Could not write to file. Windows error: %d", GetLastError());
+        return false;
+    }
+
+    return bytes_written == Nbytes;
+}
+
+U8* FileMapReadOnly(U64 Handle, U64 Size)
+{
+    if (Size == 0)
+        return nullptr;
+
+    HANDLE mapping = CreateFileMappingW((HANDLE)Handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+    {
+        TTE_LOG("Could not create file mapping. Windows error: %d", GetLastError());
+        return nullptr;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)Size);
+    CloseHandle(mapping); // the view keeps the mapping object alive
 
-    TTE_ASSERT(SetFilePointerEx(hFile, LARGE_INTEGER{0}, &cur, FILE_CURRENT), "Could not get current file pointer offset");
+    if (view == nullptr)
+    {
+        TTE_LOG("Could not map view of file. Windows error: %d", GetLastError());
+        return nullptr;
+    }
 
-    TTE_ASSERT(SetFilePointerEx(hFile, LARGE_INTEGER{0}, &size, FILE_END), "Could not seek to file end offset");
+    return (U8*)view;
+}
+
+void FileUnmap(U8* Mapping, U64 Size)
+{
+    if (Mapping)
+        UnmapViewOfFile(Mapping);
+}
 
-    TTE_ASSERT(SetFilePointerEx(hFile, cur, nullptr, FILE_BEGIN), "Could not restore file pointer to original offset");
+U64 FileSize(U64 Handle)
+{
+    LARGE_INTEGER size{0};
+
+    if (!GetFileSizeEx((HANDLE)Handle, &size))
+    {
+        TTE_ASSERT(false, "Could not get file size. Windows error: %d", GetLastError());
+        return 0;
+    }
 
     return (U64)size.QuadPart;
 }
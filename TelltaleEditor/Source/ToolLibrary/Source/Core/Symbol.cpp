@@ -5,6 +5,8 @@
 #include <sstream>
 #include <iomanip>
 #include <cstdint>
+#include <algorithm>
+#include <cstring>
 
 std::vector<std::pair<CString, CString>>& GetPropKeyConstants()
 {
@@ -26,27 +28,225 @@ Symbol::Symbol(CString s, Bool bRegisterSymbolMap, CString konst) : Symbol(Strin
 
 // Standard CRC32 and CRC64 routines and tables.
 
-U64 CRC64(const U8 *Buffer, U32 BufferLength, U64 InitialCRC64)
+// CRC64 is MSB first (not reflected), zero initial value and no final xor. Its used for every symbol, so has a few fast paths:
+// slicing by 8 (8 table lookups per 8 bytes), and on x86-64 CPUs with carry-less multiply (PCLMULQDQ) longer buffers are folded
+// 64 bytes at a time in four independent 128 bit lanes, which are then merged and the remaining whole 16 byte blocks folded in.
+// Both give bit identical results to the byte at a time table loop, which handles the remaining bytes.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TTE_CRC64_CLMUL 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CLMUL_TARGET
+#else
+#define CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#endif
+#endif
+
+namespace
 {
-    for (U32 i = 0; i < BufferLength; i++)
+    
+    constexpr U64 CRC64_Poly = 0x42F0E1EBA9EA3693ull; // ECMA-182, without the x^64 term
+    
+    // slicing tables. Table[0] is the standard table, Table[k] is Table[0] followed by k zero bytes. Generated at compile time, so
+    // static initialisation order does not matter (symbols are created during static initialisation).
+    struct CRC64SliceTables
     {
-        InitialCRC64 = CRC64_Table[((U32)(InitialCRC64 >> 56) ^ Buffer[i]) & 0xFF] ^ (InitialCRC64 << 8);
+        U64 Table[8][256];
+        
+        constexpr CRC64SliceTables() : Table{}
+        {
+            for(U32 i = 0; i < 256; i++)
+            {
+                U64 crc = (U64)i << 56;
+                for(U32 bit = 0; bit < 8; bit++)
+                    crc = (crc & 0x8000000000000000ull) ? (crc << 1) ^ CRC64_Poly : (crc << 1);
+                Table[0][i] = crc;
+            }
+            for(U32 k = 1; k < 8; k++)
+            {
+                for(U32 i = 0; i < 256; i++)
+                    Table[k][i] = (Table[k - 1][i] << 8) ^ Table[0][Table[k - 1][i] >> 56];
+            }
+        }
+    };
+    
+    constexpr CRC64SliceTables CRC64_Slice{};
+    
+    // x^N mod P, for the fold constants
+    constexpr U64 CRC64_XPowMod(U32 N)
+    {
+        U64 r = 1;
+        for(U32 i = 0; i < N; i++)
+            r = (r & 0x8000000000000000ull) ? (r << 1) ^ CRC64_Poly : (r << 1);
+        return r;
     }
-    return InitialCRC64;
-}
-
-U64 CRC64LowerCase(const U8 *Buffer, U32 BufferLength, U64 InitialCRC64)
-{
-    for (U32 i = 0; i < BufferLength; i++)
+    
+    inline U64 LoadBigEndian64(const U8* p)
+    {
+        return ((U64)p[0] << 56) | ((U64)p[1] << 48) | ((U64)p[2] << 40) | ((U64)p[3] << 32) |
+               ((U64)p[4] << 24) | ((U64)p[5] << 16) | ((U64)p[6] << 8) | (U64)p[7];
+    }
+    
+    // sets bit 5 of any bytes in [A,Z], 8 at a time. bytes with the top bit set are left alone.
+    inline U64 FoldLowerCase64(U64 w)
+    {
+        U64 heptets = w & 0x7F7F7F7F7F7F7F7Full;
+        U64 geA = heptets + 0x3F3F3F3F3F3F3F3Full; // top bit set if byte >= 'A'
+        U64 gtZ = heptets + 0x2525252525252525ull; // top bit set if byte > 'Z'
+        U64 upper = (geA ^ gtZ) & ~w & 0x8080808080808080ull;
+        return w | (upper >> 2);
+    }
+    
+    inline U8 FoldLowerCase8(U8 letter)
     {
         // In lower case, bit 6 is set (0x20).
-        U8 letter = Buffer[i];
         if (letter >= 0x41 && letter <= 0x5A) //[A,Z]
             letter |= 0x20;
+        return letter;
+    }
+    
+    template<Bool LowerCase>
+    inline U64 CRC64Bytes(const U8* Buffer, U64 BufferLength, U64 crc)
+    {
+        for (U64 i = 0; i < BufferLength; i++)
+        {
+            U8 letter = LowerCase ? FoldLowerCase8(Buffer[i]) : Buffer[i];
+            crc = CRC64_Table[((U32)(crc >> 56) ^ letter) & 0xFF] ^ (crc << 8);
+        }
+        return crc;
+    }
+    
+    template<Bool LowerCase>
+    inline U64 CRC64Slice8(const U8* Buffer, U64 BufferLength, U64 crc)
+    {
+        const auto& T = CRC64_Slice.Table;
+        while(BufferLength >= 8)
+        {
+            U64 word = LoadBigEndian64(Buffer);
+            if(LowerCase)
+                word = FoldLowerCase64(word);
+            crc ^= word;
+            crc = T[7][crc >> 56] ^ T[6][(crc >> 48) & 0xFF] ^ T[5][(crc >> 40) & 0xFF] ^ T[4][(crc >> 32) & 0xFF] ^
+                  T[3][(crc >> 24) & 0xFF] ^ T[2][(crc >> 16) & 0xFF] ^ T[1][(crc >> 8) & 0xFF] ^ T[0][crc & 0xFF];
+            Buffer += 8;
+            BufferLength -= 8;
+        }
+        return CRC64Bytes<LowerCase>(Buffer, BufferLength, crc);
+    }
+    
+#ifdef TTE_CRC64_CLMUL
+    
+    // Only worth it for longer buffers. Symbols are mostly short names, which go through slicing.
+    constexpr U64 CRC64_ClmulMinLength = 128;
+    
+    // fold constants: moving a 128 bit accumulator forward by N bytes multiplies it by x^(8N). high qword gets x^(8N+64) mod P, low x^(8N) mod P.
+    constexpr U64 CRC64_K16Hi = CRC64_XPowMod(192), CRC64_K16Lo = CRC64_XPowMod(128);
+    constexpr U64 CRC64_K32Hi = CRC64_XPowMod(320), CRC64_K32Lo = CRC64_XPowMod(256);
+    constexpr U64 CRC64_K48Hi = CRC64_XPowMod(448), CRC64_K48Lo = CRC64_XPowMod(384);
+    constexpr U64 CRC64_K64Hi = CRC64_XPowMod(576), CRC64_K64Lo = CRC64_XPowMod(512);
+    
+    Bool CRC64HasClmul()
+    {
+#ifdef _MSC_VER
+        int info[4]{};
+        __cpuid(info, 1);
+        return (info[2] & (1 << 1)) && (info[2] & (1 << 9)); // PCLMULQDQ and SSSE3
+#else
+        return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#endif
+    }
+    
+    CLMUL_TARGET inline __m128i ClmulLoad(const U8* p, Bool LowerCase)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        if(LowerCase)
+        {
+            __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+            v = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+        }
+        // byte reverse, so the first byte is the most significant (MSB first CRC)
+        return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+    
+    CLMUL_TARGET inline __m128i ClmulFold(__m128i acc, U64 kHi, U64 kLo)
+    {
+        __m128i k = _mm_set_epi64x((long long)kHi, (long long)kLo);
+        return _mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x11), _mm_clmulepi64_si128(acc, k, 0x00));
+    }
+    
+    // Folds the buffer into a 128 bit remainder congruent (mod P) to the buffer polynomial, then finishes with the tables.
+    template<Bool LowerCase>
+    CLMUL_TARGET U64 CRC64Clmul(const U8* Buffer, U64 BufferLength, U64 crc)
+    {
+        // initial crc is the same as xoring into the first 8 bytes
+        __m128i init = _mm_set_epi64x((long long)crc, 0);
+        __m128i a0 = _mm_xor_si128(ClmulLoad(Buffer, LowerCase), init);
+        __m128i a1 = ClmulLoad(Buffer + 16, LowerCase);
+        __m128i a2 = ClmulLoad(Buffer + 32, LowerCase);
+        __m128i a3 = ClmulLoad(Buffer + 48, LowerCase);
+        Buffer += 64;
+        BufferLength -= 64;
         
-        InitialCRC64 = CRC64_Table[((U32)(InitialCRC64 >> 56) ^ letter) & 0xFF] ^ (InitialCRC64 << 8);
+        // four independent lanes, 64 bytes at a time
+        while(BufferLength >= 64)
+        {
+            a0 = _mm_xor_si128(ClmulFold(a0, CRC64_K64Hi, CRC64_K64Lo), ClmulLoad(Buffer, LowerCase));
+            a1 = _mm_xor_si128(ClmulFold(a1, CRC64_K64Hi, CRC64_K64Lo), ClmulLoad(Buffer + 16, LowerCase));
+            a2 = _mm_xor_si128(ClmulFold(a2, CRC64_K64Hi, CRC64_K64Lo), ClmulLoad(Buffer + 32, LowerCase));
+            a3 = _mm_xor_si128(ClmulFold(a3, CRC64_K64Hi, CRC64_K64Lo), ClmulLoad(Buffer + 48, LowerCase));
+            Buffer += 64;
+            BufferLength -= 64;
+        }
+        
+        // combine lanes
+        __m128i acc = _mm_xor_si128(ClmulFold(a0, CRC64_K48Hi, CRC64_K48Lo), ClmulFold(a1, CRC64_K32Hi, CRC64_K32Lo));
+        acc = _mm_xor_si128(acc, ClmulFold(a2, CRC64_K16Hi, CRC64_K16Lo));
+        acc = _mm_xor_si128(acc, a3);
+        
+        while(BufferLength >= 16)
+        {
+            acc = _mm_xor_si128(ClmulFold(acc, CRC64_K16Hi, CRC64_K16Lo), ClmulLoad(Buffer, LowerCase));
+            Buffer += 16;
+            BufferLength -= 16;
+        }
+        
+        // the crc of the remainder bytes (zero initial value) is the crc of everything so far
+        U8 remainder[16];
+        U64 hi = (U64)_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)), lo = (U64)_mm_cvtsi128_si64(acc);
+        for(U32 i = 0; i < 8; i++)
+        {
+            remainder[i] = (U8)(hi >> (56 - 8 * i));
+            remainder[8 + i] = (U8)(lo >> (56 - 8 * i));
+        }
+        crc = CRC64Slice8<false>(remainder, 16, 0);
+        return CRC64Slice8<LowerCase>(Buffer, BufferLength, crc);
     }
-    return InitialCRC64;
+    
+#endif
+    
+    template<Bool LowerCase>
+    inline U64 CRC64Dispatch(const U8* Buffer, U64 BufferLength, U64 crc)
+    {
+#ifdef TTE_CRC64_CLMUL
+        static const Bool HasClmul = CRC64HasClmul();
+        if(BufferLength >= CRC64_ClmulMinLength && HasClmul)
+            return CRC64Clmul<LowerCase>(Buffer, BufferLength, crc);
+#endif
+        return CRC64Slice8<LowerCase>(Buffer, BufferLength, crc);
+    }
+    
+}
+
+U64 CRC64(const U8 *Buffer, U32 BufferLength, U64 InitialCRC64)
+{
+    return CRC64Dispatch<false>(Buffer, BufferLength, InitialCRC64);
+}
+
+U64 CRC64LowerCase(const U8 *Buffer, U32 BufferLength, U64 InitialCRC64)
+{
+    return CRC64Dispatch<true>(Buffer, BufferLength, InitialCRC64);
 }
 
 U32 CRC32(const U8 *Buffer, U32 BufferLength, U32 InitialCRC32)
@@ -95,110 +295,304 @@ String SymbolToHexString(Symbol sym)
 
 // SYMBOL TABLE
 
+#define SYMBOL_IMAGE_MAGIC 0x4D595354 // 'TSYM'
+#define SYMBOL_IMAGE_FORMAT 1 // bump when the binary layout changes
+
+// Binary symbol map header. Followed by the sorted entries, then the blob.
+struct SymbolImageHeader
+{
+    U32 Magic;
+    U32 Format;
+    U32 NumEntries;
+    U32 Reserved;
+    U64 BlobSize;
+    U64 ContentHash; // CRC64 of the entries and blob
+};
+
+static_assert(sizeof(SymbolImageHeader) == 32, "Symbol image header must be packed");
+
+static U64 _HashSymbolString(const char* str, U32 length)
+{
+    if(length >= 6 && memcmp(str, "CRC32:", 6) == 0)
+        return (U64)CRC32((const U8*)str + 6, length - 6);
+    return CRC64LowerCase((const U8*)str, length);
+}
+
+// runtime property names, in which there are absolutely LOADS. not written out.
+static Bool _IsRuntimePropertyName(const String& str)
+{
+    return (StringStartsWith(str, "\"") && StringEndsWith(str, " Properties")) || StringEndsWith(str, "Mesh Properties");
+}
+
+SymbolTable::SymbolTable(Bool bPrivate)
+{
+    static_assert(sizeof(ImageEntry) == 16, "Symbol image entries must be packed");
+    if(!bPrivate)
+    {
+        _Next = _ActiveTables;
+        _ActiveTables = this;
+    }
+}
+
+SymbolTable::~SymbolTable()
+{
+    for(Image* pImage = _Images.exchange(nullptr); pImage;)
+    {
+        Image* pNext = pImage->Next;
+        delete pImage;
+        pImage = pNext;
+    }
+    for(Image* pImage: _RetiredImages)
+        delete pImage;
+    _RetiredImages.clear();
+}
+
+const SymbolTable::ImageEntry* SymbolTable::_FindInImages(Symbol sym, const Image*& pImage) const
+{
+    U64 hash = sym.GetCRC64();
+    for(const Image* pCur = _Images.load(std::memory_order_acquire); pCur; pCur = pCur->Next)
+    {
+        const ImageEntry* pEnd = pCur->Entries + pCur->NumEntries;
+        const ImageEntry* it = std::lower_bound(pCur->Entries, pEnd, hash, [](const ImageEntry& entry, U64 h) { return entry.Hash < h; }); // BINARY SEARCH
+        if(it != pEnd && it->Hash == hash && (U64)it->Offset + it->Length <= pCur->BlobSize)
+        {
+            pImage = pCur;
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+void SymbolTable::_Publish(Image* pImage)
+{
+    pImage->Next = _Images.load(std::memory_order_relaxed);
+    _Images.store(pImage, std::memory_order_release);
+}
+
+Bool SymbolTable::_ReviveImage(U64 contentHash)
+{
+    for(const Image* pLoaded = _Images.load(std::memory_order_relaxed); pLoaded; pLoaded = pLoaded->Next)
+    {
+        if(pLoaded->ContentHash == contentHash)
+            return true;
+    }
+    // eg the game symbols are cleared and the same map loaded again when switching game. images are never modified, so publish it again
+    for(auto it = _RetiredImages.begin(); it != _RetiredImages.end(); it++)
+    {
+        if((*it)->ContentHash == contentHash)
+        {
+            Image* pImage = *it;
+            _RetiredImages.erase(it);
+            _Publish(pImage);
+            return true;
+        }
+    }
+    return false;
+}
+
 void SymbolTable::SerialiseIn(DataStreamRef& stream)
 {
     TTE_ASSERT(IsCallingFromMain(), "Can only be called on main thread");
-    if(stream->GetSize() == 0)
+    U64 size = stream ? stream->GetSize() : 0;
+    if(size == 0)
         return; // empty file
+    std::lock_guard<std::mutex> _L{_Lock};
     
-    // read total file into string stream.
-    std::istringstream ss{};
-    U8* temp = TTE_ALLOC(stream->GetSize() + 1, MEMORY_TAG_TEMPORARY);
-    temp[stream->GetSize()] = 0; // null terminator for string
-    stream->Read(temp, stream->GetSize());
-    ss.str((CString)temp);
-    TTE_FREE(temp);
+    SymbolImageHeader header{};
+    if(size >= sizeof(SymbolImageHeader) && stream->ReadAt(0, (U8*)&header, sizeof(SymbolImageHeader)) && header.Magic == SYMBOL_IMAGE_MAGIC)
+    {
+        if(header.Format != SYMBOL_IMAGE_FORMAT || header.BlobSize > 0xFFFF'FFFFull
+           || sizeof(SymbolImageHeader) + (U64)header.NumEntries * sizeof(ImageEntry) + header.BlobSize != size)
+        {
+            TTE_LOG("WARNING: Binary symbol map is an unknown version or is corrupt. Ignoring it");
+            return;
+        }
+        _Binary = true;
+        if(_ReviveImage(header.ContentHash))
+            return; // already loaded
+        Image* pImage = new Image();
+        const U8* pData = nullptr;
+        DataStreamFile* pFile = dynamic_cast<DataStreamFile*>(stream.get());
+        if(pFile && pFile->MapReadOnly())
+        {
+            pData = pFile->GetMapping();
+            pImage->MappedStream = stream;
+        }
+        else
+        {
+            pImage->OwnedMemory.resize(size);
+            if(!stream->ReadAt(0, pImage->OwnedMemory.data(), size))
+            {
+                TTE_LOG("WARNING: Could not read binary symbol map");
+                delete pImage;
+                return;
+            }
+            pData = pImage->OwnedMemory.data();
+        }
+        pImage->Entries = (const ImageEntry*)(pData + sizeof(SymbolImageHeader));
+        pImage->NumEntries = header.NumEntries;
+        pImage->Blob = (const char*)(pImage->Entries + header.NumEntries);
+        pImage->BlobSize = header.BlobSize;
+        pImage->ContentHash = header.ContentHash;
+        _Publish(pImage);
+        return;
+    }
     
-    // keep reading lines
-    for (String line; std::getline(ss, line);)
+    // text. the lines are used in place as the blob
+    _Binary = false;
+    Image* pImage = new Image();
+    pImage->OwnedMemory.resize(size);
+    if(!stream->ReadAt(0, pImage->OwnedMemory.data(), size) || size > 0xFFFF'FFFFull)
+    {
+        TTE_LOG("WARNING: Could not read symbol map");
+        delete pImage;
+        return;
+    }
+    const char* pText = (const char*)pImage->OwnedMemory.data();
+    pImage->ContentHash = CRC64((const U8*)pText, (U32)size);
+    if(_ReviveImage(pImage->ContentHash))
     {
-        if(line.length())
-            Register(line);
+        delete pImage;
+        return; // already loaded
     }
+    std::vector<ImageEntry>& entries = pImage->OwnedEntries;
+    for(U64 lineStart = 0; lineStart < size;)
+    {
+        const char* pLineEnd = (const char*)memchr(pText + lineStart, '\n', (size_t)(size - lineStart));
+        U64 lineEnd = pLineEnd ? (U64)(pLineEnd - pText) : size;
+        if(lineEnd > lineStart)
+            entries.push_back(ImageEntry{_HashSymbolString(pText + lineStart, (U32)(lineEnd - lineStart)), (U32)lineStart, (U32)(lineEnd - lineStart)});
+        lineStart = lineEnd + 1;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const ImageEntry& lhs, const ImageEntry& rhs) { return lhs.Hash < rhs.Hash; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const ImageEntry& lhs, const ImageEntry& rhs) { return lhs.Hash == rhs.Hash; }), entries.end());
+    pImage->Entries = entries.data();
+    pImage->NumEntries = (U32)entries.size();
+    pImage->Blob = pText;
+    pImage->BlobSize = size;
+    _Publish(pImage);
 }
 
-void SymbolTable::SerialiseOut(DataStreamRef& stream)
+void SymbolTable::_Gather(std::vector<std::pair<U64, String>>& symbols)
 {
-    TTE_ASSERT(IsCallingFromMain(), "Can only be called on main thread");
-    std::lock_guard<std::mutex> _L{_Lock};
-    std::ostringstream ss{};
-    for(auto& str: _Table)
+    for(const Image* pImage = _Images.load(std::memory_order_acquire); pImage; pImage = pImage->Next)
     {
-        if(str.length())
+        for(U32 i = 0; i < pImage->NumEntries; i++)
         {
-            // skip runtime property names, in which there are absolutely LOADS.
-            if((StringStartsWith(str, "\"") && StringEndsWith(str, " Properties")) || StringEndsWith(str, "Mesh Properties"))
-                continue;
-            ss << str << "\n";
+            const ImageEntry& entry = pImage->Entries[i];
+            if((U64)entry.Offset + entry.Length <= pImage->BlobSize)
+                symbols.emplace_back(entry.Hash, String(pImage->Blob + entry.Offset, entry.Length));
         }
     }
+    for(OverlayShard& shard: _Overlay)
+    {
+        std::shared_lock<std::shared_mutex> _R{shard.Lock};
+        for(const auto& str: shard.Strings)
+            symbols.emplace_back(str.first, str.second);
+    }
+    std::stable_sort(symbols.begin(), symbols.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    symbols.erase(std::unique(symbols.begin(), symbols.end(), [](const auto& lhs, const auto& rhs) { return lhs.first == rhs.first; }), symbols.end());
+    symbols.erase(std::remove_if(symbols.begin(), symbols.end(), [](const auto& sym) { return _IsRuntimePropertyName(sym.second); }), symbols.end());
+}
+
+void SymbolTable::SerialiseOut(DataStreamRef& stream)
+{
+    TTE_ASSERT(IsCallingFromMain(), "Can only be called on main thread");
+    std::vector<std::pair<U64, String>> symbols{};
+    _Gather(symbols);
+    std::ostringstream ss{};
+    for(auto& sym: symbols)
+        ss << sym.second << "\n";
     String str = ss.str();
     stream->Write((const U8*)str.c_str(), (U64)str.length());
 }
 
-SymbolTable::SymbolTable(Bool bPrivate)
+void SymbolTable::SerialiseOutBinary(DataStreamRef& stream)
 {
-    if(!bPrivate)
+    TTE_ASSERT(IsCallingFromMain(), "Can only be called on main thread");
+    std::vector<std::pair<U64, String>> symbols{};
+    _Gather(symbols);
+    std::vector<ImageEntry> entries{};
+    entries.reserve(symbols.size());
+    String blob{};
+    for(auto& sym: symbols)
     {
-        _Next = _ActiveTables;
-        _ActiveTables = this;
+        entries.push_back(ImageEntry{sym.first, (U32)blob.length(), (U32)sym.second.length()});
+        blob += sym.second;
     }
+    TTE_ASSERT(blob.length() <= 0xFFFF'FFFFull, "Symbol map is too large for the binary format");
+    SymbolImageHeader header{};
+    header.Magic = SYMBOL_IMAGE_MAGIC;
+    header.Format = SYMBOL_IMAGE_FORMAT;
+    header.NumEntries = (U32)entries.size();
+    header.BlobSize = (U64)blob.length();
+    header.ContentHash = CRC64((const U8*)entries.data(), (U32)(entries.size() * sizeof(ImageEntry)));
+    header.ContentHash = CRC64((const U8*)blob.c_str(), (U32)blob.length(), header.ContentHash);
+    stream->Write((const U8*)&header, sizeof(SymbolImageHeader));
+    stream->Write((const U8*)entries.data(), (U64)(entries.size() * sizeof(ImageEntry)));
+    stream->Write((const U8*)blob.c_str(), (U64)blob.length());
 }
 
 String SymbolTable::FindLocal(Symbol sym)
 {
-    std::lock_guard<std::mutex> _L{_Lock};
-    auto it = _SortedHashed.find(sym); // BINARY SEARCH
-    if(it == _SortedHashed.end())
+    String str{};
+    const Image* pImage = nullptr;
+    const ImageEntry* pEntry = _FindInImages(sym, pImage);
+    if(pEntry)
     {
-        return ""; // not found
+        str = String(pImage->Blob + pEntry->Offset, pEntry->Length);
     }
     else
     {
-        String& str = _Table[it->second];
-        return StringStartsWith(str, "CRC32:") ? String(str.c_str() + 6) : str;
+        OverlayShard& shard = _Overlay[sym.GetCRC64() % NumOverlayShards];
+        std::shared_lock<std::shared_mutex> _R{shard.Lock};
+        auto it = shard.Strings.find(sym.GetCRC64());
+        if(it == shard.Strings.end())
+            return ""; // not found
+        str = it->second;
     }
+    return StringStartsWith(str, "CRC32:") ? String(str.c_str() + 6) : str;
 }
 
 void SymbolTable::Clear()
 {
     std::lock_guard<std::mutex> _L{_Lock};
-    _Table.clear();
-    _SortedHashed.clear();
+    for(Image* pImage = _Images.exchange(nullptr); pImage; pImage = pImage->Next)
+        _RetiredImages.push_back(pImage); // readers may still be searching it
+    for(OverlayShard& shard: _Overlay)
+    {
+        std::unique_lock<std::shared_mutex> _W{shard.Lock};
+        shard.Strings.clear();
+    }
+}
+
+void SymbolTable::Release()
+{
+    Clear();
+    std::lock_guard<std::mutex> _L{_Lock};
+    for(Image* pImage: _RetiredImages)
+        delete pImage;
+    _RetiredImages.clear();
 }
 
 void SymbolTable::Register(const String& str)
 {
     if(str.length() == 0)
         return;
-    std::lock_guard<std::mutex> _L{_Lock};
     
-    Symbol sym;
-    if(StringStartsWith(str, "CRC32:"))
-    {
-        CString s = str.c_str() + 6;
-        sym = Symbol((U64)CRC32((const U8*)s, (U32)str.length() - 6));
-    }
-    else
-        sym = Symbol(str);
+    U64 hash = _HashSymbolString(str.c_str(), (U32)str.length());
+    const Image* pImage = nullptr;
+    if(_FindInImages(hash, pImage))
+        return; // loaded from a symbol map
     
-    auto it = _SortedHashed.find(sym); // BINARY SEARCH
-    if(it == _SortedHashed.end())
+    OverlayShard& shard = _Overlay[hash % NumOverlayShards];
     {
-        // Append
-        U32 index = (U32)_Table.size();
-        _SortedHashed[sym] = index;
-        _Table.push_back(str);
-    }
-    else
-    {
-        // Ensure no hash collision!
-        if(!CompareCaseInsensitive(str, _Table[it->second]))
-        {
-            TTE_ASSERT(false, "Detected hash collision! '%s' and '%s'"
-                       " have the same case insensitive hash!", str.c_str(), _Table[it->second].c_str());
-        }
+        std::shared_lock<std::shared_mutex> _R{shard.Lock};
+        if(shard.Strings.find(hash) != shard.Strings.end())
+            return; // already registered, most calls end here
     }
+    std::unique_lock<std::shared_mutex> _W{shard.Lock};
+    shard.Strings.emplace(hash, str);
 }
 
 const U32 CRC32_Table[256] = {
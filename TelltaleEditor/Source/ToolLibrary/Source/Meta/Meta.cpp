@@ -8,11 +8,15 @@
 
 #include <sstream>
 #include <map>
+#include <algorithm>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
 #endif
 
+// Keyed collections smaller than this are searched linearly, not worth hashing
+#define COLLECTION_KEY_INDEX_MIN 16
+
 // ===================================================================         META
 // ===================================================================
 
@@ -452,20 +456,25 @@ namespace Meta {
             
             if(clazz->Serialise) // has serialiser.
             {
-                if(clazz->Flags & CLASS_CONTAINER)
+                Bool bDebug = stream.IsDebugging(); // no string formatting unless asked for
+                if(bDebug && (clazz->Flags & CLASS_CONTAINER))
                 {
                     stream.WriteTabs();
-                    stream.DebugOutput << clazz->Name << " " << member << ":\n";
+                    *stream.DebugOutput << clazz->Name << " " << member << ":\n";
                     stream.WriteTabs();
-                    stream.DebugOutput << "{\n";
+                    *stream.DebugOutput << "{\n";
                     stream.TabDepth++;
                 }
                 result = clazz->Serialise(stream, host, clazz, pMemory, IsWrite);
-                if(clazz->Flags & CLASS_CONTAINER)
+                if(!bDebug)
+                {
+                    ; // nothing to output
+                }
+                else if(clazz->Flags & CLASS_CONTAINER)
                 {
                     stream.TabDepth--;
                     stream.WriteTabs();
-                    stream.DebugOutput << "}\n";
+                    *stream.DebugOutput << "}\n";
                 }else
                 {
                     String val{};
@@ -474,45 +483,88 @@ namespace Meta {
                     else
                         val = _PerformToString((U8*)pMemory, clazz);
                     stream.WriteTabs();
-                    stream.DebugOutput << clazz->Name << " " << member << ": " << val.c_str() << "\n";
+                    *stream.DebugOutput << clazz->Name << " " << member << ": " << val.c_str() << "\n";
                 }
             }
-            else if(clazz->SerialiseScriptFn.length() > 0) // RUN LUA SERIALISER FUNCTION
+            else if(clazz->NativeSerialise) // RUN NATIVE SERIALISER, replaces the lua one
             {
                 
-                LuaManager& man = GetThreadLVM();
-                
-                if(stream.DebugOutputFile)
+                if(stream.IsDebugging())
                 {
                     stream.WriteTabs();
                     if(member)
                     {
-                        stream.DebugOutput << ":Lua Serialiser for " << member << ": " << clazz->SerialiseScriptFn << "\n";
+                        *stream.DebugOutput << ":Native Serialiser for " << member << ": " << clazz->SerialiseScriptFn << "\n";
                     }
                     else
                     {
-                        stream.DebugOutput << ":Lua Serialiser: " << clazz->SerialiseScriptFn << "\n";
+                        *stream.DebugOutput << ":Native Serialiser: " << clazz->SerialiseScriptFn << "\n";
                     }
                 }
                 
-                auto it = State.Serialisers.find(clazz->SerialiseScriptFn);
-                if(it == State.Serialisers.end())
+                // same instance as the lua serialiser would get
+                ClassInstance tmp;
+                if(host._GetInternal() == pMemory)
+                {
+                    tmp = host;
+                    tmp._InstanceClassID = clazz->ClassID;
+                }
+                else
+                {
+                    tmp = ClassInstance{clazz->ClassID, (U8*)pMemory, host.ObtainParentRef()};
+                }
+                
+                result = clazz->NativeSerialise(stream, tmp, clazz, pMemory, IsWrite);
+                
+                if(!result)
                 {
-                    TTE_ASSERT(false, "Cannot serialise type %s: serialiser function failed to initilaise", clazz->Name.c_str());
+                    TTE_LOG("Cannot serialise type %s: native serialisation function returned false", clazz->Name.c_str());
                     return false; // FAIL
                 }
                 
-                ScriptManager::GetGlobal(man, clazz->SerialiseScriptFn, true);
-                if(man.Type(-1) != LuaType::FUNCTION)
+            }
+            else if(clazz->SerialiseScriptFn.length() > 0) // RUN LUA SERIALISER FUNCTION
+            {
+                
+                LuaManager& man = GetThreadLVM();
+                
+                if(stream.IsDebugging())
                 {
-                    man.Pop(1);
-                    if(!man.LoadChunk(clazz->SerialiseScriptFn, it->second.Binary, it->second.Size, LoadChunkMode::BINARY))
+                    stream.WriteTabs();
+                    if(member)
+                    {
+                        *stream.DebugOutput << ":Lua Serialiser for " << member << ": " << clazz->SerialiseScriptFn << "\n";
+                    }
+                    else
+                    {
+                        *stream.DebugOutput << ":Lua Serialiser: " << clazz->SerialiseScriptFn << "\n";
+                    }
+                }
+                
+                // resolve the function once per VM, after that call it through the cached registry reference
+                I32 ref = man.GetCachedReference(clazz->ClassID, State.Generation);
+                if(ref == -1)
+                {
+                    auto it = State.Serialisers.find(clazz->SerialiseScriptFn);
+                    if(it == State.Serialisers.end())
                     {
-                        TTE_ASSERT(false, "Cannot serialise type %s: compiled serialiser function failed to load", clazz->Name.c_str());
+                        TTE_ASSERT(false, "Cannot serialise type %s: serialiser function failed to initilaise", clazz->Name.c_str());
                         return false; // FAIL
                     }
+                    
+                    ScriptManager::GetGlobal(man, clazz->SerialiseScriptFn, true);
+                    if(man.Type(-1) != LuaType::FUNCTION)
+                    {
+                        man.Pop(1);
+                        if(!man.LoadChunk(clazz->SerialiseScriptFn, it->second.Binary, it->second.Size, LoadChunkMode::BINARY))
+                        {
+                            TTE_ASSERT(false, "Cannot serialise type %s: compiled serialiser function failed to load", clazz->Name.c_str());
+                            return false; // FAIL
+                        }
+                    }
+                    ref = man.RefReg(); // pops it
+                    man.SetCachedReference(clazz->ClassID, ref);
                 }
-                // else its now on the stack
                 
                 // arguments: meta stream, instance, is write
                 
@@ -536,7 +588,7 @@ namespace Meta {
                 
                 man.PushBool(IsWrite); // push is write
                 
-                man.CallFunction(3, 1, true); // call, locked.
+                man.CallReference(ref, 3, 1, true); // call, locked.
                 
                 result = ScriptManager::PopBool(man); // check result
                 
@@ -568,15 +620,15 @@ namespace Meta {
             
             StreamSection initialSection = stream.CurrentSection; // ensure after the section is the same
             
-            if(stream.DebugOutputFile)
+            if(stream.IsDebugging())
             {
                 mem = mem ? mem : "";
                 if(clazz->Members.size() > 0)
                 {
                     stream.WriteTabs();
-                    stream.DebugOutput << clazz->Name << " " << mem << ":\n";
+                    *stream.DebugOutput << clazz->Name << " " << mem << ":\n";
                     stream.WriteTabs();
-                    stream.DebugOutput << "{\n";
+                    *stream.DebugOutput << "{\n";
                     stream.TabDepth++;
                 }
             }
@@ -647,11 +699,11 @@ namespace Meta {
                 
             }
             
-            if(stream.DebugOutputFile && clazz->Members.size() > 0)
+            if(stream.IsDebugging() && clazz->Members.size() > 0)
             {
                 stream.TabDepth--;
                 stream.WriteTabs();
-                stream.DebugOutput << "}\n";
+                *stream.DebugOutput << "}\n";
             }
             
             stream.CurrentSection = initialSection; // reset section
@@ -689,6 +741,105 @@ namespace Meta {
             return result;
         }
         
+        Bool _DoHash(Class* pClass, const U8* pMemory, U64& hash)
+        {
+            if(IsStringClass(*pClass))
+            {
+                const String* pString = (const String*)pMemory;
+                hash = CRC64((const U8*)pString->c_str(), (U32)pString->length(), hash);
+            }
+            else if(IsSymbolClass(*pClass))
+            {
+                U64 crc = ((const Symbol*)pMemory)->GetCRC64();
+                hash = CRC64((const U8*)&crc, 8, hash);
+            }
+            else if(pClass->Members.size() == 0)
+            {
+                // only plain intrinsics can be hashed by their bytes. anything else may own memory its equality operator looks through
+                if(!(pClass->Flags & CLASS_INTRINSIC) || (pClass->Flags & CLASS_ATTACHABLE) || pClass->Constructor || pClass->Destructor
+                   || pClass->CopyConstruct || pClass->MoveConstruct)
+                    return false;
+                if(pClass->Name == "float")
+                {
+                    Float value = *(const Float*)pMemory;
+                    if(value == 0.0f)
+                        value = 0.0f; // -0 and +0 compare equal so must hash the same
+                    hash = CRC64((const U8*)&value, 4, hash);
+                }
+                else if(pClass->Name == "double" || pClass->Name == "long double")
+                {
+                    double value = *(const double*)pMemory;
+                    if(value == 0.0)
+                        value = 0.0;
+                    hash = CRC64((const U8*)&value, 8, hash);
+                }
+                else
+                    hash = CRC64(pMemory, pClass->RTSize, hash);
+            }
+            else if(pClass->Equals != nullptr)
+            {
+                return false; // custom equality, we can't know which members it looks at
+            }
+            else
+            {
+                for(auto& member: pClass->Members)
+                {
+                    if(!_DoHash(&State.Classes[member.ClassID], pMemory + member.RTOffset, hash))
+                        return false;
+                }
+            }
+            return true;
+        }
+        
+        void _AccumulateScriptSource(const String& source)
+        {
+            State.ScriptSourceHash = CRC64((const U8*)source.c_str(), (U32)source.length(), State.ScriptSourceHash);
+        }
+        
+        I32 _FindMember(Class* pClass, U64 nameHash)
+        {
+            if(State.Lookup.Built)
+            {
+                auto it = pClass->MemberLookup.find(nameHash);
+                return it == pClass->MemberLookup.end() ? -1 : (I32)it->second;
+            }
+            for(U32 i = 0; i < (U32)pClass->Members.size(); i++)
+            {
+                if(Symbol(pClass->Members[i].Name).GetCRC64() == nameHash)
+                    return (I32)i;
+            }
+            return -1;
+        }
+        
+        // builds the class and member lookup tables once all classes are registered. they are not modified after.
+        void _BuildLookupTables()
+        {
+            State.Lookup.ByToolTypeVersion.clear();
+            State.Lookup.ByTypeVersionCRC.clear();
+            State.Lookup.ByExtension.clear();
+            State.Lookup.ByToolTypeVersion.reserve(State.Classes.size());
+            State.Lookup.ByTypeVersionCRC.reserve(State.Classes.size() * 2);
+            for(auto& clz: State.Classes)
+            {
+                Class& c = clz.second;
+                // first registered wins, same as the linear scans did
+                State.Lookup.ByToolTypeVersion.emplace(std::make_pair(c.ToolTypeHash, c.VersionNumber), clz.first);
+                State.Lookup.ByExtension.emplace(std::make_pair(Symbol(c.Extension).GetCRC64(), c.VersionNumber), clz.first);
+                for(U64 hash: {c.TypeHash, c.ToolTypeHash})
+                {
+                    // lowest version number wins, same as searching each version in order
+                    auto it = State.Lookup.ByTypeVersionCRC.emplace(std::make_pair(hash, c.VersionCRC), clz.first);
+                    if(!it.second && State.Classes[it.first->second].VersionNumber > c.VersionNumber)
+                        it.first->second = clz.first;
+                }
+                c.MemberLookup.clear();
+                c.MemberLookup.reserve(c.Members.size());
+                for(U32 i = 0; i < (U32)c.Members.size(); i++)
+                    c.MemberLookup.emplace(Symbol(c.Members[i].Name).GetCRC64(), i);
+            }
+            State.Lookup.Built = true;
+        }
+        
         U32 _PerformLegacyClassHash(const String& name)
         {
             U32 ind = 0;
@@ -1498,24 +1649,28 @@ namespace Meta {
         return instanceNew;
     }
     
-    ClassInstance GetMember(ClassInstance& inst, const String& name, Bool bi)
+    ClassInstance GetMember(ClassInstance& inst, const MemberHandle& member, Bool bi)
     {
         if(!inst)
             return {}; // edge case
-        const Class& clazz = State.Classes[inst.GetClassID()];
-        for(auto& mem: clazz.Members)
+        Class& clazz = State.Classes[inst.GetClassID()];
+        I32 index = _Impl::_FindMember(&clazz, member.NameHash);
+        if(index != -1)
         {
-            if(CompareCaseInsensitive(name, mem.Name))
-            {
-                return ClassInstance(mem.ClassID, Ptr<U8>(inst._InstanceMemory, // same control block, different pointer.
-                                                          inst._GetInternal() + mem.RTOffset), inst.ObtainParentRef());
-            }
+            const Member& mem = clazz.Members[index];
+            return ClassInstance(mem.ClassID, Ptr<U8>(inst._InstanceMemory, // same control block, different pointer.
+                                                      inst._GetInternal() + mem.RTOffset), inst.ObtainParentRef());
         }
         if(bi)
-            TTE_ASSERT(false, "Member %s::%s does not exist!", clazz.Name.c_str(), name.c_str());
+            TTE_ASSERT(false, "Member %s::%s does not exist!", clazz.Name.c_str(), member.Name.c_str());
         return {}; // not found
     }
     
+    ClassInstance GetMember(ClassInstance& inst, const String& name, Bool bi)
+    {
+        return GetMember(inst, MemberHandle{name}, bi);
+    }
+    
     Bool PerformLessThan(ClassInstance& lhs, ClassInstance& rhs)
     {
         if(!lhs || !rhs)
@@ -1564,7 +1719,7 @@ namespace Meta {
                     return false;
                 }
             }
-            return false;
+            return true;
         }
     }
     
@@ -1581,6 +1736,11 @@ namespace Meta {
     
     U32 FindClassByCRC(U64 typeHash, U32 versionCRC)
     {
+        if(State.Lookup.Built)
+        {
+            auto it = State.Lookup.ByTypeVersionCRC.find({typeHash, versionCRC});
+            return it == State.Lookup.ByTypeVersionCRC.end() ? 0 : it->second;
+        }
         // version number should only be between 0 and  MAX_VERSION_NUMBER
         for(U32 i = 0; i <= MAX_VERSION_NUMBER; i++)
         {
@@ -1593,6 +1753,11 @@ namespace Meta {
     
     U32 FindClassByExtension(const String& ext, U32 versionNumber)
     {
+        if(State.Lookup.Built)
+        {
+            auto it = State.Lookup.ByExtension.find({Symbol(ext).GetCRC64(), versionNumber});
+            return it == State.Lookup.ByExtension.end() ? 0 : it->second;
+        }
         for(auto& clz: State.Classes)
         {
             if(clz.second.VersionNumber == versionNumber && CompareCaseInsensitive(clz.second.Extension, ext))
@@ -1605,7 +1770,12 @@ namespace Meta {
     {
         U32 id = _Impl::_GenerateClassID(typeHash, versionNumber);
         Bool bFound = State.Classes.find(id) != State.Classes.end();
-        if(!bFound)
+        if(!bFound && State.Lookup.Built)
+        {
+            auto it = State.Lookup.ByToolTypeVersion.find({typeHash, versionNumber});
+            return it == State.Lookup.ByToolTypeVersion.end() ? 0 : it->second;
+        }
+        else if(!bFound)
         {
             for(auto& clz: State.Classes)
             {
@@ -1616,6 +1786,21 @@ namespace Meta {
         return bFound ? id : 0;
     }
     
+    static void _FreeClassDatabaseMT(ClassDatabase& db)
+    {
+        for(auto& script: db.Serialisers)
+            _Impl::_FreeCompiledScriptMT(script.second);
+        for(auto& script: db.Normalisers)
+            _Impl::_FreeCompiledScriptMT(script.second);
+        for(auto& script: db.Specialisers)
+            _Impl::_FreeCompiledScriptMT(script.second);
+        _Impl::_FreeCompiledScriptMT(db.Collector);
+        db = ClassDatabase{};
+    }
+    
+    static Bool _ActivateClassDatabase(const GameSnapshot& snap, U32 gameIdx);
+    static void _StashClassDatabase();
+    
     // initialise the snapshot State.Classes
     void InitGame()
     {
@@ -1656,6 +1841,16 @@ namespace Meta {
             return;
         }
         
+        State.Generation++; // lua serialiser references cached for the previous game are stale
+        
+        // Classes for this snapshot were registered before, reuse them
+        if(_ActivateClassDatabase(snap, gameIdx))
+        {
+            TTE_LOG("Meta fully initialised with snapshot of %s: reused %d registered classes\n\n", snap.ID.c_str(), (U32)State.Classes.size());
+            State.GameIndex = (I32)gameIdx;
+            return;
+        }
+        
         // Run RegisterAll and register all State.Classes in the current snapshot
         
         ScriptManager::GetGlobal(GetToolContext()->GetLibraryLVM(), "RegisterAll", true);
@@ -1736,14 +1931,71 @@ namespace Meta {
             }
         }
         
+        _Impl::_BuildLookupTables();
+        
         TTE_LOG("Meta fully initialised with snapshot of %s: registered %d classes\n\n", snap.ID.c_str(), (U32)State.Classes.size());
         State.GameIndex = (I32)gameIdx;
     }
     
+    // re-activates a stashed class database for the snapshot. the encryption key was validated when it was first registered.
+    static Bool _ActivateClassDatabase(const GameSnapshot& snap, U32 gameIdx)
+    {
+        auto it = State.Databases.find(snap.ID + "/" + snap.Platform + "/" + snap.Vendor);
+        if(it == State.Databases.end())
+            return false;
+        ClassDatabase& db = it->second;
+        Bool bValid = db.SourceHash == State.ScriptSourceHash;
+        if(bValid)
+        {
+            State.Classes = std::move(db.Classes);
+            State.Lookup = std::move(db.Lookup);
+            State.Serialisers = std::move(db.Serialisers);
+            State.Normalisers = std::move(db.Normalisers);
+            State.Specialisers = std::move(db.Specialisers);
+            State.Collector = db.Collector;
+            State.VersionCalcFun = std::move(db.VersionCalcFun);
+            
+            BlowfishKey key = State.Games[gameIdx].GetEncryptionKey(snap);
+            Blowfish::Initialise(State.Games[gameIdx].Fl.Test(RegGame::MODIFIED_BLOWFISH), key.BfKey, key.BfKeyLength);
+        }
+        else
+        {
+            // library scripts changed since it was registered, drop it
+            _FreeClassDatabaseMT(db);
+        }
+        State.Databases.erase(it);
+        return bValid;
+    }
+    
+    // stashes the class database of the current snapshot, such that switching back to it does not run the registration again
+    static void _StashClassDatabase()
+    {
+        const GameSnapshot& snap = GetToolContext()->GetSnapshot();
+        ClassDatabase& db = State.Databases[snap.ID + "/" + snap.Platform + "/" + snap.Vendor];
+        _FreeClassDatabaseMT(db); // should be empty
+        db.SourceHash = State.ScriptSourceHash;
+        db.Classes = std::move(State.Classes);
+        db.Lookup = std::move(State.Lookup);
+        db.Serialisers = std::move(State.Serialisers);
+        db.Normalisers = std::move(State.Normalisers);
+        db.Specialisers = std::move(State.Specialisers);
+        db.Collector = State.Collector;
+        db.VersionCalcFun = std::move(State.VersionCalcFun);
+        State.Collector = {};
+        State.Classes.clear();
+        State.Lookup = {};
+        State.Serialisers.clear();
+        State.Normalisers.clear();
+        State.Specialisers.clear();
+    }
+    
     void RelGame()
     {
         TTE_ASSERT(IsCallingFromMain(), "Must only be called from main thread");
         
+        if(State.GameIndex != -1)
+            _StashClassDatabase(); // fully initialised, keep it for next time
+        
         // clear compiled memory
         for(auto& script: State.Serialisers)
             _Impl::_FreeCompiledScriptMT(script.second);
@@ -1756,6 +2008,7 @@ namespace Meta {
         State.Specialisers.clear();
         _Impl::_FreeCompiledScriptMT(State.Collector);
         
+        State.Lookup = {};
         State.Classes.clear();
         State.VersionCalcFun = "";
         State.GameIndex = -1;
@@ -1767,15 +2020,18 @@ namespace Meta {
         TTE_ASSERT(GetToolContext(), "Tool context not created");
         
         InjectFullLuaAPI(GetToolContext()->GetLibraryLVM(), false);
+        _Impl::_RegisterNativeSerialisers(); // before any classes can opt into them
         
         // Setup games script
         
-        ScriptManager::RunText(GetToolContext()->GetLibraryLVM(),
-                               GetToolContext()->LoadLibraryStringResource("Scripts/Games.lua"), "Games.lua", false); // Initialise games
+        String src = GetToolContext()->LoadLibraryStringResource("Scripts/Games.lua");
+        _Impl::_AccumulateScriptSource(src);
+        ScriptManager::RunText(GetToolContext()->GetLibraryLVM(), src, "Games.lua", false); // Initialise games
         
         // Setup State.Classes script
         
-        String src = GetToolContext()->LoadLibraryStringResource("Scripts/Classes.lua");
+        src = GetToolContext()->LoadLibraryStringResource("Scripts/Classes.lua");
+        _Impl::_AccumulateScriptSource(src);
         ScriptManager::RunText(GetToolContext()->GetLibraryLVM(), src, "Classes.lua", false);
         src.clear();
         
@@ -1786,7 +2042,19 @@ namespace Meta {
     {
         TTE_ASSERT(IsCallingFromMain(), "Must only be called from main thread");
         
+        for(auto& db: State.Databases)
+            _FreeClassDatabaseMT(db.second);
+        State.Databases.clear();
         State.Games.clear();
+        State.NativeSerialisers.clear();
+    }
+    
+    void RegisterNativeSerialiser(const String& name, NativeSerialiser fn)
+    {
+        TTE_ASSERT(IsCallingFromMain(), "Must only be called from main thread");
+        TTE_ASSERT(State.GameIndex == -1, "Native serialisers must be registered before a game is initialised");
+        TTE_ASSERT(fn != nullptr && name.length(), "Invalid native serialiser");
+        State.NativeSerialisers[name] = fn;
     }
     
     std::vector<U32> GetClassIDs()
@@ -2039,7 +2307,7 @@ namespace Meta {
         }
         Stream metaStream{};
         metaStream.Name = fn;
-        metaStream.DebugOutputFile = std::move(dbg);
+        metaStream.SetDebugOutput(std::move(dbg));
         metaStream.MaxInlinableBuffer = _max;
         U8 Buffer[256]{};
         U32 mainSectionSize{}, asyncSectionSize{}, debugSectionSize{};
@@ -2292,17 +2560,17 @@ namespace Meta {
         }
         
         // write debug header
-        if(metaStream.DebugOutputFile)
+        if(metaStream.IsDebugging())
         {
-            metaStream.DebugOutput << "Meta Stream [" << magic << "] debug output from the Telltale Editor v" TTE_VERSION "\n";
-            metaStream.DebugOutput << "\n_metaVersionInfo:\n{\n";
+            *metaStream.DebugOutput << "Meta Stream [" << magic << "] debug output from the Telltale Editor v" TTE_VERSION "\n";
+            *metaStream.DebugOutput << "\n_metaVersionInfo:\n{\n";
             for(auto& version: metaStream.VersionInf)
             {
                 Class& clazz = State.Classes[version];
-                metaStream.DebugOutput << "-\t" << clazz.Name.c_str() << ": Version 0x" <<
+                *metaStream.DebugOutput << "-\t" << clazz.Name.c_str() << ": Version 0x" <<
                 std::hex << std::uppercase << clazz.VersionCRC << "[" << clazz.VersionNumber << "]\n";
             }
-            metaStream.DebugOutput << "}\n\n";
+            *metaStream.DebugOutput << "}\n\n";
         }
         
         // perform actual serialisation of the primary class stored.
@@ -2326,17 +2594,16 @@ namespace Meta {
             }
         }
         
-        if(metaStream.DebugOutputFile)
+        if(metaStream.IsDebugging())
         {
             if(!instance)
             {
-                metaStream.DebugOutput << "\n>> ERRORED! Could not read remaining bytes... (see console)";
+                *metaStream.DebugOutput << "\n>> ERRORED! Could not read remaining bytes... (see console)";
             }
             // Move output string file
-            String val = metaStream.DebugOutput.str();
+            String val = metaStream.DebugOutput->str();
             metaStream.DebugOutputFile->Write((const U8*)val.c_str(), val.length());
-            metaStream.DebugOutput.clear();
-            metaStream.DebugOutputFile.reset(); // flush
+            metaStream.SetDebugOutput({}); // flush
         }
         
         return instance; // OK / FAIL
@@ -2508,6 +2775,13 @@ namespace Meta {
         // move transience fence
         _TransienceFence = std::move(rhs._TransienceFence);
         rhs._TransienceFence = TTE_NEW_PTR(std::atomic<U32>, MEMORY_TAG_TRANSIENT_FENCE, 0); // rhs still is valid give it a new slot
+        
+        // key index moves with the fence, rhs fence restarts so its index must go
+        _KeyIndex = std::move(rhs._KeyIndex);
+        _KeyIndexFence = rhs._KeyIndexFence;
+        _KeyIndexValid = rhs._KeyIndexValid;
+        rhs._KeyIndex.reset();
+        rhs._KeyIndexValid = false;
     }
     
     ClassInstanceCollection::ClassInstanceCollection(const ClassInstanceCollection& rhs, ParentWeakReference host)
@@ -2883,7 +3157,7 @@ namespace Meta {
                 {
                     //TTE_ASSERT(_ColID && State.Classes[_ColID].ArrayValClass && State.Classes[State.Classes[_ColID].ArrayValClass].Destructor,
                     //           "Meta collection class: no value destructor found");
-                    _Impl::_DoDestruct(&State.Classes[State.Classes[_ColID].ArrayValClass], pMem, false);
+                    _Impl::_DoDestruct(&State.Classes[State.Classes[_ColID].ArrayValClass], pMem + _PairSize - _ValuSize, false);
                 }
             }
             
@@ -2933,62 +3207,174 @@ namespace Meta {
         }
     }
     
-    void ClassInstanceCollection::Sort(void *user, CollectionComparatorLess *pComparator)
+    void ClassInstanceCollection::Sort(void *user, CollectionComparatorLess *pComparator, Bool bStable)
     {
         AdvanceTransienceFenceInternal();
-        U8 fasterMemory[128]{};
-        Memory::FastBufferAllocator alloc{};
         TTE_ASSERT(pComparator, "Invalid comparator! Null.");
+        if(_Size < 2)
+            return;
         // Helper fast locals
         ParentWeakReference _{};
-        U32 size = GetSize();
+        U32 size = _Size;
         Bool keyed = IsKeyedCollection();
-        Bool bAllOk = false;
-        U8* tempMemory;
-        if(_PairSize < 128)
-            tempMemory = fasterMemory;
+        U32 compareClass = keyed ? GetKeyClass() : GetValueClass();
+        U32 compareOffset = keyed ? 0 : _PairSize - _ValuSize;
+        
+        // Sort a permutation of indices instead of the elements themselves, so the type erased elements are only relocated once.
+        std::vector<ClassInstance> refs{};
+        std::vector<U32> order{};
+        refs.reserve(size);
+        order.reserve(size);
+        for(U32 i = 0; i < size; i++)
+        {
+            refs.push_back(SubRef(compareClass, _Memory + (i * _PairSize) + compareOffset));
+            order.push_back(i);
+        }
+        auto less = [&](U32 lhs, U32 rhs) -> bool
+        {
+            return pComparator(user, refs[lhs], refs[rhs]);
+        };
+        if(bStable)
+            std::stable_sort(order.begin(), order.end(), less);
         else
-            tempMemory = alloc.Alloc(_PairSize, 8);
-        memset(fasterMemory, 0, 128);
-        U8* tempKeyMemory = tempMemory;
-        U8* tempValueMemory = tempKeyMemory + _PairSize - _ValuSize;
-        Class* keyClazz = keyed ? const_cast<Class*>(&GetClass(GetKeyClass())) : nullptr;
-        Class* valClazz = const_cast<Class*>(&GetClass(GetValueClass()));
-        // Classic bubble early out sort.
-        while(!bAllOk)
-        {
-            bAllOk = true;
-            for(U32 i = 0; i < size-1; i++)
-            {
-                Bool comparatorResult = keyed ? pComparator(user, GetKey(i), GetKey(i + 1)) : pComparator(user, GetValue(i), GetValue(i + 1));
-                if(!comparatorResult)
-                {
-                    bAllOk = false;
-                    // Swap
-                    
-                    U8* keyValue1 = _Memory + (i*_PairSize), *keyValue2 = _Memory + ((i+1)*_PairSize);
-                    U8* valValue1 = _Memory + (((i+0)*_PairSize) - _ValuSize), *valValue2 = _Memory + (((i+1)*_PairSize) - _ValuSize);
-                    
-                    // Move val1 into temp
-                    if(keyed)
-                        _Impl::_DoMoveConstruct(keyClazz, tempKeyMemory, keyValue1, _PrntRef, _, false, false);
-                    _Impl::_DoMoveConstruct(valClazz, tempValueMemory, valValue1, _PrntRef, _, false, false);
-                    memset(keyValue1, 0, _PairSize); // reset key and value memory
-                    
-                    // Move val2 into val1
-                    if(keyed)
-                        _Impl::_DoMoveConstruct(keyClazz, keyValue1, keyValue2, _PrntRef, _, false, false);
-                    _Impl::_DoMoveConstruct(valClazz, valValue1, valValue2, _PrntRef, _, false, false);
-                    memset(keyValue2, 0, _PairSize); // reset key and value memory
-                    
-                    // Move temp into val2
-                    if(keyed)
-                        _Impl::_DoMoveConstruct(keyClazz, keyValue2, tempKeyMemory, _PrntRef, _, false, false);
-                    _Impl::_DoMoveConstruct(valClazz, valValue2, tempValueMemory, _PrntRef, _, false, false);
-                    memset(tempMemory, 0, _PairSize); // reset key and value memory
+            std::sort(order.begin(), order.end(), less);
+        refs.clear();
+        
+        Bool bSorted = true;
+        for(U32 i = 0; i < size && bSorted; i++)
+            bSorted = order[i] == i;
+        if(bSorted)
+            return; // already in order, nothing to relocate
+        
+        // check if we we can skip move constructor with memcpy
+        Bool bSkipKey = (_ColFl & _COL_KEY_SKIP_MV) != 0;
+        Bool bSkipVal = (_ColFl & _COL_VAL_SKIP_MV) != 0;
+        U32 offset = _PairSize - _ValuSize;
+        U8* pScratch = TTE_ALLOC(size * _PairSize, MEMORY_TAG_META_COLLECTION);
+        memset(pScratch, 0, size * _PairSize);
+        
+        if(bSkipKey && bSkipVal)
+        {
+            // plain old data, gather into the scratch buffer and copy back in one go.
+            for(U32 i = 0; i < size; i++)
+                memcpy(pScratch + (i * _PairSize), _Memory + (order[i] * _PairSize), _PairSize);
+            memcpy(_Memory, pScratch, size * _PairSize);
+        }
+        else
+        {
+            Class* keyClazz = keyed ? &State.Classes[GetKeyClass()] : nullptr;
+            Class* valClazz = &State.Classes[GetValueClass()];
+            Bool bSkipKeyDt = (_ColFl & _COL_KEY_SKIP_DT) != 0;
+            Bool bSkipValDt = (_ColFl & _COL_VAL_SKIP_DT) != 0;
+            
+            // relocates a single element from src to dst, leaving src destructed.
+            auto relocate = [&](U8* pDstMem, U8* pSrcMem)
+            {
+                if(!keyed || bSkipKey)
+                    memcpy(pDstMem, pSrcMem, offset);
+                else
+                {
+                    _Impl::_DoMoveConstruct(keyClazz, pDstMem, pSrcMem, _PrntRef, _, false, false);
+                    if(!bSkipKeyDt)
+                        _Impl::_DoDestruct(keyClazz, pSrcMem, false);
+                }
+                if(bSkipVal)
+                    memcpy(pDstMem + offset, pSrcMem + offset, _ValuSize);
+                else
+                {
+                    _Impl::_DoMoveConstruct(valClazz, pDstMem + offset, pSrcMem + offset, _PrntRef, _, false, false);
+                    if(!bSkipValDt)
+                        _Impl::_DoDestruct(valClazz, pSrcMem + offset, false);
                 }
+                memset(pSrcMem, 0, _PairSize); // reset key and value memory
+            };
+            
+            // gather in sorted order into the scratch buffer, then move back into place.
+            for(U32 i = 0; i < size; i++)
+                relocate(pScratch + (i * _PairSize), _Memory + (order[i] * _PairSize));
+            for(U32 i = 0; i < size; i++)
+                relocate(_Memory + (i * _PairSize), pScratch + (i * _PairSize));
+        }
+        
+        TTE_FREE(pScratch);
+    }
+    
+    Bool ClassInstanceCollection::UpdateKeyIndexInternal()
+    {
+        if(!IsKeyedCollection() || !_TransienceFence || _Size < COLLECTION_KEY_INDEX_MIN)
+            return false;
+        U32 fence = _TransienceFence->load();
+        if(_KeyIndexValid && _KeyIndexFence == fence)
+            return true;
+        if(!_KeyIndex)
+            _KeyIndex = TTE_NEW_PTR(KeyIndexMap, MEMORY_TAG_META_COLLECTION);
+        _KeyIndex->clear();
+        _KeyIndexValid = false;
+        Class* keyClazz = &State.Classes[GetKeyClass()];
+        _KeyIndex->reserve(_Size);
+        for(U32 i = 0; i < _Size; i++)
+        {
+            U64 hash = 0;
+            if(!_Impl::_DoHash(keyClazz, _Memory + (i * _PairSize), hash))
+            {
+                _KeyIndex->clear();
+                return false; // not hashable, callers fall back to a linear search
             }
+            _KeyIndex->emplace(hash, i);
+        }
+        _KeyIndexFence = fence;
+        _KeyIndexValid = true;
+        return true;
+    }
+    
+    I32 ClassInstanceCollection::Find(ClassInstance key)
+    {
+        if(!key || !IsKeyedCollection() || key.GetClassID() != GetKeyClass())
+            return -1;
+        if(UpdateKeyIndexInternal())
+        {
+            U64 hash = 0;
+            _Impl::_DoHash(&State.Classes[GetKeyClass()], key._GetInternal(), hash);
+            auto range = _KeyIndex->equal_range(hash);
+            for(auto it = range.first; it != range.second; it++)
+            {
+                ClassInstance comparand = GetKey(it->second);
+                if(PerformEquality(key, comparand))
+                    return (I32)it->second;
+            }
+            return -1;
+        }
+        for(U32 i = 0; i < _Size; i++)
+        {
+            ClassInstance comparand = GetKey(i);
+            if(PerformEquality(key, comparand))
+                return (I32)i;
+        }
+        return -1;
+    }
+    
+    U32 ClassInstanceCollection::InsertOrAssign(ClassInstance key, ClassInstance value, Bool bCopyKey, Bool bCopyVal)
+    {
+        TTE_ASSERT(IsKeyedCollection() && key && key.GetClassID() == GetKeyClass(), "InsertOrAssign requires a keyed collection and a key of its key class");
+        I32 index = Find(key);
+        Bool bIndexed = _KeyIndexValid && _TransienceFence && _KeyIndexFence == _TransienceFence->load();
+        U64 hash = 0;
+        if(index != -1)
+        {
+            SetIndex((U32)index, std::move(key), std::move(value), bCopyKey, bCopyVal);
+        }
+        else
+        {
+            if(bIndexed)
+                _Impl::_DoHash(&State.Classes[GetKeyClass()], key._GetInternal(), hash);
+            index = (I32)_Size;
+            Push(std::move(key), std::move(value), bCopyKey, bCopyVal);
+            if(bIndexed)
+                _KeyIndex->emplace(hash, (U32)index);
         }
+        if(bIndexed)
+            _KeyIndexFence = _TransienceFence->load(); // we kept the index up to date ourselves
+        return (U32)index;
     }
     
     Bool ClassInstanceCollection::Pop(U32 index, ClassInstance& keyOut, ClassInstance& valOut)
@@ -0,0 +1,135 @@
+#include <Meta/Meta.hpp>
+#include <Core/Base64.hpp>
+
+// Native versions of the hottest script serialisers. These must read and write exactly what the script function of the same name does,
+// the script function is kept as the fallback. Classes opt in by setting NativeSerialiser in their registration.
+
+namespace Meta {
+    
+    namespace _Impl {
+        
+        // same as MetaStreamReadBuffer
+        static Bool _ReadBinaryBuffer(Stream& stream, BinaryBuffer& buf, U32 size)
+        {
+            TTE_ASSERT(size < 0x10000000, "Buffer size invalid (>256MB)");
+            
+            U8* Buffer = TTE_ALLOC(size, MEMORY_TAG_RUNTIME_BUFFER);
+            buf.BufferSize = size;
+            buf.BufferData = Ptr<U8>(Buffer, [](U8* p){TTE_FREE(p);});
+            
+            if(!stream.Read(Buffer, (U64)size))
+            {
+                TTE_ASSERT(false, "Binary buffer read fail - size is likely too large.");
+                return false;
+            }
+            
+            if(stream.IsDebugging())
+            {
+                stream.WriteTabs();
+                U32 base64Encoded = MIN(stream.MaxInlinableBuffer, buf.BufferSize);
+                String base64 = Base64::Encode(Buffer, base64Encoded);
+                *stream.DebugOutput << "[BufferData Base64] >> \"" << base64;
+                if(base64Encoded != buf.BufferSize)
+                    *stream.DebugOutput << "...\"\n";
+                else
+                    *stream.DebugOutput << "\"\n";
+            }
+            
+            return true;
+        }
+        
+        // SerialiseD3DIndexBuffer0 (Common/D3DMesh.lua)
+        static Bool SerialiseD3DIndexBuffer0(Stream& stream, ClassInstance& inst, Class* clazz, void* pMemory, Bool IsWrite)
+        {
+            static const MemberHandle kData{"_IndexBufferData"};
+            static const MemberHandle kFormat{"mFormat"};
+            static const MemberHandle kNumIndices{"mNumIndicies"};
+            
+            if(!_DefaultSerialise(stream, inst, clazz, pMemory, IsWrite, nullptr))
+                return false;
+            
+            BinaryBuffer& buf = GetMember<BinaryBuffer>(inst, kData);
+            if(IsWrite)
+            {
+                if(!buf.BufferData || !stream.Write(buf.BufferData.get(), (U64)buf.BufferSize))
+                {
+                    TTE_ASSERT(false, "Binary buffer is null or buffer write fail");
+                    return false;
+                }
+                return true;
+            }
+            
+            U32 indexBytes = GetMember<I32>(inst, kFormat) == 101 ? 2 : 4; // format 101 means U16, else U32s
+            return _ReadBinaryBuffer(stream, buf, indexBytes * (U32)GetMember<I32>(inst, kNumIndices));
+        }
+        
+        // SerialiseCQKeys0 (Common/Animation.lua). read only
+        static Bool SerialiseCQKeys0(Stream& stream, ClassInstance& inst, Class* clazz, void* pMemory, Bool IsWrite)
+        {
+            static const MemberHandle kName{"_mName"};
+            static const MemberHandle kFlags{"_mFlags"};
+            static const MemberHandle kMinTime{"_mMinTime"};
+            static const MemberHandle kMaxTime{"_mMaxTime"};
+            static const MemberHandle kBuffer{"_mBuffer"};
+            
+            if(IsWrite)
+                return false;
+            
+            ClassInstance e{};
+            SerialiseString(stream, e, nullptr, &GetMember<String>(inst, kName), false);
+            
+            I32& flags = GetMember<I32>(inst, kFlags);
+            SerialiseU32(stream, e, nullptr, &flags, false);
+            SerialiseU32(stream, e, nullptr, &GetMember<Float>(inst, kMinTime), false);
+            SerialiseU32(stream, e, nullptr, &GetMember<Float>(inst, kMaxTime), false);
+            TTE_ASSERT(flags == 0 || flags == 512 || flags == 32 || flags == 16, "Check animation CQKeys");
+            
+            I16 numSamples = 0;
+            SerialiseU16(stream, e, nullptr, &numSamples, false);
+            
+            return _ReadBinaryBuffer(stream, GetMember<BinaryBuffer>(inst, kBuffer), (U32)numSamples * 6);
+        }
+        
+        // SerialiseCVKeys0 (Common/Animation.lua). read only
+        static Bool SerialiseCVKeys0(Stream& stream, ClassInstance& inst, Class* clazz, void* pMemory, Bool IsWrite)
+        {
+            static const MemberHandle kName{"_mName"};
+            static const MemberHandle kFlags{"_mFlags"};
+            static const MemberHandle kExtents[6] = {
+                MemberHandle{"_mV1X"}, MemberHandle{"_mV1Y"}, MemberHandle{"_mV1Z"}, MemberHandle{"_mV2X"}, MemberHandle{"_mV2Y"}, MemberHandle{"_mV2Z"}
+            };
+            static const MemberHandle kMinTime{"_mMinTime"};
+            static const MemberHandle kMaxTime{"_mMaxTime"};
+            static const MemberHandle kBuffer{"_mBuffer"};
+            
+            if(IsWrite)
+                return false;
+            
+            ClassInstance e{};
+            SerialiseString(stream, e, nullptr, &GetMember<String>(inst, kName), false);
+            
+            I32& flags = GetMember<I32>(inst, kFlags);
+            SerialiseU32(stream, e, nullptr, &flags, false);
+            TTE_ASSERT(flags == 0 || flags == 512 || flags == 32 || flags == 16, "Check animation CVKeys");
+            
+            for(U32 i = 0; i < 6; i++)
+                SerialiseU32(stream, e, nullptr, &GetMember<Float>(inst, kExtents[i]), false);
+            SerialiseU32(stream, e, nullptr, &GetMember<Float>(inst, kMinTime), false);
+            SerialiseU32(stream, e, nullptr, &GetMember<Float>(inst, kMaxTime), false);
+            
+            I16 numSamples = 0;
+            SerialiseU16(stream, e, nullptr, &numSamples, false);
+            
+            return _ReadBinaryBuffer(stream, GetMember<BinaryBuffer>(inst, kBuffer), (U32)numSamples * 6);
+        }
+        
+        void _RegisterNativeSerialisers()
+        {
+            RegisterNativeSerialiser("SerialiseD3DIndexBuffer0", &SerialiseD3DIndexBuffer0);
+            RegisterNativeSerialiser("SerialiseCQKeys0", &SerialiseCQKeys0);
+            RegisterNativeSerialiser("SerialiseCVKeys0", &SerialiseCVKeys0);
+        }
+    
+    }
+
+}
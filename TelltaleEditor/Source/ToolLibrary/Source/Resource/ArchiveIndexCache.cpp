@@ -0,0 +1,197 @@
+#include <Resource/ArchiveIndexCache.hpp>
+#include <Core/Symbol.hpp>
+#include <Meta/Meta.hpp>
+
+#include <filesystem>
+#include <cinttypes>
+
+#define ARCHIVE_INDEX_MAGIC 0x58444954 // 'TIDX'
+#define ARCHIVE_INDEX_FORMAT 1 // bump when the index format or archive index serialisation changes
+#define ARCHIVE_INDEX_CHECK_BYTES 0x10000 // bytes at the start of the archive which are checksummed
+
+namespace ArchiveIndexCache
+{
+    
+    // Identifies the archive on disk. If any of these change the index is stale.
+    struct ArchiveStamp
+    {
+        String Path;
+        U64 Size = 0;
+        U64 ModifiedTime = 0;
+        U64 HeaderChecksum = 0;
+    };
+    
+    static Bool _GetStamp(const String& archivePath, DataStreamRef& archiveStream, ArchiveStamp& stamp)
+    {
+        std::error_code ec{};
+        std::filesystem::path path = std::filesystem::absolute(std::filesystem::path(archivePath), ec);
+        if(ec || !std::filesystem::is_regular_file(path, ec) || !dynamic_cast<DataStreamFile*>(archiveStream.get()))
+            return false; // only archives which are files on disk
+        auto modified = std::filesystem::last_write_time(path, ec);
+        if(ec)
+            return false;
+        stamp.Path = path.lexically_normal().string();
+        stamp.Size = archiveStream->GetSize();
+        stamp.ModifiedTime = (U64)modified.time_since_epoch().count();
+        U32 headSize = (U32)std::min<U64>(stamp.Size, ARCHIVE_INDEX_CHECK_BYTES);
+        if(!headSize)
+        {
+            stamp.HeaderChecksum = CRC64(nullptr, 0);
+            return true;
+        }
+        U8* head = TTE_ALLOC(headSize, MEMORY_TAG_TEMPORARY); // heap, this runs on job threads during mounting
+        Bool ok = archiveStream->ReadAt(0, head, headSize);
+        if(ok)
+            stamp.HeaderChecksum = CRC64(head, headSize);
+        TTE_FREE(head);
+        return ok;
+    }
+    
+    static String _GetIndexPath(const String& cacheDirectory, const ArchiveStamp& stamp)
+    {
+        String directory = cacheDirectory;
+        if(!StringEndsWith(directory, "/") && !StringEndsWith(directory, "\\"))
+            directory += "/";
+        char name[32]{};
+        snprintf(name, 32, "%016" PRIX64 ".ttidx", CRC64LowerCase((const U8*)stamp.Path.c_str(), (U32)stamp.Path.length()));
+        return directory + name;
+    }
+    
+    static void _SerialiseHeader(DataStreamRef& stream, U32& kind, U32& version, ArchiveStamp& stamp, U64& bodySize, U64& bodyChecksum, Bool bWrite)
+    {
+        U32 value = ARCHIVE_INDEX_MAGIC;
+        SerialiseDataU32(stream, nullptr, &value, bWrite);
+        if(!bWrite && value != ARCHIVE_INDEX_MAGIC)
+        {
+            kind = 0;
+            return;
+        }
+        value = ARCHIVE_INDEX_FORMAT;
+        SerialiseDataU32(stream, nullptr, &value, bWrite);
+        if(!bWrite && value != ARCHIVE_INDEX_FORMAT)
+        {
+            kind = 0;
+            return;
+        }
+        SerialiseDataU32(stream, nullptr, &kind, bWrite);
+        SerialiseDataU32(stream, nullptr, &version, bWrite);
+        if(bWrite)
+            DataStreamManager::GetInstance()->WriteString(stream, stamp.Path);
+        else
+            stamp.Path = DataStreamManager::GetInstance()->ReadString(stream);
+        SerialiseDataU64(stream, nullptr, &stamp.Size, bWrite);
+        SerialiseDataU64(stream, nullptr, &stamp.ModifiedTime, bWrite);
+        SerialiseDataU64(stream, nullptr, &stamp.HeaderChecksum, bWrite);
+        SerialiseDataU64(stream, nullptr, &bodySize, bWrite);
+        SerialiseDataU64(stream, nullptr, &bodyChecksum, bWrite);
+    }
+    
+    template<typename Archive>
+    static Bool _Load(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, Archive& archive, U32 kind, U32 version)
+    {
+        ArchiveStamp stamp{};
+        if(cacheDirectory.empty() || !_GetStamp(archivePath, archiveStream, stamp))
+            return false;
+        String indexPath = _GetIndexPath(cacheDirectory, stamp);
+        std::error_code ec{};
+        if(!std::filesystem::is_regular_file(indexPath, ec))
+            return false; // check first, opening a file stream creates the file
+        
+        DataStreamRef indexFile = DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, indexPath));
+        U64 indexSize = indexFile ? indexFile->GetSize() : 0;
+        if(indexSize < 64)
+            return false;
+        U8* pIndex = TTE_ALLOC(indexSize, MEMORY_TAG_TEMPORARY);
+        if(!indexFile->Read(pIndex, indexSize))
+        {
+            TTE_FREE(pIndex);
+            return false;
+        }
+        indexFile.reset();
+        DataStreamRef index = DataStreamManager::GetInstance()->CreateBufferStream(ResourceURL(), indexSize, pIndex, true);
+        
+        U32 fileKind = kind, fileVersion = version;
+        ArchiveStamp fileStamp{};
+        U64 bodySize = 0, bodyChecksum = 0;
+        _SerialiseHeader(index, fileKind, fileVersion, fileStamp, bodySize, bodyChecksum, false);
+        U64 bodyOffset = index->GetPosition();
+        if(fileKind != kind || fileVersion != version || fileStamp.Path != stamp.Path || fileStamp.Size != stamp.Size ||
+           fileStamp.ModifiedTime != stamp.ModifiedTime || fileStamp.HeaderChecksum != stamp.HeaderChecksum ||
+           bodyOffset + bodySize != indexSize || bodySize > 0xFFFFFFFFull || CRC64(pIndex + bodyOffset, (U32)bodySize) != bodyChecksum)
+        {
+            TTE_LOG("Archive index for %s is stale, reading the archive", archivePath.c_str());
+            return false;
+        }
+        
+        if(!archive.SerialiseIndexIn(index, archiveStream))
+        {
+            archive.Reset();
+            return false;
+        }
+        return true;
+    }
+    
+    template<typename Archive>
+    static Bool _Store(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, const Archive& archive, U32 kind, U32 version)
+    {
+        ArchiveStamp stamp{};
+        if(cacheDirectory.empty() || !_GetStamp(archivePath, archiveStream, stamp))
+            return false;
+        
+        // serialise body into memory first, the header needs its checksum
+        DataStreamRef body = DataStreamManager::GetInstance()->CreatePrivateCache("");
+        if(!archive.SerialiseIndexOut(body, archiveStream))
+            return false;
+        U64 bodySize = body->GetSize();
+        if(bodySize > 0xFFFFFFFFull)
+            return false;
+        std::vector<U8> bodyBytes{};
+        bodyBytes.resize((size_t)bodySize);
+        body->SetPosition(0);
+        if(bodySize && !body->Read(bodyBytes.data(), bodySize))
+            return false;
+        body.reset();
+        U64 bodyChecksum = CRC64(bodyBytes.data(), (U32)bodySize);
+        
+        std::error_code ec{};
+        std::filesystem::create_directories(cacheDirectory, ec);
+        String indexPath = _GetIndexPath(cacheDirectory, stamp);
+        String tempPath = indexPath + ".tmp";
+        {
+            DataStreamRef out = DataStreamManager::GetInstance()->CreateFileStream(ResourceURL(ResourceScheme::FILE, tempPath));
+            if(!out)
+                return false;
+            _SerialiseHeader(out, kind, version, stamp, bodySize, bodyChecksum, true);
+            if(bodySize && !out->Write(bodyBytes.data(), bodySize))
+                return false;
+        }
+        std::filesystem::rename(tempPath, indexPath, ec); // replace any old index in one go, so a half written index is never read
+        if(ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+    
+    Bool Load(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, TTArchive& archive, U32 archiveVersion)
+    {
+        return _Load(cacheDirectory, archivePath, archiveStream, archive, 1, archiveVersion);
+    }
+    
+    Bool Load(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, TTArchive2& archive, U32 archiveVersion)
+    {
+        return _Load(cacheDirectory, archivePath, archiveStream, archive, 2, archiveVersion);
+    }
+    
+    Bool Store(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, const TTArchive& archive, U32 archiveVersion)
+    {
+        return _Store(cacheDirectory, archivePath, archiveStream, archive, 1, archiveVersion);
+    }
+    
+    Bool Store(const String& cacheDirectory, const String& archivePath, DataStreamRef& archiveStream, const TTArchive2& archive, U32 archiveVersion)
+    {
+        return _Store(cacheDirectory, archivePath, archiveStream, archive, 2, archiveVersion);
+    }
+    
+}
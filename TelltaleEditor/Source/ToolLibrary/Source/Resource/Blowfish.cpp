@@ -2,7 +2,7 @@
 
 // translation unit locals
 
-Blowfish* Blowfish::Instance = nullptr;
+Ptr<Blowfish> Blowfish::Instance{};
 
 namespace 
 {
@@ -18,14 +18,12 @@ namespace
 void Blowfish::Initialise(Bool mod, const U8* k, U32 kl)
 {
     Shutdown();
-    Instance = TTE_NEW(Blowfish, MEMORY_TAG_BLOWFISH, mod, k, kl);
+    Instance = TTE_NEW_PTR(Blowfish, MEMORY_TAG_BLOWFISH, mod, k, kl);
 }
 
 void Blowfish::Shutdown()
 {
-    if(Instance)
-        TTE_DEL(Instance);
-    Instance = nullptr;
+    Instance.reset(); // streams holding the shared instance keep it alive until they are done
 }
 
 // BLOWFISH CLASS (KEY MANAGEMENT)
@@ -34,44 +32,58 @@ Blowfish::Blowfish(Bool m, const U8* k, U32 kl)
 {
     TTE_ASSERT(kl <= 56, "Encryption key length can not be larger than 56");
     _KeyLength = MIN(kl, 56);
-    memcpy(_Key, k, _KeyLength);
     _Modified = m;
+    if(_KeyLength)
+        _Cipher.Init(k, _KeyLength, _Modified);
 }
 
-void Blowfish::Decrypt(U8* b, U32 len)
+void Blowfish::Decrypt(U8* b, U32 len) const
 {
     if(_KeyLength == 0)
         return; // no encryption
-    Cipher cipher{};
-    cipher.Init(_Key, _KeyLength, _Modified);
-    cipher.Crypt(false, _Modified, b, len);
+    _Cipher.Crypt(false, b, len);
 }
 
-void Blowfish::Encrypt(U8* b, U32 len)
+void Blowfish::Encrypt(U8* b, U32 len) const
 {
     if(_KeyLength == 0)
         return; // no encryption
-    Cipher cipher{};
-    cipher.Init(_Key, _KeyLength, _Modified);
-    cipher.Crypt(true, _Modified, b, len);
+    _Cipher.Crypt(true, b, len);
 }
 
 // FOR INFORMATION ON HOW THIS WORKS AND THE MODIFIED ENCRYPTION USED BY TELLTALE, SEE MY GITHUB (LUCASSARAGOSA) AND THE TELLTALE TOOL PAPER.
 
 // IMPLEMENTATION DETAIL:
 
-void Blowfish::Cipher::Crypt(Bool IsEnc, Bool modified, U8* b, U32 len)
+void Blowfish::Cipher::Crypt(Bool IsEnc, U8* b, U32 len) const
 {
+    const U32* Keys = IsEnc ? EncKeys : DecKeys;
     len >>= 3; // into blocks (/8)
     for(U32 i = 0; i < len; i++)
     {
-        _Do(IsEnc, modified, ((U32*)b)[0], ((U32*)b)[1]);
+        _DoScheduled(Keys, ((U32*)b)[0], ((U32*)b)[1]);
         b+=8;
     }
 }
 
+// same as _Do, but the P order (and modified remapping) is baked into the keys. same for encryption and decryption.
+void Blowfish::Cipher::_DoScheduled(const U32* Keys, U32& left, U32& right) const
+{
+    U32 l = left, r = right;
+    for(U32 i = 0; i < 16; i += 2)
+    {
+        l ^= Keys[i];
+        r ^= _DoRounds(l);
+        r ^= Keys[i + 1];
+        l ^= _DoRounds(r);
+    }
+    // undo last swap, then whiten
+    left = r ^ Keys[17];
+    right = l ^ Keys[16];
+}
+
 // perform actual encryption of a block (left and right U32s)
-void Blowfish::Cipher::_Do(Bool enc, Bool mod, U32& left, U32& right)
+void Blowfish::Cipher::_Do(Bool enc, Bool mod, U32& left, U32& right) const
 {
     U32 temp{}; // for swaps
     if(enc)
@@ -165,7 +177,7 @@ void Blowfish::Cipher::_Do(Bool enc, Bool mod, U32& left, U32& right)
     }
 }
 
-U32 Blowfish::Cipher::_DoRounds(U32 x)
+U32 Blowfish::Cipher::_DoRounds(U32 x) const
 {
     
     // EXTRACT EACH BYTE FROM X
@@ -185,7 +197,7 @@ U32 Blowfish::Cipher::_DoRounds(U32 x)
     return y;
 }
 
-void Blowfish::Cipher::Init(U8* ky, U32 kl, Bool modified)
+void Blowfish::Cipher::Init(const U8* ky, U32 kl, Bool modified)
 {
     // Standard blowfish initialisation routines
     
@@ -246,6 +258,26 @@ void Blowfish::Cipher::Init(U8* ky, U32 kl, Bool modified)
             S[i][j + 1] = datar;
         }
     }
+    
+    // Round keys for crypting. Modified swaps P 1<->3 and 2<->4 in encryption, and decryption mirrors that.
+    static const U32 ModEnc[4] = {3, 4, 1, 2};
+    for(U32 i = 0; i < 16; i++)
+        EncKeys[i] = P[(modified && i >= 1 && i <= 4) ? ModEnc[i - 1] : i];
+    EncKeys[16] = P[16];
+    EncKeys[17] = P[17];
+    for(U32 i = 17; i > 1; i--)
+    {
+        U32 index = i;
+        if(modified && i == 4)
+            index = 2;
+        else if(modified && i == 3)
+            index = 1;
+        else if(modified && i == 2)
+            index = 4;
+        DecKeys[17 - i] = P[index];
+    }
+    DecKeys[16] = P[modified ? 3 : 1];
+    DecKeys[17] = P[0];
 }
 
 // CONSTANTS
@@ -46,6 +46,19 @@ ResourceScheme StringToScheme(const String &scheme)
     }
 }
 
+// ===================================================================
+// BASE DATA STREAM
+// ===================================================================
+
+Bool DataStream::ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes)
+{
+    U64 pos = GetPosition();
+    SetPosition(Offset);
+    Bool result = Read(OutputBuffer, Nbytes);
+    SetPosition(pos);
+    return result;
+}
+
 // ===================================================================
 // ENCRYPTION DATA STREAM
 // ===================================================================
@@ -66,7 +79,10 @@ DataStreamEncryptionStream::DataStreamEncryptionStream(const ResourceURL& url,
         TTE_ASSERT(false, "Key invalid for AES128");
     }
     TTE_ASSERT(klen <= 56, "Key is too long");
-    memcpy(_EncryptionKey, k, MIN(56, klen));
+    _EncryptionKeyLength = MIN(56, klen);
+    memcpy(_EncryptionKey, k, _EncryptionKeyLength);
+    if(encryption == Encryption::BLOWFISH || encryption == Encryption::BLOWFISH_NEW)
+        _Blowfish = TTE_NEW_PTR(Blowfish, MEMORY_TAG_BLOWFISH, encryption == Encryption::BLOWFISH_NEW, _EncryptionKey, _EncryptionKeyLength);
 }
 
 void DataStreamEncryptionStream::_SaturateCache(U64 alignedoff)
@@ -82,8 +98,13 @@ void DataStreamEncryptionStream::_SaturateCache(U64 alignedoff)
     _EncryptionCacheReadAvail = (U32)MIN(MIN(65536, _Base->GetSize() - _BaseOffset - alignedoff), _MaxReadLen - alignedoff);
     if(_EncryptionCacheReadAvail)
     {
-        _Base->SetPosition(_BaseOffset + alignedoff);
-        _Base->Read(_EncryptionCache, _EncryptionCacheReadAvail);
+        // positional read, many encryption streams (eg playstation pkg entries) can share the same base stream across threads
+        if(!_Base->ReadAt(_BaseOffset + alignedoff, _EncryptionCache, _EncryptionCacheReadAvail))
+        {
+            TTE_ASSERT(false, "ERROR: In decrypting stream - could not read from base stream");
+            _EncryptionCacheReadAvail = 0;
+            return;
+        }
         if(_EncryptionType == Encryption::AES128_CTR)
         {
             AES128::CryptCTR(_EncryptionCache, _EncryptionCacheReadAvail,
@@ -91,9 +112,7 @@ void DataStreamEncryptionStream::_SaturateCache(U64 alignedoff)
         }
         else if(_EncryptionType == Encryption::BLOWFISH || _EncryptionType == Encryption::BLOWFISH_NEW)
         {
-            Bool bNew = _EncryptionType == Encryption::BLOWFISH_NEW;
-            Blowfish BF(bNew, _EncryptionKey, _EncryptionKeyLength);
-            BF.Decrypt(_EncryptionCache, _EncryptionCacheReadAvail);
+            _Blowfish->Decrypt(_EncryptionCache, _EncryptionCacheReadAvail);
         }
     }
 }
@@ -212,9 +231,7 @@ void DataStreamEncryptionStream::_Flush()
         }
         else if(_EncryptionType == Encryption::BLOWFISH || _EncryptionType == Encryption::BLOWFISH_NEW)
         {
-            Bool bNew = _EncryptionType == Encryption::BLOWFISH_NEW;
-            Blowfish BF(bNew, _EncryptionKey, _EncryptionKeyLength);
-            BF.Encrypt(_EncryptionCache, _EncryptionCachePointer);
+            _Blowfish->Encrypt(_EncryptionCache, _EncryptionCachePointer);
         }
         // else ...
         
@@ -375,6 +392,12 @@ DataStreamRef DataStreamManager::CreateContainerStream(const DataStreamRef& src)
     return DataStreamRef(pDS, &DataStreamDeleter);
 }
 
+DataStreamRef DataStreamManager::CreateContainerStream(const DataStreamRef& src, const ContainerLayout& layout)
+{
+    DataStreamContainer *pDS = TTE_NEW(DataStreamContainer, MEMORY_TAG_DATASTREAM, src, layout);
+    return DataStreamRef(pDS, &DataStreamDeleter);
+}
+
 DataStreamRef DataStreamManager::CreateCachedStream(const DataStreamRef& src)
 {
     if(!src || dynamic_cast<DataStreamBuffer*>(src.get()) || dynamic_cast<DataStreamMemory*>(src.get()))
@@ -463,6 +486,14 @@ DataStreamRef DataStreamManager::CreateSubStream(const DataStreamRef &p, U64 o,
     return DataStreamRef(pDSFile, &DataStreamDeleter);
 }
 
+DataStreamRef DataStreamManager::CreateSubStreamView(const DataStreamRef& stream)
+{
+    DataStreamSubStream* pSub = dynamic_cast<DataStreamSubStream*>(stream.get());
+    if(!pSub)
+        return stream;
+    return CreateSubStream(pSub->_Prnt, pSub->_BaseOff, pSub->_Size);
+}
+
 DataStreamRef DataStreamManager::CreateLegacyEncryptedStream(const DataStreamRef& src, U64 baseOffset, U16 blockSize, U8 rawf, U8 blowf)
 {
     DataStreamLegacyEncrypted* pDS = TTE_NEW(DataStreamLegacyEncrypted, MEMORY_TAG_DATASTREAM, src, baseOffset, blockSize, rawf, blowf);
@@ -528,24 +559,63 @@ Bool DataStreamManager::Transfer(DataStreamRef &src, DataStreamRef &dst, U64 Nby
 // ===================================================================
 
 Bool DataStreamFile::Read(U8 *OutputBuffer, U64 Nbytes)
+{
+    if(!ReadAt(_Position, OutputBuffer, Nbytes))
+        return false;
+    _Position += Nbytes;
+    return true;
+}
+
+Bool DataStreamFile::ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes)
 {
     TTE_ASSERT(_Handle != FileNull(), "File handle is null. Cannot read");
-    return FileRead(_Handle, OutputBuffer, Nbytes);
+    if(_Mapping && Offset + Nbytes <= _MappingSize)
+    {
+        memcpy(OutputBuffer, _Mapping + Offset, Nbytes);
+        return true;
+    }
+    return FileReadAt(_Handle, Offset, OutputBuffer, Nbytes);
 }
 
 Bool DataStreamFile::Write(const U8 *InputBuffer, U64 Nbytes)
 {
     TTE_ASSERT(_Handle != FileNull(), "File handle is null. Cannot write");
-    _MaxOffset = MAX(_MaxOffset, (GetPosition() + Nbytes));
-    return FileWrite(_Handle, InputBuffer, Nbytes);
+    if(_Mapping)
+        _Unmap(); // mapping may no longer match the file
+    _MaxOffset = MAX(_MaxOffset, (_Position + Nbytes));
+    if(!FileWriteAt(_Handle, _Position, InputBuffer, Nbytes))
+        return false;
+    _Position += Nbytes;
+    return true;
 }
 
-U64 DataStreamFile::GetPosition() { return FilePos(_Handle); }
+U64 DataStreamFile::GetPosition() { return _Position; }
+
+void DataStreamFile::SetPosition(U64 p) { _Position = p; }
+
+Bool DataStreamFile::MapReadOnly()
+{
+    if(_Mapping)
+        return true;
+    if(_Handle == FileNull())
+        return false;
+    U64 size = FileSize(_Handle);
+    _Mapping = FileMapReadOnly(_Handle, size);
+    _MappingSize = _Mapping ? size : 0;
+    return _Mapping != nullptr;
+}
 
-void DataStreamFile::SetPosition(U64 p) { FileSeek(_Handle, p); }
+void DataStreamFile::_Unmap()
+{
+    FileUnmap(_Mapping, _MappingSize);
+    _Mapping = nullptr;
+    _MappingSize = 0;
+}
 
 DataStreamFile::~DataStreamFile()
 {
+    if(_Mapping)
+        _Unmap();
     if (_Handle != FileNull())
     {
         FileClose(_Handle, _MaxOffset);
@@ -553,7 +623,7 @@ DataStreamFile::~DataStreamFile()
     }
 }
 
-DataStreamFile::DataStreamFile(const ResourceURL &url) : DataStream(url), _Handle(FileNull()), _MaxOffset(0)
+DataStreamFile::DataStreamFile(const ResourceURL &url) : DataStream(url), _Handle(FileNull()), _MaxOffset(0), _Position(0)
 {
     // Attempt to open the file
     String fpath = url.GetRawPath(); // Get the raw path without the scheme, and pass it to the file system to try and find the file.
@@ -744,6 +814,33 @@ Bool DataStreamDeferred::Read(U8 *OutputBuffer, U64 Nbytes)
     return true;
 }
 
+Bool DataStreamDeferred::ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes)
+{
+    if(!Nbytes)
+        return true;
+    
+    if (Offset + Nbytes > GetSize())
+    {
+        TTE_ASSERT(false, "Cannot read 0x%llx bytes from offset 0x%llx in deferred stream, not enough bytes", Nbytes, Offset);
+        return false;
+    }
+    
+    U64 pageIdx = Offset / _PageSize;
+    U64 pagePos = Offset % _PageSize;
+    
+    while(Nbytes)
+    {
+        U64 n = MIN(Nbytes, _PageSize - pagePos);
+        if(!_SerialisePage(pageIdx++, OutputBuffer, n, pagePos, false))
+            return false;
+        OutputBuffer += n;
+        Nbytes -= n;
+        pagePos = 0;
+    }
+    
+    return true;
+}
+
 Bool DataStreamDeferred::Write(const U8 *InputBuffer, U64 Nbytes)
 {
     if(!Nbytes)
@@ -939,6 +1036,13 @@ Bool DataStreamBuffer::Read(U8 *OutputBuffer, U64 Nbytes)
     return true;
 }
 
+Bool DataStreamBuffer::ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes)
+{
+    TTE_ASSERT(Offset + Nbytes <= _Size, "Trying to read too many bytes from buffer stream");
+    memcpy(OutputBuffer, _Buffer + Offset, Nbytes);
+    return true;
+}
+
 Bool DataStreamBuffer::Write(const U8 *InputBuffer, U64 Nbytes)
 {
     TTE_ASSERT(_Off + Nbytes <= _Size, "Trying to write too many bytes to buffer stream");
@@ -978,14 +1082,18 @@ void DataStreamBuffer::SetPosition(U64 pos)
 Bool DataStreamSubStream::Read(U8 *OutputBuffer, U64 Nbytes)
 {
     TTE_ASSERT(_Off + Nbytes <= _Size, "Trying to read too many bytes from sub stream");
-    if (_Prnt->GetPosition() != _BaseOff + _Off)
-        _Prnt->SetPosition(_BaseOff + _Off);
-    if(!_Prnt->Read(OutputBuffer, Nbytes))
+    if(!_Prnt->ReadAt(_BaseOff + _Off, OutputBuffer, Nbytes))
         return false;
     _Off += Nbytes;
     return true;
 }
 
+Bool DataStreamSubStream::ReadAt(U64 Offset, U8 *OutputBuffer, U64 Nbytes)
+{
+    TTE_ASSERT(Offset + Nbytes <= _Size, "Trying to read too many bytes from sub stream");
+    return _Prnt->ReadAt(_BaseOff + Offset, OutputBuffer, Nbytes);
+}
+
 Bool DataStreamSubStream::Write(const U8 *InputBuffer, U64 Nbytes)
 {
     TTE_ASSERT(_Off + Nbytes <= _Size, "Trying to write too many bytes to sub stream");
@@ -1022,13 +1130,14 @@ void DataStreamSubStream::SetPosition(U64 pos)
 // Delegate to _GetBlock
 Bool DataStreamLegacyEncrypted::_SerialisePage(U64 index, U8* Buffer, U64 n, U64 off, Bool)
 {
-    _GetBlock((U32)index);
+    U8 Rb[0x100]; // read back buffer (max block size is 256). local, so positional reads are reentrant
+    _GetBlock((U32)index, Rb);
     // Now read it (writes disabled)
-    memcpy(Buffer, _Rb + off, n);
+    memcpy(Buffer, Rb + off, n);
     return true;
 }
 
-void DataStreamLegacyEncrypted::_GetBlock(U32 i)
+void DataStreamLegacyEncrypted::_GetBlock(U32 i, U8* Rb)
 {
     // in macos boneville executable, function that reads this is at 0x478F6 (check with IDA or your choice), altho thats part of MetaStream class
     
@@ -1038,16 +1147,15 @@ void DataStreamLegacyEncrypted::_GetBlock(U32 i)
     
     U64 readSize = MIN(_PageSize, GetSize() - blockStartOffset); // the last page is left as is (raw)
     
-    _Prnt->SetPosition(_BaseOff + blockStartOffset); // set position
-    
-    TTE_ASSERT(_Prnt->Read(_Rb, readSize), "Failed to read block from parent stream"); // do read
+    Bool bRead = _Prnt->ReadAt(_BaseOff + blockStartOffset, Rb, readSize);
+    TTE_ASSERT(bRead, "Failed to read block from parent stream"); // do read
     
     if(readSize == _PageSize) // if they are not equal, then we are in the last block and its left as is.
     {
         
         if((i % _EncFreq) == 0) // if its a multiple or is the first block
         {
-            Blowfish::GetInstance()->Decrypt(_Rb, (U32)_PageSize); // blowfish decrypt this block
+            _Blowfish->Decrypt(Rb, (U32)_PageSize); // blowfish decrypt this block
         }
         else
         {
@@ -1060,7 +1168,7 @@ void DataStreamLegacyEncrypted::_GetBlock(U32 i)
                 // most common case. all bits are flipped. i dont know why this was thought, as its probably the worst encryption.
                 // at least maybe, idk, make the most common the blowfish? i mean, aren't archives encrypted anyway.. with the SAME encryption!?
                 for(U64 i = 0; i < (_PageSize); i++)
-                    _Rb[i] = _Rb[i] ^ 0xFF; // flip bits, ~
+                    Rb[i] = Rb[i] ^ 0xFF; // flip bits, ~
             }
         }
     }
@@ -1081,7 +1189,7 @@ DataStreamLegacyEncrypted::DataStreamLegacyEncrypted(const DataStreamRef& p, U64
     _BaseOff = o;
     _RawFreq = r;
     _EncFreq = bf;
-    memset(_Rb, 0, 0x100);
+    _Blowfish = Blowfish::GetSharedInstance();
 }
 
 // ===================================================================         APPEND STREAM
@@ -1230,6 +1338,181 @@ Bool DataStreamSequentialStream::Read(U8 *OutputBuffer, U64 Nbytes)
 // ===================================================================         CONTAINER (COMPRESSABLE) DATA STREAM
 // ===================================================================
 
+// Returns true if ReadAt on the stream does not share a cursor, so can be called from multiple threads at once.
+static Bool _SupportsConcurrentReadAt(const DataStreamRef& stream)
+{
+    if(dynamic_cast<DataStreamFile*>(stream.get()) || dynamic_cast<DataStreamBuffer*>(stream.get()))
+        return true;
+    if(DataStreamSubStream* pSub = dynamic_cast<DataStreamSubStream*>(stream.get()))
+        return _SupportsConcurrentReadAt(pSub->GetParent());
+    return false;
+}
+
+// Decompressed page cache for a container. Shared with read ahead jobs (which hold a reference), so containers can be released while they run.
+struct _ContainerPageCache
+{
+    
+    struct Page
+    {
+        U64 Index;
+        U8* Data; // decompressed page. null while pending
+        U64 LastUse; // tick of last access, for LRU eviction
+        Bool Pending; // read ahead job is decompressing this page
+    };
+    
+    std::mutex Lock; // locks pages, tick and stats
+    std::mutex ParentLock; // locks reads from the parent when its ReadAt is not thread safe
+    Bool LockParent = true; // false if the parent supports concurrent ReadAt (files, buffers and sub streams of those)
+    std::vector<Page> Pages;
+    U32 MaxPages = 1;
+    U32 ReadAhead = 0;
+    U64 Tick = 0;
+    ContainerCacheStats Stats;
+    
+    // decode info, copied from the container
+    DataStreamRef Parent;
+    U64 DataOffsetStart = 0;
+    U64 PageSize = 0;
+    Compression::Type Compression = Compression::ZLIB;
+    Bool Encrypted = false;
+    Ptr<const Blowfish> Cipher; // game key schedule at creation, if encrypted
+    
+    ~_ContainerPageCache()
+    {
+        for(auto& page: Pages)
+        {
+            if(page.Data)
+                TTE_FREE(page.Data);
+        }
+        Pages.clear();
+    }
+    
+    // Reads, decrypts and decompresses the page at the given compressed range into a new page buffer. Returns null on failure. Thread safe.
+    U8* Decode(U64 index, U64 compressedOffset, U64 compressedSize)
+    {
+        U8* compressed = TTE_ALLOC(compressedSize, MEMORY_TAG_TEMPORARY_ASYNC);
+        Bool ok = false;
+        if(LockParent)
+        {
+            std::lock_guard<std::mutex> G{ParentLock};
+            ok = Parent->ReadAt(DataOffsetStart + compressedOffset, compressed, compressedSize);
+        }
+        else
+            ok = Parent->ReadAt(DataOffsetStart + compressedOffset, compressed, compressedSize);
+        if(!ok)
+        {
+            TTE_LOG("Could not read page from container stream: index %lld", index);
+            TTE_FREE(compressed);
+            return nullptr;
+        }
+        
+        if(Encrypted)
+            Cipher->Decrypt(compressed, (U32)compressedSize);
+        
+        U8* page = TTE_ALLOC(PageSize, MEMORY_TAG_RUNTIME_BUFFER);
+        ok = Compression::Decompress(compressed, compressedSize, page, PageSize, Compression);
+        TTE_FREE(compressed);
+        if(!ok)
+        {
+            TTE_LOG("Decompression failed at data stream container");
+            TTE_FREE(page);
+            return nullptr;
+        }
+        return page;
+    }
+    
+    // Inserts the decoded page, evicting the least recently used page if full. Takes ownership of data. Call with the lock held.
+    // Returns the cached buffer for the index, or null if it could not be cached (all slots pending), in which case data is not taken.
+    U8* Insert(U64 index, U8* data)
+    {
+        for(auto& page: Pages)
+        {
+            if(page.Index == index)
+            {
+                if(page.Data) // another thread beat us to it
+                    TTE_FREE(data);
+                else
+                    page.Data = data;
+                page.Pending = false;
+                page.LastUse = ++Tick;
+                return page.Data;
+            }
+        }
+        if(Pages.size() < MaxPages)
+        {
+            Pages.push_back(Page{index, data, ++Tick, false});
+            return data;
+        }
+        Page* lru = nullptr;
+        for(auto& page: Pages)
+        {
+            if(!page.Pending && (!lru || page.LastUse < lru->LastUse))
+                lru = &page;
+        }
+        if(!lru)
+            return nullptr;
+        TTE_FREE(lru->Data);
+        *lru = Page{index, data, ++Tick, false};
+        return data;
+    }
+    
+    // Accumulates into the manager statistics too. Call with the lock held.
+    void Count(U64 hits, U64 misses, U64 inflated, U64 readAhead)
+    {
+        Stats.Hits += hits;
+        Stats.Misses += misses;
+        Stats.BytesInflated += inflated;
+        Stats.ReadAheadPages += readAhead;
+        if(DataStreamManager* pManager = DataStreamManager::GetInstance())
+        {
+            pManager->_ContainerHits += hits;
+            pManager->_ContainerMisses += misses;
+            pManager->_ContainerBytesInflated += inflated;
+            pManager->_ContainerReadAheadPages += readAhead;
+        }
+    }
+    
+};
+
+// Read ahead job argument
+struct _ContainerReadAheadRequest
+{
+    Ptr<_ContainerPageCache> Cache;
+    U64 Index;
+    U64 CompressedOffset;
+    U64 CompressedSize;
+};
+
+static Bool _AsyncContainerReadAhead(const JobThread& thread, void* pRequest, void*)
+{
+    _ContainerReadAheadRequest* request = (_ContainerReadAheadRequest*)pRequest;
+    _ContainerPageCache& cache = *request->Cache;
+    U8* page = cache.Decode(request->Index, request->CompressedOffset, request->CompressedSize);
+    {
+        std::lock_guard<std::mutex> G{cache.Lock};
+        if(page)
+        {
+            cache.Count(0, 0, cache.PageSize, 1);
+            if(!cache.Insert(request->Index, page))
+                TTE_FREE(page);
+        }
+        else
+        {
+            // failed, remove the pending slot so readers decode it themselves (and log the error)
+            for(auto it = cache.Pages.begin(); it != cache.Pages.end(); it++)
+            {
+                if(it->Index == request->Index && it->Pending)
+                {
+                    cache.Pages.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+    TTE_DEL(request);
+    return page != nullptr;
+}
+
 Bool DataStreamContainer::_SerialisePage(U64 index, U8 *Buffer, U64 Nbytes, U64 pageOffset, Bool IsWrite)
 {
     TTE_ASSERT(!IsWrite, "Cannot write to container stream directly"); // other functionality for this
@@ -1237,49 +1520,144 @@ Bool DataStreamContainer::_SerialisePage(U64 index, U8 *Buffer, U64 Nbytes, U64
     
     if(_Compressed)
     {
-        if(_CachedPageIndex != index)
+        _ContainerPageCache& cache = *_Cache;
         {
-            // cache new page index
-            U32 pageSize = (U32)(_PageOffsets[index+1] - _PageOffsets[index]);
-            _Prnt->SetPosition(_DataOffsetStart + _PageOffsets[index]);
-            if(!_Prnt->Read(_IntPage, pageSize))
-            {
-                TTE_LOG("Could not read page from container stream: index %lld", index);
-                return false;
-            }
-            
-            if(_Encrypted)
+            std::lock_guard<std::mutex> G{cache.Lock};
+            for(auto& page: cache.Pages)
             {
-                // decrypt
-                Blowfish::GetInstance()->Decrypt(_IntPage, pageSize);
+                if(page.Index == index && !page.Pending)
+                {
+                    page.LastUse = ++cache.Tick;
+                    memcpy(Buffer, page.Data + pageOffset, Nbytes);
+                    cache.Count(1, 0, 0, 0);
+                    return true;
+                }
             }
-            
-            // decompress
-            if(!Compression::Decompress(_IntPage, (U64)pageSize, _CachedPage, _PageSize, _Compression))
+        }
+        
+        // miss (or still pending in a read ahead job, in which case don't wait and decode it here)
+        U8* page = cache.Decode(index, _PageOffsets[index], _PageOffsets[index+1] - _PageOffsets[index]);
+        if(!page)
+            return false;
+        memcpy(Buffer, page + pageOffset, Nbytes);
+        
+        std::lock_guard<std::mutex> G{cache.Lock};
+        cache.Count(0, 1, _PageSize, 0);
+        if(!cache.Insert(index, page))
+            TTE_FREE(page);
+        
+        // post read ahead of the following pages which are not cached yet
+        if(cache.ReadAhead && JobScheduler::Instance)
+        {
+            U64 numPages = (U64)_PageOffsets.size() - 1;
+            for(U64 next = index + 1; next <= index + cache.ReadAhead && next < numPages; next++)
             {
-                TTE_LOG("Decompression failed at data stream container");
-                return false;
+                Bool present = false;
+                for(auto& cached: cache.Pages)
+                {
+                    if(cached.Index == next)
+                    {
+                        present = true;
+                        break;
+                    }
+                }
+                if(present)
+                    continue;
+                
+                // reserve a pending slot, if we can without evicting other pending pages
+                if(cache.Pages.size() < cache.MaxPages)
+                {
+                    cache.Pages.push_back(_ContainerPageCache::Page{next, nullptr, ++cache.Tick, true});
+                }
+                else
+                {
+                    _ContainerPageCache::Page* lru = nullptr;
+                    for(auto& cached: cache.Pages)
+                    {
+                        if(!cached.Pending && cached.Index != index && (!lru || cached.LastUse < lru->LastUse))
+                            lru = &cached;
+                    }
+                    if(!lru)
+                        break;
+                    TTE_FREE(lru->Data);
+                    *lru = _ContainerPageCache::Page{next, nullptr, ++cache.Tick, true};
+                }
+                
+                _ContainerReadAheadRequest* request = TTE_NEW(_ContainerReadAheadRequest, MEMORY_TAG_TEMPORARY_ASYNC);
+                request->Cache = _Cache;
+                request->Index = next;
+                request->CompressedOffset = _PageOffsets[next];
+                request->CompressedSize = _PageOffsets[next+1] - _PageOffsets[next];
+                JobDescriptor desc{};
+                desc.AsyncFunction = &_AsyncContainerReadAhead;
+                desc.Priority = JOB_PRIORITY_HIGH;
+                desc.UserArgA = request;
+                JobScheduler::Instance->Post(std::move(desc)); // dont need the handle, the job finishes into the cache
             }
-            
-            // update index
-            _CachedPageIndex = index;
-            
         }
         
-        // read from page
-        memcpy(Buffer, _CachedPage + pageOffset, Nbytes);
-        
         return true;
     }
     else
     {
-        _Prnt->SetPosition(_DataOffsetStart + (index * _PageSize) + pageOffset); // set pos and read normal
-        return _Prnt->Read(Buffer, Nbytes);
+        return _Prnt->ReadAt(_DataOffsetStart + (index * _PageSize) + pageOffset, Buffer, Nbytes); // read normal
+    }
+}
+
+void DataStreamContainer::SetCacheParameters(U32 maxPages, U32 readAheadPages)
+{
+    if(!_Cache)
+        return; // not compressed
+    std::lock_guard<std::mutex> G{_Cache->Lock};
+    _Cache->MaxPages = MAX(1u, maxPages);
+    _Cache->ReadAhead = MIN(readAheadPages, _Cache->MaxPages - 1); // always leave room for the page being read
+    // shrink: drop least recently used pages which are not pending
+    while(_Cache->Pages.size() > _Cache->MaxPages)
+    {
+        auto lru = _Cache->Pages.end();
+        for(auto it = _Cache->Pages.begin(); it != _Cache->Pages.end(); it++)
+        {
+            if(!it->Pending && (lru == _Cache->Pages.end() || it->LastUse < lru->LastUse))
+                lru = it;
+        }
+        if(lru == _Cache->Pages.end())
+            break; // pending pages will finish into the cache
+        TTE_FREE(lru->Data);
+        _Cache->Pages.erase(lru);
     }
 }
 
-DataStreamContainer::DataStreamContainer(const DataStreamRef& p) : DataStreamDeferred(p->GetURL(), 0x10000), _CachedPage(nullptr),
-_Valid(false), _Compressed(false), _Encrypted(false), _Compression(Compression::ZLIB),  _CachedPageIndex(0)
+ContainerCacheStats DataStreamContainer::GetCacheStats()
+{
+    if(!_Cache)
+        return {};
+    std::lock_guard<std::mutex> G{_Cache->Lock};
+    return _Cache->Stats;
+}
+
+void DataStreamManager::SetContainerCacheDefaults(U32 maxPages, U32 readAheadPages)
+{
+    _ContainerCachePages = MAX(1u, maxPages);
+    _ContainerReadAhead = readAheadPages;
+}
+
+ContainerCacheStats DataStreamManager::GetContainerCacheStats()
+{
+    ContainerCacheStats stats{};
+    stats.Hits = _ContainerHits;
+    stats.Misses = _ContainerMisses;
+    stats.BytesInflated = _ContainerBytesInflated;
+    stats.ReadAheadPages = _ContainerReadAheadPages;
+    return stats;
+}
+
+void DataStreamManager::ResetContainerCacheStats()
+{
+    _ContainerHits = _ContainerMisses = _ContainerBytesInflated = _ContainerReadAheadPages = 0;
+}
+
+DataStreamContainer::DataStreamContainer(const DataStreamRef& p) : DataStreamDeferred(p->GetURL(), 0x10000),
+_Valid(false), _Compressed(false), _Encrypted(false), _Compression(Compression::ZLIB)
 {
     _Prnt = p; // set parent
     U32 Magic = {}; // top 3 bytes should be TTC - telltale container
@@ -1349,17 +1727,55 @@ _Valid(false), _Compressed(false), _Encrypted(false), _Compression(Compression::
         
         _Size = WindowSize * NumPages; // total uncompressed size
         
-        _CachedPageIndex = (U64)-1; // init cache page to none yet
-        _CachedPage = TTE_ALLOC(WindowSize, MEMORY_TAG_RUNTIME_BUFFER);
-        _IntPage = TTE_ALLOC(WindowSize, MEMORY_TAG_RUNTIME_BUFFER);
+        _CreateCache();
         
     }
     
     _Valid = true; // DONE
 }
 
+DataStreamContainer::DataStreamContainer(const DataStreamRef& p, const ContainerLayout& layout) : DataStreamDeferred(p->GetURL(), layout.PageSize ? layout.PageSize : 0x10000),
+_Valid(true), _Compressed(layout.Compressed), _Encrypted(layout.Encrypted), _Compression((Compression::Type)layout.Compression)
+{
+    _Prnt = p;
+    _Size = layout.Size;
+    _DataOffsetStart = layout.DataOffsetStart;
+    _PageOffsets = layout.PageOffsets;
+    if(_Compressed)
+        _CreateCache();
+}
+
+void DataStreamContainer::_CreateCache()
+{
+    // page cache. read ahead jobs are passed the compressed page range, so the cache doesn't need the offsets
+    _Cache = TTE_NEW_PTR(_ContainerPageCache, MEMORY_TAG_DATASTREAM);
+    _Cache->Parent = _Prnt;
+    _Cache->LockParent = !_SupportsConcurrentReadAt(_Prnt);
+    _Cache->DataOffsetStart = _DataOffsetStart;
+    _Cache->PageSize = _PageSize;
+    _Cache->Compression = _Compression;
+    _Cache->Encrypted = _Encrypted;
+    _Cache->Cipher = _Encrypted ? Blowfish::GetSharedInstance() : nullptr;
+    DataStreamManager* pManager = DataStreamManager::GetInstance();
+    SetCacheParameters(pManager ? pManager->_ContainerCachePages.load() : 4, pManager ? pManager->_ContainerReadAhead.load() : 0);
+}
+
+ContainerLayout DataStreamContainer::GetLayout() const
+{
+    ContainerLayout layout{};
+    layout.Size = _Size;
+    layout.DataOffsetStart = _DataOffsetStart;
+    layout.PageSize = _PageSize;
+    layout.Compression = (U32)_Compression;
+    layout.Compressed = _Compressed;
+    layout.Encrypted = _Encrypted;
+    layout.PageOffsets = _PageOffsets;
+    return layout;
+}
+
 #define CONTAINER_BULK_SIZE 16
 #define MAX_FOOTPRINT_MB 512
+#define CONTAINER_MAX_SLAVES 8 // maximum number of threads compressing pages
 
 struct _AsyncContainerContext
 {
@@ -1373,18 +1789,18 @@ struct _AsyncContainerContext
     volatile U32 FlushIndex; // next page index to be flushed (always a multiple of BulkSize)
     std::vector<U32> FinalCompressedSizes;
     
-    U32 NumSlaves; // number of threads, including master, actively running and compressing pages. between 1 and NUM_SCHEDULER_THREADS.
+    U32 NumSlaves; // number of threads, including master, actively running and compressing pages. between 1 and CONTAINER_MAX_SLAVES.
     U32 NumPages; // total number of pages to be compressed
     U32 MaxPendingFlushes; // maximum number of pages which can fit in to the stashed pending buffer for each thread
     U64 SrcSize; // total bytes in from src to read
     U64 SrcDataStart; // position in src to start reading SrcSize bytes from
     U64 DstContainerStart; // position in dst stream of magic bytes for container
     
-    U8* WorkingBuffersIn[NUM_SCHEDULER_THREADS]; // inputs for each thread
-    U8* WorkingBuffersOut[NUM_SCHEDULER_THREADS]; // output for each thread
-    U8* OverflowWorkingOut[NUM_SCHEDULER_THREADS]; // if compression is larger than uncompressed size. size of each is 2*0x10000
+    U8* WorkingBuffersIn[CONTAINER_MAX_SLAVES]; // inputs for each thread
+    U8* WorkingBuffersOut[CONTAINER_MAX_SLAVES]; // output for each thread
+    U8* OverflowWorkingOut[CONTAINER_MAX_SLAVES]; // if compression is larger than uncompressed size. size of each is 2*0x10000
     
-    U8* StashedPending[NUM_SCHEDULER_THREADS];
+    U8* StashedPending[CONTAINER_MAX_SLAVES];
     
     // information
     Compression::Type Compression;
@@ -1652,7 +2068,7 @@ static Bool _AsyncCreateContainerMaster(const JobThread* pThread, void* pCtx, vo
         TempMemory += ctx->MaxPendingFlushes * 0x10000 * CONTAINER_BULK_SIZE;
     }
     
-    JobHandle Handles[NUM_SCHEDULER_THREADS-1]{}; // job handles to wait after
+    JobHandle Handles[CONTAINER_MAX_SLAVES-1]{}; // job handles to wait after
     
     // 5. if we have any remaining pages, read them first here.
     U32 RemPages = ctx->NumPages % CONTAINER_BULK_SIZE;
@@ -1672,7 +2088,7 @@ static Bool _AsyncCreateContainerMaster(const JobThread* pThread, void* pCtx, vo
         ProcessedPageBulk remBlk{};
         
         // 5. kick off other slave jobs (not 0, thats here)
-        JobDescriptor Descriptors[NUM_SCHEDULER_THREADS-1];
+        JobDescriptor Descriptors[CONTAINER_MAX_SLAVES-1];
         for(U32 i = 1; i < ctx->NumSlaves; i++)
         {
             Descriptors[i-1].AsyncFunction = &_AsyncCreateContainerSlave;
@@ -1831,6 +2247,7 @@ Bool DataStreamManager::FlushContainer(DataStreamRef& src, U64 n, DataStreamRef&
             pContext->Encrypt = p.Encrypt;
             // pages 32 to 1024 use 2 slaves, 1024 to 4096 use 4, else 8
             pContext->NumSlaves = nPages > 4096 ? 8 : nPages > 1024 ? 4 : 2;
+            pContext->NumSlaves = MIN(pContext->NumSlaves, JobScheduler::Instance->GetNumWorkerThreads()); // slaves need a worker each
             pContext->NumPages = nPages;
             
             JobDescriptor desc{};
@@ -1,6 +1,10 @@
 #include <Resource/PropertySet.hpp>
 #include <cstdio>
 
+// members accessed on every property set lookup
+static const Meta::MemberHandle kParentListMember{"mParentList"};
+static const Meta::MemberHandle kFlagsMember{"mFlags"};
+
 // get prop at stack index.
 static Meta::ClassInstance luaProp(LuaManager& man, I32 index)
 {
@@ -564,7 +568,7 @@ void PropertySet::InjectScriptAPI(LuaFunctionCollection& Col)
 
 void PropertySet::MoveParentToFront(Meta::ClassInstance prop, Symbol parent)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if (parentMember)
     {
         Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
@@ -583,6 +587,7 @@ void PropertySet::MoveParentToFront(Meta::ClassInstance prop, Symbol parent)
         Meta::ClassInstance global = Meta::CreateInstance(Meta::FindClass(PropertySet::ClassHandle, 0)); // not a common class (its Handle<>) so OK
         Meta::ImportCoercableInstance(parent, global);
         array.Insert({}, std::move(global), 0, false, false);
+        InvalidateResolvedKeys(prop);
     }
 }
 
@@ -616,22 +621,12 @@ HandlePropertySet PropertySet::GetPropertySetValueIsRetrievedFrom(Meta::ClassIns
         hMyself.SetObject(pRegistry->LocateResource(prop._GetInternal()));
         return hMyself;
     }
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
-    if (parentMember)
+    Symbol owner{};
+    if(FindResolvedKey(prop, keyName, pRegistry, nullptr, &owner))
     {
-        Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
-        for (U32 i = 0; i < array.GetSize(); ++i)
-        {
-            Meta::ClassInstance parent = array.GetValue(i);
-            HandlePropertySet hParent{};
-            Meta::ExtractCoercableInstance(hParent, parent);
-            Meta::ClassInstance resolvedParent = hParent.GetObject(pRegistry, true);
-            if (!resolvedParent)
-                continue;
-            HandlePropertySet found = GetPropertySetValueIsRetrievedFrom(resolvedParent, keyName, pRegistry, true);
-            if (found)
-                return found;
-        }
+        HandlePropertySet hOwner{};
+        hOwner.SetObject(owner);
+        return hOwner;
     }
     
     return {};
@@ -648,7 +643,7 @@ HandlePropertySet _DoGetPSKIntroducedFrom(Meta::ClassInstance prop, Symbol KeyNa
     }
     
     // Traverse mParentList
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if (parentMember)
     {
         Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
@@ -743,7 +738,7 @@ void PropertySet::ImportKeysValuesAndParents(Meta::ClassInstance prop, Meta::Cla
 
 void PropertySet::GetParents(Meta::ClassInstance prop, std::set<HandlePropertySet>& parents, Bool bSearchParents, Ptr<ResourceRegistry> pRegistry)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if(parentMember)
     {
         Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
@@ -808,27 +803,124 @@ Meta::ClassInstance PropertySet::Get(Meta::ClassInstance prop, Symbol key, Bool
     auto it = prop._GetInternalChildrenRefs()->find(key);
     if(it == prop._GetInternalChildrenRefs()->end())
     {
-        Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
-        if(parentMember)
+        Meta::ClassInstance value{};
+        FindResolvedKey(prop, key, pRegistry, &value, nullptr);
+        return value;
+    }
+    return it->second;
+}
+
+// appends the keys of all parents of prop, depth first. same search order as the original recursive parent walk
+void PropertySet::ResolveParentKeys(InternalData& data, Meta::ClassInstance prop, Ptr<ResourceRegistry>& pRegistry)
+{
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
+    if(!parentMember)
+        return;
+    Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
+    for(U32 i = 0; i < array.GetSize(); i++)
+    {
+        Meta::ClassInstance handle = array.GetValue(i);
+        HandlePropertySet hProp{};
+        Meta::ExtractCoercableInstance(hProp, handle);
+        ResolvedSet visited{};
+        visited.Name = hProp.GetObject();
+        Meta::ClassInstance parent = pRegistry ? hProp.GetObject(pRegistry, true) : Meta::ClassInstance{};
+        if(!parent)
         {
-            Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
-            for(U32 i = 0; i < array.GetSize(); i++)
+            data.ResolvedSets.push_back(std::move(visited));
+            continue;
+        }
+        visited.Data = (InternalData*)parent._GetInternalPropertySetData();
+        Bool bVisited = false;
+        for(const auto& set: data.ResolvedSets)
+        {
+            if(set.Data == visited.Data)
+            {
+                bVisited = true; // shared ancestor (or a cycle). its keys are already in
+                break;
+            }
+        }
+        if(bVisited)
+            continue;
+        visited.Memory = parent.ObtainParentRef();
+        visited.Keys = parent._GetInternalChildrenRefs();
+        visited.Revision = visited.Data->Revision;
+        visited.NumKeys = (U32)visited.Keys->size();
+        U32 owner = (U32)data.ResolvedSets.size();
+        data.ResolvedSets.push_back(std::move(visited));
+        for(auto& key: *parent._GetInternalChildrenRefs())
+            data.ResolvedKeys.emplace(key.first, ResolvedKey{key.second, owner}); // first found wins
+        ResolveParentKeys(data, parent, pRegistry);
+    }
+}
+
+PropertySet::InternalData& PropertySet::ResolveKeys(Meta::ClassInstance prop, Ptr<ResourceRegistry>& pRegistry)
+{
+    InternalData& data = *((InternalData*)prop._GetInternalPropertySetData());
+    if(data.bResolved)
+    {
+        Bool bStale = false;
+        for(const ResolvedSet& set: data.ResolvedSets)
+        {
+            if(!set.Data)
             {
-                prop = array.GetValue(i);
                 HandlePropertySet hProp{};
-                Meta::ExtractCoercableInstance(hProp, prop);
-                prop = hProp.GetObject(pRegistry, true);
-                if (prop)
-                {
-                    prop = Get(prop, key, true, pRegistry);
-                    if (prop)
-                        return prop;
-                }
+                hProp.SetObject(set.Name);
+                bStale = pRegistry && hProp.GetObject(pRegistry, false); // parent has since been loaded
             }
+            else
+            {
+                bStale = (set.Data != &data && set.Memory.expired()) || set.Data->Revision != set.Revision || set.Keys->size() != set.NumKeys;
+            }
+            if(bStale)
+                break;
         }
-        return {};
+        if(!bStale)
+            return data;
     }
-    return it->second;
+    data.ResolvedSets.clear();
+    data.ResolvedKeys.clear();
+    ResolvedSet myself{};
+    myself.Data = &data;
+    myself.Keys = prop._GetInternalChildrenRefs();
+    myself.Revision = data.Revision;
+    myself.NumKeys = (U32)myself.Keys->size();
+    data.ResolvedSets.push_back(std::move(myself));
+    ResolveParentKeys(data, prop, pRegistry);
+    data.bResolved = true;
+    return data;
+}
+
+Bool PropertySet::FindResolvedKey(Meta::ClassInstance prop, Symbol key, Ptr<ResourceRegistry>& pRegistry, Meta::ClassInstance* pOutValue, Symbol* pOutOwner)
+{
+    InternalData& data = *((InternalData*)prop._GetInternalPropertySetData());
+    std::lock_guard<std::mutex> G{data.ResolveLock};
+    ResolveKeys(prop, pRegistry);
+    auto resolved = data.ResolvedKeys.find(key);
+    if(resolved != data.ResolvedKeys.end())
+    {
+        // the value may have been replaced under the same name without a revision change, then the whole cache is rebuilt
+        const ResolvedSet& owner = data.ResolvedSets[resolved->second.Owner];
+        auto live = owner.Keys->find(key);
+        if(live == owner.Keys->end() || live->second._GetInternal() != resolved->second.Value._GetInternal())
+        {
+            data.bResolved = false;
+            ResolveKeys(prop, pRegistry);
+            resolved = data.ResolvedKeys.find(key);
+        }
+    }
+    if(resolved == data.ResolvedKeys.end())
+        return false;
+    if(pOutValue)
+        *pOutValue = resolved->second.Value;
+    if(pOutOwner)
+        *pOutOwner = data.ResolvedSets[resolved->second.Owner].Name;
+    return true;
+}
+
+void PropertySet::InvalidateResolvedKeys(Meta::ClassInstance prop)
+{
+    ((InternalData*)prop._GetInternalPropertySetData())->Revision++;
 }
 
 void PropertySet::Set(Meta::ClassInstance prop, Symbol key, Meta::ClassInstance value, Ptr<ResourceRegistry> pRegistry, SetPropertyMode mode)
@@ -858,6 +950,7 @@ void PropertySet::Set(Meta::ClassInstance prop, Symbol key, Meta::ClassInstance
 
 void PropertySet::MarkModified(Meta::ClassInstance prop, Symbol Key, Ptr<ResourceRegistry> pRegistry)
 {
+    InvalidateResolvedKeys(prop);
     auto& callbacks = ((InternalData*)prop._GetInternalPropertySetData())->KeyCallbacks;
     FunctionDummy D{};
     Ptr<FunctionBase> dummy = TTE_PROXY_PTR(&D, FunctionDummy);
@@ -877,28 +970,15 @@ void PropertySet::MarkModified(Meta::ClassInstance prop, Symbol Key, Ptr<Resourc
 
 U32& PropertySet::GetFlags(Meta::ClassInstance prop)
 {
-    return Meta::GetMember<U32>(prop, "mFlags");
+    return Meta::GetMember<U32>(prop, kFlagsMember);
 }
 
 Bool PropertySet::ExistsKey(Meta::ClassInstance prop, Symbol keyName, Bool bSearchParents, Ptr<ResourceRegistry> pRegistry)
 {
-    Symbol kn = keyName;
-    for(auto& local: *prop._GetInternalChildrenRefs())
-    {
-        if(kn == local.first)
-            return true;
-    }
+    if(prop._GetInternalChildrenRefs()->find(keyName) != prop._GetInternalChildrenRefs()->end())
+        return true;
     if(bSearchParents)
-    {
-        std::set<HandlePropertySet> parents{};
-        GetParents(prop, parents, true, pRegistry);
-        for(auto prnt: parents)
-        {
-            Meta::ClassInstance pProp = prnt.GetObject(pRegistry, true);
-            if(pProp && pProp != prop && ExistsKey(pProp, keyName, false, pRegistry))
-                return true;
-        }
-    }
+        return FindResolvedKey(prop, keyName, pRegistry, nullptr, nullptr);
     return false;
 }
 
@@ -914,30 +994,32 @@ Bool PropertySet::IsMyParent(Meta::ClassInstance prop, Symbol parent, Bool bSear
 
 void PropertySet::ClearKeys(Meta::ClassInstance prop)
 {
+    InvalidateResolvedKeys(prop);
     prop._GetInternalChildrenRefs()->clear();
 }
 
 void PropertySet::ClearParents(Meta::ClassInstance prop)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if(parentMember)
     {
         Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
         array.Clear();
+        InvalidateResolvedKeys(prop);
     }
 }
 
 void PropertySet::AddParent(Meta::ClassInstance prop, Symbol parent, Ptr<ResourceRegistry> pRegistry)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if(parentMember)
     {
         Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
         for(U32 i = 0; i < array.GetSize(); i++)
         {
-            prop = array.GetValue(i);
+            Meta::ClassInstance existing = array.GetValue(i);
             HandlePropertySet hProp{};
-            Meta::ExtractCoercableInstance(hProp, prop);
+            Meta::ExtractCoercableInstance(hProp, existing);
             Symbol name = hProp.GetObject();
             if(name == parent)
                 return;
@@ -947,6 +1029,7 @@ void PropertySet::AddParent(Meta::ClassInstance prop, Symbol parent, Ptr<Resourc
         Meta::ClassInstance handle = Meta::CreateInstance(Meta::FindClass(PropertySet::ClassHandle, 0));
         Meta::ImportCoercableInstance(hParent, handle);
         array.PushValue(handle, false);
+        InvalidateResolvedKeys(prop);
         Meta::ClassInstance resolvedParent = hParent.GetObject(pRegistry, true);
         HandlePropertySet hMyself{};
         hMyself.SetObject(pRegistry->LocateResource(prop._GetInternal()));
@@ -996,7 +1079,7 @@ Bool PropertySet::ContainsAllKeys(Meta::ClassInstance prop, Meta::ClassInstance
 
 Bool PropertySet::ExistsParentKey(Meta::ClassInstance prop, Symbol KeyName, Ptr<ResourceRegistry> pRegistry)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if(parentMember)
     {
         Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
@@ -1021,7 +1104,7 @@ void PropertySet::GetKeys(Meta::ClassInstance prop, std::set<Symbol> &keys, Bool
     }
     if(bSearchParents)
     {
-        Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+        Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
         if(parentMember)
         {
             Meta::ClassInstanceCollection& array = Meta::CastToCollection(parentMember);
@@ -1040,7 +1123,7 @@ void PropertySet::GetKeys(Meta::ClassInstance prop, std::set<Symbol> &keys, Bool
 
 U32 PropertySet::GetNumParents(Meta::ClassInstance prop)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if(parentMember)
     {
         return Meta::CastToCollection(parentMember).GetSize();
@@ -1071,6 +1154,7 @@ Bool PropertySet::PromoteKeyToLocal(Meta::ClassInstance prop, Symbol KeyName, Pt
                 return false; // already local
         }
         prop._GetInternalChildrenRefs()->operator[](KeyName) = Meta::CopyInstance(clazz);
+        InvalidateResolvedKeys(prop);
         return true;
     }
     return false;
@@ -1080,12 +1164,15 @@ void PropertySet::RemoveKey(Meta::ClassInstance prop, Symbol KeyName)
 {
     auto it = prop._GetInternalChildrenRefs()->find(KeyName);
     if(it != prop._GetInternalChildrenRefs()->end())
+    {
         prop._GetInternalChildrenRefs()->erase(it);
+        InvalidateResolvedKeys(prop);
+    }
 }
 
 void PropertySet::RemoveParent(Meta::ClassInstance prop, Symbol parent, Bool bDiscardLocalKeys, Ptr<ResourceRegistry> pRegistry)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     if(parentMember)
     {
         HandlePropertySet hProp{};
@@ -1100,6 +1187,7 @@ void PropertySet::RemoveParent(Meta::ClassInstance prop, Symbol parent, Bool bDi
             {
                 Meta::ClassInstance old{};
                 array.PopValue(i, old);
+                InvalidateResolvedKeys(prop);
                 bRemoved = true;
                 break;
             }
@@ -1120,7 +1208,7 @@ void PropertySet::RemoveParent(Meta::ClassInstance prop, Symbol parent, Bool bDi
 
 void PropertySet::PostLoad(Meta::ClassInstance prop, Ptr<ResourceRegistry> pRegistry)
 {
-    Meta::ClassInstance parentMember = Meta::GetMember(prop, "mParentList", true);
+    Meta::ClassInstance parentMember = Meta::GetMember(prop, kParentListMember, true);
     Symbol myName = pRegistry->LocateResource(prop._GetInternal());
     if(parentMember)
     {
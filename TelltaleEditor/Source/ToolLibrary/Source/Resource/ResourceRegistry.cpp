@@ -1,5 +1,6 @@
 #include <Resource/ResourceRegistry.hpp>
 #include <Core/Context.hpp>
+#include <Resource/ArchiveIndexCache.hpp>
 
 #include <filesystem>
 
@@ -432,17 +433,7 @@ String RegistryDirectory_TTArchive::GetResourceName(const Symbol& resource)
 
 Bool RegistryDirectory_TTArchive::DeleteResource(const Symbol& resource)
 {
-    for(auto it = _Archive._Files.begin(); it != _Archive._Files.end(); )
-    {
-        if(resource == it->Name)
-        {
-            _Archive._Files.erase(it);
-            return true;
-        }
-        else ++it;
-    }
-    
-    return false;
+    return _Archive.RemoveFile(resource);
 }
 
 Bool RegistryDirectory_TTArchive::RenameResource(const Symbol& resource, const String& newName)
@@ -452,15 +443,7 @@ Bool RegistryDirectory_TTArchive::RenameResource(const Symbol& resource, const S
         TTE_LOG("When renaming to %s: a resource already exists with this name", newName.c_str());
         return false;
     }
-    for(auto it = _Archive._Files.begin(); it != _Archive._Files.end(); )
-    {
-        if(resource == it->Name)
-        {
-            it->Name = newName;
-            break;
-        }
-        else ++it;
-    }
+    _Archive.RenameFile(resource, newName);
     
     return true;
 }
@@ -522,7 +505,7 @@ Bool RegistryDirectory_TTArchive::GetResources(std::vector<std::pair<Symbol, Ptr
     {
         if(optionalMask && *optionalMask != file.Name)
             continue;
-        resources.push_back(std::make_pair(Symbol(file.Name), self));
+        resources.push_back(std::make_pair(file.NameSymbol, self));
     }
     
     return true;
@@ -972,17 +955,7 @@ String RegistryDirectory_TTArchive2::GetResourceName(const Symbol& resource)
 
 Bool RegistryDirectory_TTArchive2::DeleteResource(const Symbol& resource)
 {
-    for(auto it = _Archive._Files.begin(); it != _Archive._Files.end(); )
-    {
-        if(resource == it->Name)
-        {
-            _Archive._Files.erase(it);
-            return true;
-        }
-        else ++it;
-    }
-    
-    return false;
+    return _Archive.RemoveFile(resource);
 }
 
 Bool RegistryDirectory_TTArchive2::RenameResource(const Symbol& resource, const String& newName)
@@ -992,15 +965,7 @@ Bool RegistryDirectory_TTArchive2::RenameResource(const Symbol& resource, const
         TTE_LOG("When renaming to %s: a resource already exists with thie name", newName.c_str());
         return false;
     }
-    for(auto it = _Archive._Files.begin(); it != _Archive._Files.end(); )
-    {
-        if(resource == it->Name)
-        {
-            it->Name = newName;
-            break;
-        }
-        else ++it;
-    }
+    _Archive.RenameFile(resource, newName);
     
     return true;
 }
@@ -1059,7 +1024,7 @@ Bool RegistryDirectory_TTArchive2::GetResources(std::vector<std::pair<Symbol, Pt
         if(optionalMask && *optionalMask != file.Name)
             continue;
         
-        resources.push_back(std::make_pair(Symbol(file.Name), self));
+        resources.push_back(std::make_pair(file.NameSymbol, self));
     }
     
     return true;
@@ -2032,6 +1997,12 @@ void ResourceRegistry::CreateConcreteDirectoryLocation(const String &_name, cons
     }
 }
 
+void ResourceRegistry::SetArchiveIndexCache(const String& directory)
+{
+    SCOPE_LOCK();
+    _ArchiveIndexCacheDirectory = directory;
+}
+
 StringMask ResourceRegistry::_ArchivesMask(Bool bLegacy)
 {
     return bLegacy ? StringMask("*.ttarch;*.iso;*.pk2;*.tta") : StringMask("*.ttarch2;*.iso");
@@ -2049,23 +2020,41 @@ Bool ResourceRegistry::_ImportArchivePack(const String& resourceName, const Stri
                                           const String& archivePhysicalPath, const String& pkKey,
                                           DataStreamRef& archiveStream, std::unique_lock<std::recursive_mutex>& lck)
 {
+    // archives on disk are only read from here on. map them so entry reads from any thread are just copies
+    if(DataStreamFile* pFile = dynamic_cast<DataStreamFile*>(archiveStream.get()))
+        pFile->MapReadOnly();
+    
     // create archive location
     StringMask maskTTArch1 = "*.ttarch;*.tta";
     StringMask maskTTArch2 = "*.ttarch2";
     if(resourceName == maskTTArch1)
     {
-        TTArchive arc{ GetToolContext()->GetActiveGame()->GetArchiveVersion(GetToolContext()->GetSnapshot()) };
+        U32 version = GetToolContext()->GetActiveGame()->GetArchiveVersion(GetToolContext()->GetSnapshot());
+        TTArchive arc{ version };
+        String cacheDirectory = _ArchiveIndexCacheDirectory;
+        DataStreamRef archiveFile = archiveStream; // serialise in can replace the stream with a wrapper
         lck.unlock(); // may take time, dont keep everyone waiting!
-        TTE_ASSERT(arc.SerialiseIn(archiveStream), "TTArchive serialise/read fail!");
+        if(!ArchiveIndexCache::Load(cacheDirectory, archivePhysicalPath, archiveFile, arc, version))
+        {
+            TTE_ASSERT(arc.SerialiseIn(archiveStream), "TTArchive serialise/read fail!");
+            ArchiveIndexCache::Store(cacheDirectory, archivePhysicalPath, archiveFile, arc, version);
+        }
         lck.lock();
         auto pLoc = TTE_NEW_PTR(ResourceConcreteLocation<RegistryDirectory_TTArchive>, MEMORY_TAG_RESOURCE_REGISTRY, archiveID, archivePhysicalPath, std::move(arc));
         _Locations.push_back(std::move(pLoc));
     }
     else if(resourceName == maskTTArch2)
     {
-        TTArchive2 arc{ GetToolContext()->GetActiveGame()->GetArchiveVersion(GetToolContext()->GetSnapshot()) };
+        U32 version = GetToolContext()->GetActiveGame()->GetArchiveVersion(GetToolContext()->GetSnapshot());
+        TTArchive2 arc{ version };
+        String cacheDirectory = _ArchiveIndexCacheDirectory;
+        DataStreamRef archiveFile = archiveStream; // serialise in can replace the stream with a wrapper
         lck.unlock(); // may take time, dont keep everyone waiting!
-        TTE_ASSERT(arc.SerialiseIn(archiveStream), "TTArchive2 serialise/read fail!");
+        if(!ArchiveIndexCache::Load(cacheDirectory, archivePhysicalPath, archiveFile, arc, version))
+        {
+            TTE_ASSERT(arc.SerialiseIn(archiveStream), "TTArchive2 serialise/read fail!");
+            ArchiveIndexCache::Store(cacheDirectory, archivePhysicalPath, archiveFile, arc, version);
+        }
         lck.lock();
         auto pLoc = TTE_NEW_PTR(ResourceConcreteLocation<RegistryDirectory_TTArchive2>, MEMORY_TAG_RESOURCE_REGISTRY, archiveID, archivePhysicalPath, std::move(arc));
         _Locations.push_back(std::move(pLoc));
@@ -2849,25 +2838,35 @@ Bool _AsyncPerformPreloadBatchJob(const JobThread& thread, void* j, void*)
     std::stringstream ss{};
     DataStreamRef Streams[STATIC_PRELOAD_BATCH_SIZE];
     
-    // Locate streams
+    // Locate streams. Only resolving which directory has each resource needs the lock. The located streams keep their archive / file
+    // alive if the location is unmounted meanwhile, and each gets its own position, so they can be read from after unlocking.
     {
-        job->Registry->_Guard.lock();
+        std::lock_guard<std::recursive_mutex> lck{job->Registry->_Guard};
         Ptr<ResourceLocation> master = job->Registry->_Locate("<>");
         for(U32 i = 0; i < job->NumResources; i++)
         {
-            DataStreamRef unsafe = master->LocateResource(job->HOI[i]._ResourceName, nullptr); // need to read to buffer
-            DataStreamRef buffer = DataStreamManager::GetInstance()->CreateBufferStream("", unsafe->GetSize(), 0, 0);
-            DataStreamManager::GetInstance()->Transfer(unsafe, buffer, unsafe->GetSize());
-            Streams[i] = std::move(buffer);
+            DataStreamRef located = master->LocateResource(job->HOI[i]._ResourceName, nullptr);
+            if(located)
+                Streams[i] = DataStreamManager::GetInstance()->CreateSubStreamView(located);
         }
-        job->Registry->_Guard.unlock();
     }
     
-    // Load the resources
+    // Read and load the resources, without the lock. Reading in decompresses and decrypts, which is most of the time spent here.
     for(U32 i = 0; i < job->NumResources; i++)
     {
         Bool bFail = false;
         if(Streams[i].get() != nullptr)
+        {
+            // read it all into memory first, meta streams read lots of small pieces
+            DataStreamRef located = std::move(Streams[i]);
+            Streams[i] = DataStreamManager::GetInstance()->CreateBufferStream("", located->GetSize(), 0, 0);
+            located->SetPosition(0);
+            if(!DataStreamManager::GetInstance()->Transfer(located, Streams[i], located->GetSize()))
+                Streams[i].reset();
+            else
+                Streams[i]->SetPosition(0);
+        }
+        if(Streams[i].get() != nullptr)
         {
             job->HOI[i]._Instance = Meta::ReadMetaStream(SymbolTable::FindOrHashString(job->HOI[i]._ResourceName), Streams[i]);
             if(job->HOI[i]._Instance && ((Meta::GetClass(job->HOI[i]._Instance.GetClassID()).Flags & Meta::_CLASS_PROP) == 0))
@@ -2896,7 +2895,7 @@ Bool _AsyncPerformPreloadBatchJob(const JobThread& thread, void* j, void*)
         }
     }
     
-    // Insert loaded into registry
+    // Publish the loaded handles into the registry
     {
         std::unique_lock<std::recursive_mutex> lck{job->Registry->_Guard};
         for(U32 i = 0; i < job->NumResources; i++)
@@ -3100,12 +3099,12 @@ ResourceRegistry::~ResourceRegistry()
 {
     if(JobScheduler::Instance)
     {
-        JobHandle Handles[NUM_SCHEDULER_THREADS];
+        std::vector<JobHandle> Handles(JobScheduler::Instance->GetNumWorkerThreads());
         JobDescriptor desc{};
         desc.AsyncFunction = &_AsyncDetachRegistry;
         desc.UserArgA = this;
         desc.Priority = JOB_PRIORITY_HIGHEST;
-        for(I32 i = 0; i < NUM_SCHEDULER_THREADS; i++)
+        for(I32 i = 0; i < (I32)Handles.size(); i++)
         {
             Handles[i] = JobScheduler::Instance->Post(desc, i);
         }
@@ -78,7 +78,7 @@ Bool TTArchive::SerialiseIn(DataStreamRef& in)
         offsets.clear();
         
         // sort files
-        std::sort(_Files.begin(), _Files.end(), FileInfoSorter{});
+        _SortFiles();
         
         return true; // OK
     }
@@ -87,9 +87,97 @@ Bool TTArchive::SerialiseIn(DataStreamRef& in)
     return false;
 }
 
+void TTArchive::_SortFiles()
+{
+    std::sort(_Files.begin(), _Files.end(), FileInfoSorter{});
+    _Index.Clear();
+    _Index.Reserve((U32)_Files.size());
+    for(U32 i = 0; i < (U32)_Files.size(); i++)
+        _Index.Insert(_Files[i].NameSymbol.GetCRC64(), i);
+    _Sorted = true;
+}
+
 Bool TTArchive::SerialiseOut(DataStreamRef& in)
 {
     TTE_ASSERT("IMPLEMENT ME");
     return false; // TODO
 }
 
+
+Bool TTArchive::SerialiseIndexOut(DataStreamRef& out, const DataStreamRef& archiveStream) const
+{
+    // all files must be sections of the archive stream
+    for(auto& file: _Files)
+    {
+        const DataStreamSubStream* pSection = dynamic_cast<const DataStreamSubStream*>(file.Stream.get());
+        if(!pSection || pSection->GetParent() != archiveStream)
+            return false;
+    }
+    
+    U32 value = _Version;
+    SerialiseDataU32(out, nullptr, &value, true);
+    
+    value = (U32)_Folders.size();
+    SerialiseDataU32(out, nullptr, &value, true);
+    for(auto& folder: _Folders)
+        DataStreamManager::GetInstance()->WriteString(out, folder);
+    
+    value = (U32)_Files.size();
+    SerialiseDataU32(out, nullptr, &value, true);
+    for(auto& file: _Files)
+    {
+        const DataStreamSubStream* pSection = static_cast<const DataStreamSubStream*>(file.Stream.get());
+        U64 data = file.NameSymbol.GetCRC64();
+        SerialiseDataU64(out, nullptr, &data, true);
+        data = pSection->GetSectionOffset();
+        SerialiseDataU64(out, nullptr, &data, true);
+        data = file.Stream->GetSize();
+        SerialiseDataU64(out, nullptr, &data, true);
+        DataStreamManager::GetInstance()->WriteString(out, file.Name);
+    }
+    
+    return true;
+}
+
+Bool TTArchive::SerialiseIndexIn(DataStreamRef& index, DataStreamRef& archiveStream)
+{
+    Reset();
+    
+    U32 value = 0;
+    SerialiseDataU32(index, nullptr, &value, false);
+    if(value != _Version)
+        return false; // version comes from the game, must match
+    
+    SerialiseDataU32(index, nullptr, &value, false);
+    if(value >= 10000)
+        return false;
+    for(U32 i = 0; i < value; i++)
+        _Folders.push_back(DataStreamManager::GetInstance()->ReadString(index));
+    
+    U32 fileCount = 0;
+    SerialiseDataU32(index, nullptr, &fileCount, false);
+    if(fileCount >= 1000000)
+        return false;
+    _Files.reserve(fileCount);
+    U64 archiveSize = archiveStream->GetSize();
+    for(U32 i = 0; i < fileCount; i++)
+    {
+        U64 crc = 0, offset = 0, size = 0;
+        SerialiseDataU64(index, nullptr, &crc, false);
+        SerialiseDataU64(index, nullptr, &offset, false);
+        SerialiseDataU64(index, nullptr, &size, false);
+        if(offset + size > archiveSize)
+        {
+            Reset();
+            return false;
+        }
+        FileInfo& inf = _Files.emplace_back();
+        inf.Name = DataStreamManager::GetInstance()->ReadString(index);
+        inf.NameSymbol = crc;
+        inf.Stream = DataStreamManager::GetInstance()->CreateSubStream(archiveStream, offset, size);
+    }
+    
+    _SortFiles(); // written sorted, this just builds the index
+    
+    return true;
+}
@@ -57,6 +57,7 @@ Bool TTArchive2::SerialiseIn(DataStreamRef& in)
     
     // setup
     _Files.clear();
+    _Index.Clear();
     _Files.reserve((size_t)fileCount);
     
     std::vector<InternalFileInfo> _inf{}; // for reading
@@ -120,9 +121,21 @@ Bool TTArchive2::SerialiseIn(DataStreamRef& in)
     TTE_FREE(TempFileNames);
     TempFileNames = nullptr;
     
+    _SortFiles(); // should be sorted already
+    
     return true;
 }
 
+void TTArchive2::_SortFiles()
+{
+    std::sort(_Files.begin(), _Files.end());
+    _Index.Clear();
+    _Index.Reserve((U32)_Files.size());
+    for(U32 i = 0; i < (U32)_Files.size(); i++)
+        _Index.Insert(_Files[i].NameSymbol.GetCRC64(), i);
+    _Sorted = true;
+}
+
 // we can write the archive n the main thread, it doesn't take too long. the compression and writing to file can be done async if needed.
 Bool TTArchive2::SerialiseOut(DataStreamRef& o, ContainerParams params, JobHandle& handle)
 {
@@ -133,6 +146,9 @@ Bool TTArchive2::SerialiseOut(DataStreamRef& o, ContainerParams params, JobHandl
         return false;
     }
     
+    if(!_Sorted)
+        _SortFiles(); // archive hashes need to be sorted for internal binary sorts
+    
     // ========================== 1: Write header stream and name table
     
     DataStreamRef headerStream = DataStreamManager::GetInstance()->CreatePrivateCache("TTArchive2::Header");
@@ -157,12 +173,11 @@ Bool TTArchive2::SerialiseOut(DataStreamRef& o, ContainerParams params, JobHandl
     SerialiseDataU32(headerStream, nullptr, &files, true);
     
     // Write file information for each file
-    // std::sort(_Files.begin(), _Files.end(), FileInfoSort{}); // archive hashes need to be sorted for internal binary sorts. already sorted.
     U32 nameTableOffs = 0;
     U64 runningOffset = 0;
     for(auto& file : _Files)
     {
-        U64 data = Symbol(file.Name).GetCRC64();
+        U64 data = file.NameSymbol.GetCRC64();
         SerialiseDataU64(headerStream, nullptr, &data, true); // write name hash
         
         data = runningOffset;
@@ -226,3 +241,100 @@ TTArchive2::~TTArchive2()
 {
     
 }
+
+Bool TTArchive2::SerialiseIndexOut(DataStreamRef& out, const DataStreamRef& archiveStream) const
+{
+    // all files must be sections of the same container over the archive
+    const DataStreamContainer* pContainer = nullptr;
+    for(auto& file: _Files)
+    {
+        const DataStreamSubStream* pSection = dynamic_cast<const DataStreamSubStream*>(file.Stream.get());
+        const DataStreamContainer* pFileContainer = pSection ? dynamic_cast<const DataStreamContainer*>(pSection->GetParent().get()) : nullptr;
+        if(!pFileContainer || (pContainer && pContainer != pFileContainer) || pFileContainer->GetParent() != archiveStream)
+            return false;
+        pContainer = pFileContainer;
+    }
+    
+    U32 value = _Version;
+    SerialiseDataU32(out, nullptr, &value, true);
+    
+    ContainerLayout layout = pContainer ? pContainer->GetLayout() : ContainerLayout{};
+    SerialiseDataU64(out, nullptr, &layout.Size, true);
+    SerialiseDataU64(out, nullptr, &layout.DataOffsetStart, true);
+    SerialiseDataU64(out, nullptr, &layout.PageSize, true);
+    SerialiseDataU32(out, nullptr, &layout.Compression, true);
+    value = (layout.Compressed ? 1 : 0) | (layout.Encrypted ? 2 : 0);
+    SerialiseDataU32(out, nullptr, &value, true);
+    value = (U32)layout.PageOffsets.size();
+    SerialiseDataU32(out, nullptr, &value, true);
+    if(value && !out->Write((const U8*)layout.PageOffsets.data(), (U64)value << 3))
+        return false;
+    
+    value = (U32)_Files.size();
+    SerialiseDataU32(out, nullptr, &value, true);
+    for(auto& file: _Files)
+    {
+        const DataStreamSubStream* pSection = static_cast<const DataStreamSubStream*>(file.Stream.get());
+        U64 data = file.NameSymbol.GetCRC64();
+        SerialiseDataU64(out, nullptr, &data, true);
+        data = pSection->GetSectionOffset();
+        SerialiseDataU64(out, nullptr, &data, true);
+        data = file.Stream->GetSize();
+        SerialiseDataU64(out, nullptr, &data, true);
+        DataStreamManager::GetInstance()->WriteString(out, file.Name);
+    }
+    
+    return true;
+}
+
+Bool TTArchive2::SerialiseIndexIn(DataStreamRef& index, DataStreamRef& archiveStream)
+{
+    Reset();
+    
+    U32 value = 0;
+    SerialiseDataU32(index, nullptr, &value, false);
+    _Version = value;
+    
+    ContainerLayout layout{};
+    SerialiseDataU64(index, nullptr, &layout.Size, false);
+    SerialiseDataU64(index, nullptr, &layout.DataOffsetStart, false);
+    SerialiseDataU64(index, nullptr, &layout.PageSize, false);
+    SerialiseDataU32(index, nullptr, &layout.Compression, false);
+    SerialiseDataU32(index, nullptr, &value, false);
+    layout.Compressed = (value & 1) != 0;
+    layout.Encrypted = (value & 2) != 0;
+    SerialiseDataU32(index, nullptr, &value, false);
+    layout.PageOffsets.resize(value);
+    if(value && !index->Read((U8*)layout.PageOffsets.data(), (U64)value << 3))
+        return false;
+    if(layout.Compressed && layout.PageOffsets.empty())
+        return false;
+    
+    DataStreamRef container = DataStreamManager::GetInstance()->CreateContainerStream(archiveStream, layout);
+    
+    U32 fileCount = 0;
+    SerialiseDataU32(index, nullptr, &fileCount, false);
+    if(fileCount > 0xFFFFF)
+        return false;
+    _Files.reserve(fileCount);
+    for(U32 i = 0; i < fileCount; i++)
+    {
+        U64 crc = 0, offset = 0, size = 0;
+        SerialiseDataU64(index, nullptr, &crc, false);
+        SerialiseDataU64(index, nullptr, &offset, false);
+        SerialiseDataU64(index, nullptr, &size, false);
+        if(offset + size > layout.Size)
+        {
+            Reset();
+            return false;
+        }
+        FileInfo& inf = _Files.emplace_back();
+        inf.Name = DataStreamManager::GetInstance()->ReadString(index);
+        inf.NameSymbol = crc;
+        inf.Stream = DataStreamManager::GetInstance()->CreateSubStream(container, offset, size);
+    }
+    
+    _SortFiles(); // written sorted, this just builds the index
+    
+    return true;
+}
@@ -3,14 +3,17 @@
 #include <Scripting/ScriptManager.hpp>
 #include <Resource/ResourceRegistry.hpp>
 
+#include <algorithm>
+#include <chrono>
+
 JobScheduler *JobScheduler::Instance = 0;
 
 thread_local JobThread* MyLocalThread = nullptr;
 
-void JobScheduler::Initialise(LuaFunctionCollection Col)
+void JobScheduler::Initialise(LuaFunctionCollection Col, U32 numThreads)
 {
     if (Instance == 0)
-        Instance = TTE_NEW(JobScheduler, MEMORY_TAG_SCHEDULER, std::move(Col));
+        Instance = TTE_NEW(JobScheduler, MEMORY_TAG_SCHEDULER, std::move(Col), numThreads);
 }
 
 void JobScheduler::Shutdown()
@@ -109,13 +112,17 @@ JobThreadWaitResult JobScheduler::_JobThreadRunJob(JobScheduler &scheduler, JobT
     return JOB_THREAD_RESULT_OK; // No need to exit.
 }
 
-void JobScheduler::_SignalJobThread(U32 numSignals /*= 1*/)
+void JobScheduler::_SignalJobThread(U32 numSignals /*= 1*/, Bool bPinned /*= false*/)
 {
+    // Posters bump the job counts before getting here and sleepers bump the sleeping count before checking them, so if no one
+    // is sleeping here then any thread about to sleep will see the new jobs and not sleep.
+    if (_numSleeping.load() == 0)
+        return;
+    
     std::lock_guard<std::mutex> _Guard(_jobThreadNotifierLock);
-    _jobThreadNotifierCount += numSignals; // Increase semaphore counter
     
-    // If numSignals >= NUM_SCHEDULER_THREADS, notify all, else loop that many times and notify one.
-    if (numSignals >= NUM_SCHEDULER_THREADS)
+    // If numSignals >= number of threads or a specific thread must wake, notify all, else loop that many times and notify one.
+    if (bPinned || numSignals >= _numThreads)
         _jobThreadNotifierCond.notify_all(); // All need to wake up
     else
     {
@@ -124,82 +131,116 @@ void JobScheduler::_SignalJobThread(U32 numSignals /*= 1*/)
     }
 }
 
-JobThreadWaitResult JobScheduler::_WaitJobThread(Bool bWaitSemaphore, JobThread &myself)
+U32 JobScheduler::_SelectQueue()
 {
-    JobThreadWaitResult Result;
-    Bool NeedsWait = false;
-    Bool IsRunning = false;
+    if (MyLocalThread != nullptr && MyLocalThread->ThreadNumber < _numThreads)
+        return MyLocalThread->ThreadNumber; // Keep jobs posted from jobs on this worker, they are likely to use the same data.
+    return _nextQueue.fetch_add(1, std::memory_order_relaxed) % _numThreads;
+}
+
+Bool JobScheduler::_PushJob(Job &&job, U32 queueIndex)
+{
+    Bool bPinned = job.AffinityOverride >= 0;
+    if (bPinned)
     {
-        // Check if we need to exit.
-        Result = (IsRunning = _running.load(std::memory_order_acquire)) && _cancelJobs ? JOB_THREAD_RESULT_CANCEL_EXIT : JOB_THREAD_RESULT_OK;
-        
-        // If we are only checking running state, return now. Also if we need to exit, no need to wait on this thread so just return we need to exit.
-        if (!bWaitSemaphore || Result == JOB_THREAD_RESULT_CANCEL_EXIT)
-            return Result;
-        
-        // Here we wait.
-        std::unique_lock<std::mutex> _Guard(_jobThreadNotifierLock); // Unique lock: destructor unlocks if locked
-        
-        // Now wait until signalled.
-        
-        // Use the condition variable to wait
-        while (!_jobThreadNotifierCount)
-            _jobThreadNotifierCond.wait(_Guard); // Try and lock the mutex, loop handles any spurious wakeups
-        
-        // Lock is aquired. First check if any job is available, if not, don't decrement counter and rewait for a bit.
-        // It may take time for this thread to be run. One signal => one job run! So if no job is run and we decrement it
-        // then we may cause all threads to be sleeping with jobs available and only run until next post job is called.
-        // So rewait a bit. Deadlock won't occur, the notifier lock is only locked before here and has higher priority.
-        
+        TTE_ASSERT(job.AffinityOverride < (I32)_numThreads, "Job affinity override %d is out of range, there are %d worker threads",
+                   job.AffinityOverride, _numThreads);
+        queueIndex = (U32)job.AffinityOverride % _numThreads;
+    }
+    JobWorkerQueue &queue = *_queues[queueIndex];
+    U32 priority = (U32)job.Priority;
+    std::lock_guard<std::mutex> _Guard(queue.Lock);
+    if (bPinned)
+    {
+        queue.Pinned[priority].push_back(std::move(job));
+        queue.NumPinned.fetch_add(1);
+    }
+    else
+    {
+        queue.Jobs[priority].push_back(std::move(job));
+        queue.NumJobs[priority].fetch_add(1);
+        _numStealable.fetch_add(1);
+    }
+    return bPinned;
+}
+
+Bool JobScheduler::_FetchJob(U32 threadIndex, Job &outJob)
+{
+    JobWorkerQueue &myQueue = *_queues[threadIndex];
+    for (I32 priority = JOB_PRIORITY_COUNT - 1; priority >= 0; priority--)
+    {
+        // Own queue first, pinned jobs before others
+        if (myQueue.NumPinned.load(std::memory_order_relaxed) || myQueue.NumJobs[priority].load(std::memory_order_relaxed))
         {
-            std::lock_guard<std::mutex> _Guard(_jobsLock);
-            if (_pendingJobs.size())
+            std::lock_guard<std::mutex> _Guard(myQueue.Lock);
+            if (myQueue.Pinned[priority].size())
             {
-                Bool hasJob = false;
-                typename std::vector<Job>::iterator foundIt = {};
-                for(auto it = _pendingJobs.get_container().begin(); it != _pendingJobs.get_container().end(); it++)
-                {
-                    if(it->AffinityOverride == -1 || it->AffinityOverride == (I32)myself.ThreadNumber)
-                    {
-                        foundIt = it;
-                        hasJob = true;
-                        break;
-                    }
-                }
-                if(hasJob)
-                {
-                    //  Found a job! Move highest priority job. NOTE: const cast needed (c++ spec...)
-                    myself.CurrentJob = std::move(const_cast<Job &>(*foundIt));
-                    _pendingJobs.get_container().erase(foundIt);
-                }
-                else
-                {
-                    NeedsWait = true;
-                }
+                outJob = std::move(myQueue.Pinned[priority].front());
+                myQueue.Pinned[priority].pop_front();
+                myQueue.NumPinned.fetch_sub(1);
+                return true;
             }
-            else
+            if (myQueue.Jobs[priority].size())
             {
-                if (!IsRunning)
-                    return JOB_THREAD_RESULT_CANCEL_EXIT; // We aren't running, and no more jobs available
-                NeedsWait = true;                         // No jobs. Retry later.
+                outJob = std::move(myQueue.Jobs[priority].front());
+                myQueue.Jobs[priority].pop_front();
+                myQueue.NumJobs[priority].fetch_sub(1);
+                _numStealable.fetch_sub(1);
+                return true;
             }
         }
         
-        // If we need a wait then wait a small time else decrement (success, job found) - do this outside the lock!
-        if (!NeedsWait)
+        // Steal from the others at this priority, so a high priority job elsewhere is run before our own low priority ones
+        if (_numStealable.load(std::memory_order_relaxed) == 0)
+            continue;
+        for (U32 i = 1; i < _numThreads; i++)
         {
-            // OK, decrement.
-            _jobThreadNotifierCount--;
+            JobWorkerQueue &victim = *_queues[(threadIndex + i) % _numThreads];
+            if (victim.NumJobs[priority].load(std::memory_order_relaxed) == 0)
+                continue; // Don't lock queues with nothing to steal
+            std::lock_guard<std::mutex> _Guard(victim.Lock);
+            if (victim.Jobs[priority].size())
+            {
+                outJob = std::move(victim.Jobs[priority].front());
+                victim.Jobs[priority].pop_front();
+                victim.NumJobs[priority].fetch_sub(1);
+                _numStealable.fetch_sub(1);
+                return true;
+            }
         }
     }
+    return false;
+}
+
+JobThreadWaitResult JobScheduler::_WaitJobThread(Bool bWaitSemaphore, JobThread &myself)
+{
+    // Check if we need to exit.
+    Bool IsRunning = _running.load(std::memory_order_acquire);
+    JobThreadWaitResult Result = IsRunning && _cancelJobs ? JOB_THREAD_RESULT_CANCEL_EXIT : JOB_THREAD_RESULT_OK;
+    
+    // If we are only checking running state, return now. Also if we need to exit, no need to wait on this thread so just return we need to exit.
+    if (!bWaitSemaphore || Result == JOB_THREAD_RESULT_CANCEL_EXIT)
+        return Result;
+    
+    // Try and find a job, ours or stolen
+    if (_FetchJob(myself.ThreadNumber, myself.CurrentJob))
+        return Result;
+    
+    if (!IsRunning)
+        return JOB_THREAD_RESULT_CANCEL_EXIT; // We aren't running, and no more jobs available
     
-    if (NeedsWait)
+    // No jobs. Sleep until a job is posted. Register as sleeping before checking, see _SignalJobThread.
     {
-        ThreadSleep(15);                           // Wait for a bit, thread will retry after
-        myself.CurrentJob.RunnableFunction = NULL; // Let thread know we have to re-wait
+        JobWorkerQueue &myQueue = *_queues[myself.ThreadNumber];
+        std::unique_lock<std::mutex> _Guard(_jobThreadNotifierLock); // Unique lock: destructor unlocks if locked
+        _numSleeping.fetch_add(1);
+        while (_numStealable.load() == 0 && myQueue.NumPinned.load() == 0 && _running.load(std::memory_order_acquire))
+            _jobThreadNotifierCond.wait(_Guard); // Loop handles any spurious wakeups
+        _numSleeping.fetch_sub(1);
     }
     
-    return Result; // And unlock (destructor)
+    myself.CurrentJob.RunnableFunction = NULL; // Let thread know we have to loop again
+    return Result;
 }
 
 void JobScheduler::_IncrementRefs(U32 job)
@@ -230,29 +271,21 @@ void JobScheduler::_DecrementRefs(U32 job, Bool bReleaseScheduler)
                 auto jobList = std::move(it->second);
                 _enqueuedJobs.erase(it);
                 
-                // Finished with enqueued job array, so release lock and now lock jobs array so append the local jobList to it
+                // Finished with enqueued job array, so release lock and now append the local jobList to the job queues
                 _aliveJobsLock.unlock();
                 
-                _jobsLock.lock();
-                
-                // Append the jobs
-                if (jobList.NumQueued == 1)
-                { // Only one in the array
-                    _pendingJobs.push(std::move(jobList.Singular));
-                    jobList.Singular.~Job();
-                }
-                else if (jobList.NumQueued > 1)
-                { // Multiple, append all.
-                    while (jobList.Queued.size())
-                    {
-                        _pendingJobs.push(std::move(const_cast<Job &>(jobList.Queued.top())));
-                        jobList.Queued.pop();
-                    }
-                    jobList.Queued.~hacked_priority_queue();
+                U32 numDispursed = jobList.NumQueued;
+                Bool bPinned = false;
+                U32 queueIndex = _SelectQueue();
+                Job tmp{};
+                while (jobList.NumQueued)
+                {
+                    jobList.Dequeue(tmp);
+                    bPinned = _PushJob(std::move(tmp), queueIndex) || bPinned;
                 }
-                jobList.NumQueued = 0;
                 
-                _jobsLock.unlock();
+                if (numDispursed)
+                    _SignalJobThread(numDispursed, bPinned);
                 
                 return; // No more unlocks needed
             }
@@ -277,8 +310,11 @@ JobResult JobScheduler::_GetSetCounter(U32 job, JobResult newValue /*= JOB_RESUL
                 (*it->second.PostIncrement)++;
             if (it->second.PostResult != NULL && newValue == JOB_RESULT_FAIL)
                 *it->second.PostResult = JOB_RESULT_FAIL;
+            if (it->second.PostNotify != NULL)
+                it->second.PostNotify->notify_all(); // Wake the waiter now, it checks the post increment under this lock
             it->second.PostIncrement = NULL;
             it->second.PostResult = NULL;
+            it->second.PostNotify = NULL;
         }
         return Result;
     }
@@ -306,6 +342,7 @@ Bool JobScheduler::_DequeueJob(U32 jobID, Job &dest)
 {
     // The previous job is finised, so dispurse the rest and leave one to execute on the current thread for maximum throughput.
     U32 numDispursed = 0;
+    Bool bPinned = false;
     
     {
         std::unique_lock<std::mutex> ulock(_aliveJobsLock); // Lock as accessing enqueued jobs
@@ -328,15 +365,14 @@ Bool JobScheduler::_DequeueJob(U32 jobID, Job &dest)
         it->second.Dequeue(dest);
         
         Job tmp{};
-        if (it->second.NumQueued >= NUM_SCHEDULER_THREADS)
+        U32 queueIndex = _SelectQueue();
+        if (it->second.NumQueued >= _numThreads)
         {
             
             // Keep half and dispurse the other half
             
-            std::lock_guard<std::mutex> _Guard2(_jobsLock); // Don't panic! Deadlock cannot occur as this lock is inferior to the previous
-            // ie, the alive jobs lock is and should *always* be locked before and unlocked after the jobs lock!
-            
-            // We have both locks acquired here so we can access both arrays safely.
+            // Don't panic! Deadlock cannot occur as the queue locks are inferior to the alive jobs lock
+            // ie, the alive jobs lock is and should *always* be locked before and unlocked after the queue locks!
             
             U32 toDispurseNum = (it->second.NumQueued >> 1) + (it->second.NumQueued & 1); // Half it, w/advantage for remainder.
             numDispursed = toDispurseNum;
@@ -344,7 +380,7 @@ Bool JobScheduler::_DequeueJob(U32 jobID, Job &dest)
             while (toDispurseNum--)
             {
                 it->second.Dequeue(tmp); // Ignore smart highlight. Moved object gets assigned each dequeue.
-                _pendingJobs.push(std::move(tmp));
+                bPinned = _PushJob(std::move(tmp), queueIndex) || bPinned;
             }
         }
         else if (it->second.NumQueued > 0)
@@ -357,14 +393,12 @@ Bool JobScheduler::_DequeueJob(U32 jobID, Job &dest)
             
             numDispursed = toDispurse.NumQueued;
             
-            // Lock pending jobs array and dispurse these
-            _jobsLock.lock();
+            // Dispurse these into our queue, idle workers will steal them
             while (toDispurse.NumQueued)
             {
                 toDispurse.Dequeue(tmp); // Ignore smart highlight. Moved object gets assigned each dequeue.
-                _pendingJobs.push(std::move(tmp));
+                bPinned = _PushJob(std::move(tmp), queueIndex) || bPinned;
             }
-            _jobsLock.unlock();
         }
         else
         {
@@ -374,7 +408,7 @@ Bool JobScheduler::_DequeueJob(U32 jobID, Job &dest)
     
     // Signal remaining worker threads (num-1). If number of dispursed < numthreads-1, signal dispursed
     if (numDispursed)
-        _SignalJobThread(numDispursed);
+        _SignalJobThread(numDispursed, bPinned);
     
     // No gauruntee lock is held here, unique lock will unlock if needed
     
@@ -384,7 +418,7 @@ Bool JobScheduler::_DequeueJob(U32 jobID, Job &dest)
 void JobScheduler::_MakeJob(U32 ID, Job &job, JobDescriptor &descriptor, I32 affinityOverride)
 {
     TTE_ASSERT(descriptor.AsyncFunction != NULL, "Job descriptor async function is NULL!");
-    job.Priority = descriptor.Priority;
+    job.Priority = descriptor.Priority >= JOB_PRIORITY_COUNT ? JOB_PRIORITY_HIGHEST : descriptor.Priority; // each priority has its own queue
     job.RunnableFunction = descriptor.AsyncFunction;
     job.UserArgA = descriptor.UserArgA;
     job.UserArgB = descriptor.UserArgB;
@@ -450,33 +484,37 @@ void JobScheduler::_RegisterJobs(U32 nJobs, JobDescriptor *pJobDescriptors, JobH
         for (U32 handle = 0; handle < nJobs; handle++)
             pOutHandles[handle]._jobID = newIDs + handle;
         
+        // Add new jobs to the queues
+        Bool bPinned = false;
+        for (U32 i = 0; i < nJobs; i++)
         {
-            
-            std::lock_guard<std::mutex> _Guard(_jobsLock); // Adding now to pending array, so ensure pending jobs lock array is locked.
-            
-            // Add new jobs to pending jobs array
-            for (U32 i = 0; i < nJobs; i++)
-            {
-                Job localJob{}; // Store locally then push it to priority queue.
-                _MakeJob(newIDs + i, localJob, pJobDescriptors[i], affinityOverride);
-                _pendingJobs.push(std::move(localJob));
-            }
+            Job localJob{}; // Store locally then push it to a queue.
+            _MakeJob(newIDs + i, localJob, pJobDescriptors[i], affinityOverride);
+            bPinned = _PushJob(std::move(localJob), _SelectQueue()) || bPinned;
         }
         
         // Signal threads to run.
-        _SignalJobThread(nJobs);
+        _SignalJobThread(nJobs, bPinned);
     }
 }
 
-JobScheduler::JobScheduler(LuaFunctionCollection&& col) : _workerScriptCollection(std::move(col)),
-_jobThreadNotifierCount(0), _running(true), _cancelJobs(false), _runningID(0)
+JobScheduler::JobScheduler(LuaFunctionCollection&& col, U32 numThreads) : _workerScriptCollection(std::move(col)),
+_numStealable(0), _nextQueue(0), _numSleeping(0), _running(true), _cancelJobs(false), _runningID(0)
 {
-    // Job thread notifier counter is 0 to begin with, ie threads will wait until jobs come.
+    if (numThreads == 0)
+        numThreads = MAX(2u, std::thread::hardware_concurrency()); // at least 2, jobs can wait on other jobs
+    _numThreads = MIN(numThreads, (U32)MAX_SCHEDULER_THREADS);
+    
+    // Queues must all exist before any thread starts stealing
+    _queues.reserve(_numThreads);
+    for (U32 threadIndex = 0; threadIndex < _numThreads; threadIndex++)
+        _queues.push_back(TTE_NEW_PTR(JobWorkerQueue, MEMORY_TAG_SCHEDULER));
     
     // Spawn threads!
-    for (U32 threadIndex = 0; threadIndex < NUM_SCHEDULER_THREADS; threadIndex++)
+    _workers.reserve(_numThreads);
+    for (U32 threadIndex = 0; threadIndex < _numThreads; threadIndex++)
     {
-        _workers[threadIndex] = std::thread(_JobThreadFn, std::ref(*this), threadIndex);
+        _workers.push_back(std::thread(_JobThreadFn, std::ref(*this), threadIndex));
     }
 }
 
@@ -490,14 +528,17 @@ void JobScheduler::_Shutdown(Bool bKillAwaiting)
     _running.store(false, std::memory_order_release); // release, store it. cancelJobs by definition is also synchronised.
     
     // Signal all threads, so they finish.
-    _SignalJobThread(9999);
+    {
+        std::lock_guard<std::mutex> _Guard(_jobThreadNotifierLock);
+        _jobThreadNotifierCond.notify_all();
+    }
     
     // Now we wait! Join all threads
-    for (U32 threadIdx = 0; threadIdx < NUM_SCHEDULER_THREADS; threadIdx++)
+    for (U32 threadIdx = 0; threadIdx < _numThreads; threadIdx++)
         _workers[threadIdx].join();
     
     // Finished. If this assert fires, another thread (not the calling (main) or any worker), has posted jobs!
-    TTE_ASSERT(bKillAwaiting || _pendingJobs.size() == 0, "Jobs were posted after Shutdown called from external thread");
+    TTE_ASSERT(bKillAwaiting || _numStealable.load() == 0, "Jobs were posted after Shutdown called from external thread");
 }
 
 Bool JobScheduler::PostAll(JobDescriptor *pDescriptors, U32 Num, JobHandle *pOutHandles)
@@ -522,6 +563,15 @@ void JobScheduler::_CancelRemoveJob(const JobHandle &hJob, Bool cancelQueued)
     {
         std::lock_guard<std::mutex> _Guard(_aliveJobsLock);
         
+        // If anyone is waiting on the job, let them know it won't finish
+        auto counter = _jobCounters.find(hJob._jobID);
+        if (counter != _jobCounters.end() && counter->second.PostIncrement != NULL)
+        {
+            (*counter->second.PostIncrement)++;
+            if (counter->second.PostNotify != NULL)
+                counter->second.PostNotify->notify_all();
+        }
+        
         _jobCounters.erase(hJob._jobID); // Remove counters
         
         if (cancelQueued)
@@ -542,17 +592,19 @@ void JobScheduler::_CancelRemoveJob(const JobHandle &hJob, Bool cancelQueued)
     }
     
     if (toDispuse.NumQueued)
-    { // Save a lock if possible
-        
-        std::lock_guard<std::mutex> _Guard(_jobsLock);
+    {
         
         // Dispurse if we have queued jobs
+        U32 numDispursed = toDispuse.NumQueued;
+        Bool bPinned = false;
+        U32 queueIndex = _SelectQueue();
         Job tmp{};
         while (toDispuse.NumQueued)
         {
             toDispuse.Dequeue(tmp); // Ignore warning under this line
-            _pendingJobs.push(std::move(tmp));
+            bPinned = _PushJob(std::move(tmp), queueIndex) || bPinned;
         }
+        _SignalJobThread(numDispursed, bPinned);
     }
 }
 
@@ -560,18 +612,34 @@ Bool JobScheduler::Cancel(const JobHandle &hJob, Bool cancelQueued)
 {
     // Check the job has not started. If it has return false. If it has, remove it from the pending queue!
     Bool Started = true;
+    for (U32 queueIndex = 0; Started && queueIndex < _numThreads; queueIndex++)
     {
-        std::lock_guard<std::mutex> _Guard(_jobsLock);
+        JobWorkerQueue &queue = *_queues[queueIndex];
+        std::lock_guard<std::mutex> _Guard(queue.Lock);
         
-        // Use hacked container (access internal vector) and try and find
-        for (auto it = _pendingJobs.get_container().begin(); it != _pendingJobs.get_container().end(); it++)
+        // Search each priority of both the stealable and pinned jobs
+        for (U32 priority = 0; Started && priority < JOB_PRIORITY_COUNT; priority++)
         {
-            if (it->JobID == hJob._jobID)
+            for (auto it = queue.Jobs[priority].begin(); it != queue.Jobs[priority].end(); it++)
             {
-                _pendingJobs.get_container().erase(it); // below line is needed to ensure priority queue remains ordered.
-                std::make_heap(_pendingJobs.get_container().begin(), _pendingJobs.get_container().begin(), _pendingJobs.get_cmp());
-                Started = false;
-                break;
+                if (it->JobID == hJob._jobID)
+                {
+                    queue.Jobs[priority].erase(it);
+                    queue.NumJobs[priority].fetch_sub(1);
+                    _numStealable.fetch_sub(1);
+                    Started = false;
+                    break;
+                }
+            }
+            for (auto it = queue.Pinned[priority].begin(); Started && it != queue.Pinned[priority].end(); it++)
+            {
+                if (it->JobID == hJob._jobID)
+                {
+                    queue.Pinned[priority].erase(it);
+                    queue.NumPinned.fetch_sub(1);
+                    Started = false;
+                    break;
+                }
             }
         }
     }
@@ -644,47 +712,119 @@ Bool JobScheduler::Cancel(const JobHandle &hJob, Bool cancelQueued)
     return true;
 }
 
-// Helper function used by Scheduler::Wait to lock the mutex and check the result.
-void JobScheduler::_PerformWaitCheck(Bool bFirstIt, U32 jobID, JobResult &outResult)
+Bool JobScheduler::_RunAwaitedJob(const std::vector<U32> &sortedJobIDs)
 {
-    std::lock_guard<std::mutex> _Guard(_aliveJobsLock); // Lock counters array
+    JobThread &myself = *MyLocalThread;
+    Job awaited{};
+    Bool bFound = false;
     
-    auto it = _jobCounters.find(jobID);
-    if (it == _jobCounters.end())
+    // Look through the queues for any of the jobs. Other worker's pinned jobs can't run here.
+    for (U32 queueIndex = 0; !bFound && queueIndex < _numThreads; queueIndex++)
     {
-        TTE_ASSERT(bFirstIt,
-                   "Internal error: job could not be found!"); // Should never happen! Job removed from counters array, but we have a handle!
-        outResult = JOB_RESULT_NONE; // Job doesn't exist (bFirstIt == true), so just return that - assertion won't have fired.
-        return;
+        JobWorkerQueue &queue = *_queues[queueIndex];
+        Bool bMine = queueIndex == myself.ThreadNumber;
+        if (_numStealable.load(std::memory_order_relaxed) == 0 && !(bMine && queue.NumPinned.load(std::memory_order_relaxed)))
+            continue;
+        std::lock_guard<std::mutex> _Guard(queue.Lock);
+        for (I32 priority = JOB_PRIORITY_COUNT - 1; !bFound && priority >= 0; priority--)
+        {
+            for (auto it = queue.Jobs[priority].begin(); it != queue.Jobs[priority].end(); it++)
+            {
+                if (std::binary_search(sortedJobIDs.begin(), sortedJobIDs.end(), it->JobID))
+                {
+                    awaited = std::move(*it);
+                    queue.Jobs[priority].erase(it);
+                    queue.NumJobs[priority].fetch_sub(1);
+                    _numStealable.fetch_sub(1);
+                    bFound = true;
+                    break;
+                }
+            }
+            for (auto it = queue.Pinned[priority].begin(); bMine && !bFound && it != queue.Pinned[priority].end(); it++)
+            {
+                if (std::binary_search(sortedJobIDs.begin(), sortedJobIDs.end(), it->JobID))
+                {
+                    awaited = std::move(*it);
+                    queue.Pinned[priority].erase(it);
+                    queue.NumPinned.fetch_sub(1);
+                    bFound = true;
+                    break;
+                }
+            }
+        }
     }
     
-    TTE_ASSERT(it->second.Result != JOB_RESULT_RUNNING, "Internal error: invalid job result"); // Result should never be running!
-    TTE_ASSERT(it->second.PostIncrement == 0, "Cannot call Wait() multiple times on a job handle from different threads");
+    if (!bFound)
+        return false;
     
-    outResult = it->second.Result == JOB_RESULT_NONE ? JOB_RESULT_RUNNING : it->second.Result;
+    // Run it here. The job calling wait is still running on this thread, so keep its current job intact.
+    Job waitingJob = std::move(myself.CurrentJob);
+    myself.CurrentJob = std::move(awaited);
+    _JobThreadRunJob(*this, myself);
+    myself.CurrentJob = std::move(waitingJob);
+    return true;
 }
 
-JobResult JobScheduler::Wait(const JobHandle &hJob)
+void JobScheduler::_WaitForCounters(U32 N, const JobHandle *pJobHandles, U32 &numFinished, U32 numWaitingOn, std::condition_variable &cond)
 {
-    // In the future we could make a Proxy thread class and have this calling function act as a job thread and run jobs while waiting !
-    
-    JobResult Result = JOB_RESULT_RUNNING;
-    _PerformWaitCheck(true, hJob._jobID, Result); // Initial check
-    
-    U32 Alternator = 1; // We use this so we pass in either 0 or WAIT_INTERNVAL_MS (alternates) to ThreadSleep.
-    // Zero will just yield this thread on most platforms.
+    // Non worker threads have no job thread state (lua state etc) to run jobs with, so they just sleep until notified.
+    Bool bHelp = MyLocalThread != nullptr;
+    std::vector<U32> sortedJobIDs{};
+    if (bHelp)
+    {
+        sortedJobIDs.reserve(N);
+        for (U32 i = 0; i < N; i++)
+            sortedJobIDs.push_back(pJobHandles[i]._jobID);
+        std::sort(sortedJobIDs.begin(), sortedJobIDs.end());
+    }
     
-    while (Result == JOB_RESULT_RUNNING)
+    std::unique_lock<std::mutex> _Guard(_aliveJobsLock); // numFinished is only written under this lock
+    while (numFinished < numWaitingOn)
+    {
+        if (bHelp)
+        {
+            _Guard.unlock();
+            Bool bRan = _RunAwaitedJob(sortedJobIDs);
+            _Guard.lock();
+            if (!bRan && numFinished < numWaitingOn)
+                cond.wait_for(_Guard, std::chrono::milliseconds(WAIT_HELP_INTERVAL_MS)); // awaited jobs may be queued after their parents finish
+        }
+        else
+        {
+            cond.wait(_Guard);
+        }
+    }
+}
+
+JobResult JobScheduler::Wait(const JobHandle &hJob)
+{
+    U32 Finished = 0;
+    JobResult PostResult = JOB_RESULT_OK;
+    std::condition_variable Cond{};
     {
+        std::lock_guard<std::mutex> _Guard(_aliveJobsLock); // Lock counters array
+        
+        auto it = _jobCounters.find(hJob._jobID);
+        if (it == _jobCounters.end())
+            return JOB_RESULT_NONE; // Job doesn't exist
         
-        ThreadSleep(WAIT_INTERNVAL_MS * Alternator); // Wait initially, and then check again. This can be changed!
+        TTE_ASSERT(it->second.Result != JOB_RESULT_RUNNING, "Internal error: invalid job result"); // Result should never be running!
+        TTE_ASSERT(it->second.PostIncrement == 0, "Cannot call Wait() multiple times on a job handle from different threads");
         
-        _PerformWaitCheck(false, hJob._jobID, Result); // Perform the check
+        if (it->second.Result != JOB_RESULT_NONE)
+            return it->second.Result; // Already finished
         
-        Alternator = (Alternator + 1) & 1; // Alternate between 0 and 1
+        // Get notified when it finishes
+        it->second.PostIncrement = &Finished;
+        it->second.PostResult = &PostResult;
+        it->second.PostNotify = &Cond;
     }
     
-    return Result;
+    _WaitForCounters(1, &hJob, Finished, 1, Cond);
+    
+    std::lock_guard<std::mutex> _Guard(_aliveJobsLock);
+    auto it = _jobCounters.find(hJob._jobID);
+    return it == _jobCounters.end() ? JOB_RESULT_CANCELLED : it->second.Result; // We hold a handle, so only a cancel removes the counter
 }
 
 JobResult JobScheduler::Wait(U32 N, const JobHandle* pJobHandles)
@@ -699,6 +839,7 @@ JobResult JobScheduler::Wait(U32 N, const JobHandle* pJobHandles)
     U32 LocalWaiter = 0; // This is going to be incremented but multiple threads, UNDER the aliveJobsLock. So only access within that lock.
     U32 NumWaitingOn = 0;
     JobResult Result = JOB_RESULT_OK;
+    std::condition_variable Cond{}; // Notified by each job as it finishes
     {
         std::lock_guard<std::mutex> _Guard(_aliveJobsLock); // Lock counters array
         
@@ -713,11 +854,12 @@ JobResult JobScheduler::Wait(U32 N, const JobHandle* pJobHandles)
                 // First assert
                 TTE_ASSERT(it->second.PostIncrement == 0, "Wait() called multiple times on a job handle from different threads, or duplicates!");
                 
-                // Assign PostIncrement to local variable which will get incremented when the jobs finish.
-                it->second.PostIncrement = &LocalWaiter;
-                it->second.PostResult = &Result;
                 if (it->second.Result == JOB_RESULT_RUNNING || it->second.Result == JOB_RESULT_NONE)
                 {
+                    // Assign PostIncrement to local variable which will get incremented when the jobs finish.
+                    it->second.PostIncrement = &LocalWaiter;
+                    it->second.PostResult = &Result;
+                    it->second.PostNotify = &Cond;
                     NumWaitingOn++;
                 }
             }
@@ -728,24 +870,10 @@ JobResult JobScheduler::Wait(U32 N, const JobHandle* pJobHandles)
     if (NumWaitingOn == 0)
         return JOB_RESULT_OK;
     
-    // Now wait until LocalWaiter == NumWaitingOn. Use the alternator approach like normal Wait.
-    U32 Alternator = 1;
-    for (;;)
-    {
-        
-        // First check if we are done
-        {
-            std::lock_guard<std::mutex> _Guard(_aliveJobsLock);
-            if (LocalWaiter == NumWaitingOn)
-                break; // Done !
-        }
-        
-        // Wait and alternate, see normal Wait above.
-        
-        ThreadSleep(WAIT_INTERNVAL_MS * Alternator);
-        Alternator = (Alternator + 1) & 1; // Alternate between 0 and 1
-    }
+    // Now sleep until LocalWaiter == NumWaitingOn.
+    _WaitForCounters(N, pJobHandles, LocalWaiter, NumWaitingOn, Cond);
     
+    std::lock_guard<std::mutex> _Guard(_aliveJobsLock); // Result may still be written to under the lock
     return Result;
 }
 
@@ -115,6 +115,13 @@ void LuaAdapter_502::CallFunction(U32 Nargs, U32 Nresults)
     lua_pop(_State, 1); // Pop the error message string
 }
 
+void LuaAdapter_502::CallReference(I32 ref, U32 Nargs, U32 Nresults)
+{
+    lua_rawgeti(_State, LUA_REGISTRYINDEX, ref);
+    lua_insert(_State, -((int)Nargs + 1)); // function goes below its arguments
+    CallFunction(Nargs, Nresults);
+}
+
 Bool LuaAdapter_502::CheckStack(U32 extra)
 {
     return lua_checkstack(_State, (int)extra);
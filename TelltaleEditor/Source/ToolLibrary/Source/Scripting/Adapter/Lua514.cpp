@@ -103,6 +103,13 @@ void LuaAdapter_514::CallFunction(U32 Nargs, U32 Nresults)
     lua_pop(_State, 1); // Pop the error message string
 }
 
+void LuaAdapter_514::CallReference(I32 ref, U32 Nargs, U32 Nresults)
+{
+    lua_rawgeti(_State, LUA_REGISTRYINDEX, ref);
+    lua_insert(_State, -((int)Nargs + 1)); // function goes below its arguments
+    CallFunction(Nargs, Nresults);
+}
+
 void LuaAdapter_514::GC()
 {
     lua_gc(_State, LUA_GCCOLLECT, 0);
@@ -86,6 +86,13 @@ void LuaAdapter_523::CallFunction(U32 Nargs, U32 Nresults)
     lua_pop(_State, 1); // Pop the error message string
 }
 
+void LuaAdapter_523::CallReference(I32 ref, U32 Nargs, U32 Nresults)
+{
+    lua_rawgeti(_State, LUA_REGISTRYINDEX, ref);
+    lua_insert(_State, -((int)Nargs + 1)); // function goes below its arguments
+    CallFunction(Nargs, Nresults);
+}
+
 Bool LuaAdapter_523::DoDump(lua_Writer w, void* ud)
 {
     int error = lua_dump(_State, w, ud);
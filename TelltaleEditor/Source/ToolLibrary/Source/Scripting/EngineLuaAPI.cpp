@@ -174,20 +174,16 @@ static U32 luaContainerGetElement(LuaManager& man)
                 man.PushNil();
                 return 1;
             }
-            U32 size = collection.GetSize();
-            for(U32 i = 0; i < size; i++)
+            I32 i = collection.Find(comparee);
+            if(i != -1)
             {
-                ClassInstance key = collection.GetKey(i);
-                if(Meta::PerformEquality(key, comparee))
+                ClassInstance valuePush = collection.GetValue((U32)i);
+                if(!Meta::CoerceMetaToLua(man, valuePush, &collection, (U32)i))
                 {
-                    ClassInstance valuePush = collection.GetValue(i);
-                    if(!Meta::CoerceMetaToLua(man, valuePush, &collection, i))
-                    {
-                        // push MCD instance
-                        collection.PushTransientScriptRef(man, i, false, valuePush.ObtainParentRef());
-                    }
-                    return 1;
+                    // push MCD instance
+                    collection.PushTransientScriptRef(man, (U32)i, false, valuePush.ObtainParentRef());
                 }
+                return 1;
             }
             man.PushNil();
             return 1; // not in container
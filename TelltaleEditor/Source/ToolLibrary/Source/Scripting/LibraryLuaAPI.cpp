@@ -777,6 +777,21 @@ AddIntrinsic(man, script_constant_string, name_string, std::move(c));
             else
                 man.Pop(1);
             
+            ScriptManager::TableGet(man, "NativeSerialiser");
+            if(man.Type(-1) == LuaType::STRING)
+            {
+                String native = ScriptManager::PopString(man);
+                auto it = State.NativeSerialisers.find(native);
+                if(it != State.NativeSerialisers.end())
+                    c.NativeSerialise = it->second;
+                else if(c.SerialiseScriptFn.length())
+                    TTE_LOG("WARNING: %s: native serialiser %s is not registered, using script serialiser", c.Name.c_str(), native.c_str());
+                else
+                    TTE_ASSERT(false, "%s: native serialiser %s is not registered", c.Name.c_str(), native.c_str());
+            }
+            else
+                man.Pop(1);
+            
             ScriptManager::TableGet(man, "Normaliser");
             if(man.Type(-1) == LuaType::STRING)
                 c.NormaliserStringFn = ScriptManager::PopString(man);
@@ -1841,7 +1856,7 @@ namespace MS
         
         Meta::Stream& stream = *((Meta::Stream*)man.ToPointer(-1));
         
-        man.PushBool(stream.DebugOutputFile.get() == nullptr); // if no debug file, we can async do stuff
+        man.PushBool(!stream.IsDebugging()); // if no debug file, we can async do stuff
         
         return 1;
     }
@@ -2078,16 +2093,16 @@ namespace MS
         
         buf.BufferData = Ptr<U8>(Buffer, [](U8* p){TTE_FREE(p);});
         
-        if(stream.DebugOutputFile)
+        if(stream.IsDebugging())
         {
             stream.WriteTabs();
             U32 base64Encoded = MIN(stream.MaxInlinableBuffer, buf.BufferSize);
             String base64 = Base64::Encode(Buffer, base64Encoded);
-            stream.DebugOutput << "[BufferData Base64] >> \"" << base64;
+            *stream.DebugOutput << "[BufferData Base64] >> \"" << base64;
             if(base64Encoded != buf.BufferSize)
-                stream.DebugOutput << "...\"\n";
+                *stream.DebugOutput << "...\"\n";
             else
-                stream.DebugOutput << "\"\n";
+                *stream.DebugOutput << "\"\n";
         }
         
         return 0;
@@ -2118,7 +2133,7 @@ namespace MS
         
         U64 endPos = sect->GetPosition() + actualSize; // cache here as output dbg may change it
         
-        if(stream.DebugOutputFile)
+        if(stream.IsDebugging())
         {
             stream.WriteTabs();
             U32 base64Encoded = MIN(stream.MaxInlinableBuffer, actualSize);
@@ -2128,11 +2143,11 @@ namespace MS
             buf.Stream->SetPosition(0);
             
             String base64 = Base64::Encode(Temp, base64Encoded);
-            stream.DebugOutput << "[CachedBufferData Base64] >> \"" << base64;
+            *stream.DebugOutput << "[CachedBufferData Base64] >> \"" << base64;
             if(base64Encoded != actualSize)
-                stream.DebugOutput << "...\"\n";
+                *stream.DebugOutput << "...\"\n";
             else
-                stream.DebugOutput << "\"\n";
+                *stream.DebugOutput << "\"\n";
             
             TTE_FREE(Temp);
         }
@@ -3135,6 +3150,20 @@ namespace TTE
         return 0;
     }
     
+    static U32 luaSetArchiveIndexCache(LuaManager& man)
+    {
+        Ptr<ResourceRegistry> reg = ResourceRegistry::GetBoundRegistry(man);
+        if(reg)
+        {
+            reg->SetArchiveIndexCache(man.GetTop() >= 1 && man.Type(1) == LuaType::STRING ? man.ToString(1) : "");
+        }
+        else
+        {
+            TTE_LOG("At TTE_SetArchiveIndexCache: no resource registry found");
+        }
+        return 0;
+    }
+    
     static U32 luaMountSystem(LuaManager& man)
     {
         Ptr<ResourceRegistry> reg = ResourceRegistry::GetBoundRegistry(man);
@@ -3257,6 +3286,106 @@ namespace TTE
         return 0;
     }
     
+    // Gets a key or value argument for the given collection, either a meta instance or a coercable lua value. bCopy is set if its a script instance.
+    static Bool _AcquireCollectionArgument(LuaManager& man, I32 index, U32 clazz, Meta::ClassInstance& out, Bool& bCopy, CString func)
+    {
+        out = Meta::AcquireScriptInstance(man, index);
+        bCopy = true;
+        if(!out)
+        {
+            out = Meta::CreateInstance(clazz);
+            if(!Meta::CoerceLuaToMeta(man, index, out))
+            {
+                TTE_LOG("At %s: could not coerce input argument to %s", func, Meta::GetClass(clazz).Name.c_str());
+                return false;
+            }
+            bCopy = false;
+        }
+        else if(out.GetClassID() != clazz)
+        {
+            TTE_LOG("At %s: input argument is a %s, expected a %s", func, Meta::GetClass(out.GetClassID()).Name.c_str(),
+                    Meta::GetClass(clazz).Name.c_str());
+            return false;
+        }
+        return true;
+    }
+    
+    static U32 luaContainerFind(LuaManager& man)
+    {
+        if(man.GetTop() != 2)
+        {
+            TTE_LOG("At TTE_ContainerFind: expected two arguments");
+            man.PushNil();
+            return 1;
+        }
+        Meta::ClassInstance inst = Meta::AcquireScriptInstance(man, 1);
+        Meta::ClassInstance key{};
+        Bool bCopy = false;
+        if(!inst || !Meta::IsCollection(inst) || !Meta::CastToCollection(inst).IsKeyedCollection())
+        {
+            TTE_LOG("At TTE_ContainerFind: container was null or is not a keyed container");
+            man.PushNil();
+            return 1;
+        }
+        Meta::ClassInstanceCollection& col = Meta::CastToCollection(inst);
+        I32 index = _AcquireCollectionArgument(man, 2, col.GetKeyClass(), key, bCopy, "TTE_ContainerFind") ? col.Find(key) : -1;
+        if(index == -1)
+            man.PushNil();
+        else
+            man.PushInteger(index);
+        return 1;
+    }
+    
+    static U32 luaContainerContains(LuaManager& man)
+    {
+        if(man.GetTop() != 2)
+        {
+            TTE_LOG("At TTE_ContainerContains: expected two arguments");
+            man.PushBool(false);
+            return 1;
+        }
+        Meta::ClassInstance inst = Meta::AcquireScriptInstance(man, 1);
+        Meta::ClassInstance key{};
+        Bool bCopy = false;
+        if(!inst || !Meta::IsCollection(inst) || !Meta::CastToCollection(inst).IsKeyedCollection())
+        {
+            TTE_LOG("At TTE_ContainerContains: container was null or is not a keyed container");
+            man.PushBool(false);
+            return 1;
+        }
+        Meta::ClassInstanceCollection& col = Meta::CastToCollection(inst);
+        man.PushBool(_AcquireCollectionArgument(man, 2, col.GetKeyClass(), key, bCopy, "TTE_ContainerContains") && col.Contains(key));
+        return 1;
+    }
+    
+    static U32 luaContainerInsertOrAssign(LuaManager& man)
+    {
+        if(man.GetTop() != 3)
+        {
+            TTE_LOG("At TTE_ContainerInsertOrAssign: expected three arguments");
+            man.PushNil();
+            return 1;
+        }
+        Meta::ClassInstance inst = Meta::AcquireScriptInstance(man, 1);
+        Meta::ClassInstance key{}, value{};
+        Bool bCopyKey = false, bCopyVal = false;
+        if(!inst || !Meta::IsCollection(inst) || !Meta::CastToCollection(inst).IsKeyedCollection())
+        {
+            TTE_LOG("At TTE_ContainerInsertOrAssign: container was null or is not a keyed container");
+            man.PushNil();
+            return 1;
+        }
+        Meta::ClassInstanceCollection& col = Meta::CastToCollection(inst);
+        if(!_AcquireCollectionArgument(man, 2, col.GetKeyClass(), key, bCopyKey, "TTE_ContainerInsertOrAssign") ||
+           !_AcquireCollectionArgument(man, 3, col.GetValueClass(), value, bCopyVal, "TTE_ContainerInsertOrAssign"))
+        {
+            man.PushNil();
+            return 1;
+        }
+        man.PushInteger((I32)col.InsertOrAssign(std::move(key), std::move(value), bCopyKey, bCopyVal));
+        return 1;
+    }
+    
 }
 
 static U32 luaMetaIsIsolated(LuaManager& man)
@@ -3292,6 +3421,11 @@ LuaFunctionCollection luaLibraryAPI(Bool bWorker)
             "<XXX>/. Please note that the archive must be from the current game snapshot! Otherwise it will fail to read due to incorrect encryptino and "
             "expected format."
         });
+        Col.Functions.push_back({"TTE_SetArchiveIndexCache", &TTE::luaSetArchiveIndexCache, "nil TTE_SetArchiveIndexCache(directory)",
+            "This function is only available to mod scripts! "
+            "Sets the directory on your local machine where the file tables of mounted .ttarch2/ttarch archives are cached. Mounting the same unchanged"
+            " archive again then skips reading its header. Pass nil or an empty string to disable the cache. Call this before mounting."
+        });
         Col.Functions.push_back({"TTE_MountSystem", &TTE::luaMountSystem, "nil TTE_MountSystem(locationID, physPath, forceLegacy)",
             "This function is only available to mod scripts! "
             "Mounts the resource system (like creating a concrete directory location) to the given physical path under the name locationID."
@@ -3346,6 +3480,17 @@ LuaFunctionCollection luaLibraryAPI(Bool bWorker)
     Col.Functions.push_back({ "TTE_ContainerToTable", &TTE::luaContainerToTable, "table TTE_ContainerToTable(container, table)",
         "Inserts all key-value mappings from the input table into the container. For non keyed containers (eg arrays) keys are ignored and its added at the back."
     });
+    Col.Functions.push_back({ "TTE_ContainerFind", &TTE::luaContainerFind, "int TTE_ContainerFind(container, key)",
+        "Finds the zero based index of the given key in a keyed container (eg Map or Set), or nil if it is not present. "
+        "The key can be a meta instance of the key type or a lua value which can be coerced to it. Lookups use a hash index of the keys."
+    });
+    Col.Functions.push_back({ "TTE_ContainerContains", &TTE::luaContainerContains, "bool TTE_ContainerContains(container, key)",
+        "Returns true if the given key exists in the keyed container. See TTE_ContainerFind."
+    });
+    Col.Functions.push_back({ "TTE_ContainerInsertOrAssign", &TTE::luaContainerInsertOrAssign, "int TTE_ContainerInsertOrAssign(container, key, value)",
+        "Sets the value of the given key in the keyed container, adding the key if it does not exist yet. Returns the zero based index of the element. "
+        "Meta instance arguments are copied, lua values are coerced to the key and value types."
+    });
     
     // part of the TTE but can be called async
     Col.Functions.push_back({"TTE_DumpMemoryLeaks", &TTE::luaDumpMemLeaks, "nil TTE_DumpMemoryLeaks()",
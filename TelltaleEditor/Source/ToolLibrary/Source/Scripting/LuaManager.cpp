@@ -1,6 +1,7 @@
 #include <Scripting/ScriptManager.hpp>
 #include <Core/Context.hpp>
 #include <Resource/DataStream.hpp>
+#include <Meta/Meta.hpp>
 
 LuaManager::~LuaManager()
 {
@@ -52,6 +53,8 @@ U32 luaRequireOverride(LuaManager& man)
         
         if(script.length() == 0)
             TTE_LOG("When loading script '%s': file empty or could not be read", value.c_str());
+        else if(&man == &GetToolContext()->GetLibraryLVM())
+            Meta::_Impl::_AccumulateScriptSource(script); // class databases depend on these
         
         if(man.RunText(script.c_str(), (U32)script.length(), false, value.c_str())){
             man.PushNil(); // value of it doesn't matter, only that it exists
@@ -112,6 +115,32 @@ void LuaManager::GetReg(I32 ref)
     _Adapter->GetReg(ref);
 }
 
+I32 LuaManager::GetCachedReference(U32 key, U32 generation)
+{
+    if(generation != _CachedRefsGeneration)
+    {
+        for(auto& ref: _CachedRefs)
+            UnrefReg(ref.second);
+        _CachedRefs.clear();
+        _CachedRefsGeneration = generation;
+        return -1;
+    }
+    auto it = _CachedRefs.find(key);
+    return it == _CachedRefs.end() ? -1 : it->second;
+}
+
+void LuaManager::SetCachedReference(U32 key, I32 ref)
+{
+    auto it = _CachedRefs.find(key);
+    if(it == _CachedRefs.end())
+        _CachedRefs[key] = ref;
+    else if(it->second != ref)
+    {
+        UnrefReg(it->second); // replacing
+        it->second = ref;
+    }
+}
+
 void LuaManager::RegisterConstantMetaTable(LuaConstantMetaTable mt)
 {
     I32 ref = RefReg();
@@ -179,6 +208,19 @@ void LuaManager::CallFunction(U32 Nargs, U32 Nresults, Bool bBlock)
     }
 }
 
+void LuaManager::CallReference(I32 ref, U32 Nargs, U32 Nresults, Bool bBlock)
+{
+    if(bBlock && !JobScheduler::IsRunningFromWorker())
+    {
+        GetToolContext()->_LockedCallDepth++;
+    }
+    _Adapter->CallReference(ref, Nargs, Nresults);
+    if(bBlock && !JobScheduler::IsRunningFromWorker())
+    {
+        GetToolContext()->_LockedCallDepth--;
+    }
+}
+
 Bool LuaManager::CheckStack(U32 extra)
 {
     return _Adapter->CheckStack(extra);
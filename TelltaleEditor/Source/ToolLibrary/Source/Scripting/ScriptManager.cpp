@@ -139,9 +139,9 @@ namespace ScriptManager {
         
         // set global
         if(collection.Name.length() > 0)
-            SetGlobal(man, collection.Name, true);
-        
-        man.Pop(1); // pop globals/new table
+            SetGlobal(man, collection.Name, true); // pops new table
+        else
+            man.Pop(1); // pop globals
         
         for(auto fn: collection.GenerateMetaTables)
             fn(man);